@@ -0,0 +1,146 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkApp.cpp
+//  Stonefish
+//
+
+#include "BenchmarkApp.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sys/resource.h>
+#include <core/SimulationManager.h>
+#include <utils/SystemUtil.hpp>
+#include <utils/Profiler.h>
+
+BenchmarkApp::BenchmarkApp(std::string dataDirPath, BenchmarkManager* sim, sf::Scalar duration, const std::string& tracePath) 
+    : ConsoleSimulationApp("Stonefish Benchmark", dataDirPath, sim), duration(duration), trace(tracePath), steps(0), wallStart(0), wallEnd(0), collectTime(0), lostZones(0)
+{
+}
+
+void BenchmarkApp::LoopInternal()
+{
+    if(getState() != sf::SimulationState::RUNNING 
+       || !static_cast<BenchmarkManager*>(getSimulationManager())->isScenarioValid())
+    {
+        Quit();
+        return;
+    }
+
+    if(steps == 0)
+    {
+        getSimulationManager()->setCallSimulationStepCompleted(false);
+        sf::Profiler::Clear();
+        sf::Profiler::setEnabled(true);
+        wallStart = sf::GetTimeInMicroseconds();
+    }
+
+    uint64_t start = sf::GetTimeInMicroseconds();
+    StepSimulation();
+    double elapsed = (double)(sf::GetTimeInMicroseconds() - start);
+    batchTimes.push_back(elapsed);
+    stepTimes.push_back(elapsed/getStepBatch()); //Mean step time within the batch
+    ++steps;
+
+    if(getSimulationManager()->getSimulationTime() >= duration)
+    {
+        wallEnd = sf::GetTimeInMicroseconds();
+        if(!trace.empty()) //Zones recorded since the last collection
+            sf::Profiler::ExportChromeTrace(trace);
+        CollectZones();
+        sf::Profiler::setEnabled(false);
+        StopSimulation();
+        Quit();
+        if(lostZones > 0)
+            fprintf(stderr, "Warning: %llu profiler zones were lost (buffer overflow)!\n", (unsigned long long)lostZones);
+    }
+    else //Drain profiler buffers after every batch, so that they do not wrap around
+    {
+        uint64_t collectStart = sf::GetTimeInMicroseconds();
+        CollectZones();
+        collectTime += sf::GetTimeInMicroseconds() - collectStart;
+    }
+}
+
+void BenchmarkApp::CollectZones()
+{
+    uint64_t lost = 0;
+    std::vector<sf::ProfilerEvent> events = sf::Profiler::getEvents(&lost);
+    sf::Profiler::Clear();
+    lostZones += lost;
+    for(size_t i=0; i<events.size(); ++i)
+        zoneTimes[events[i].name].push_back(events[i].duration/1000.0);
+}
+
+static double Percentile(std::vector<double>& data, double p)
+{
+    if(data.empty())
+        return 0.0;
+    size_t k = std::min((size_t)(p * (data.size()-1) + 0.5), data.size()-1);
+    std::nth_element(data.begin(), data.begin() + k, data.end());
+    return data[k];
+}
+
+static void WriteStatistics(FILE* out, std::vector<double>& data)
+{
+    double total = std::accumulate(data.begin(), data.end(), 0.0);
+    fprintf(out, "{\"count\": %zu, \"total_us\": %.3f, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f}",
+            data.size(), total, data.empty() ? 0.0 : total/data.size(),
+            Percentile(data, 0.5), Percentile(data, 0.9), Percentile(data, 0.99), Percentile(data, 1.0));
+}
+
+void BenchmarkApp::WriteReport(FILE* out, const std::string& scenario)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    long peakRSS = usage.ru_maxrss/1024; //Bytes
+#else
+    long peakRSS = usage.ru_maxrss; //Kilobytes
+#endif
+    double wallTime = (wallEnd - wallStart - collectTime)/1e6; //Without collection of profiler zones
+    double simTime = getSimulationManager()->getSimulationTime();
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"scenario\": \"%s\",\n", scenario.c_str());
+    fprintf(out, "  \"version\": \"%d.%d.%d\",\n", STONEFISH_VER_MAJOR, STONEFISH_VER_MINOR, STONEFISH_VER_PATCH);
+    fprintf(out, "  \"time_step\": %.9f,\n", (double)timeStep_);
+    fprintf(out, "  \"step_batch\": %u,\n", getStepBatch());
+    fprintf(out, "  \"simulated_time\": %.6f,\n", simTime);
+    fprintf(out, "  \"wall_time\": %.6f,\n", wallTime);
+    fprintf(out, "  \"steps\": %llu,\n", (unsigned long long)(steps * getStepBatch()));
+    fprintf(out, "  \"steps_per_second\": %.3f,\n", wallTime > 0.0 ? steps * getStepBatch() / wallTime : 0.0);
+    fprintf(out, "  \"realtime_factor\": %.3f,\n", wallTime > 0.0 ? simTime / wallTime : 0.0);
+    fprintf(out, "  \"peak_rss_kb\": %ld,\n", peakRSS);
+    fprintf(out, "  \"lost_zones\": %llu,\n", (unsigned long long)lostZones);
+    fprintf(out, "  \"step\": ");
+    WriteStatistics(out, stepTimes);
+    if(getStepBatch() > 1)
+    {
+        fprintf(out, ",\n  \"batch\": ");
+        WriteStatistics(out, batchTimes);
+    }
+    fprintf(out, ",\n  \"stages\": {");
+    for(auto it = zoneTimes.begin(); it != zoneTimes.end(); ++it)
+    {
+        fprintf(out, "%s\n    \"%s\": ", it == zoneTimes.begin() ? "" : ",", it->first.c_str());
+        WriteStatistics(out, it->second);
+    }
+    fprintf(out, "\n  }\n}\n");
+}
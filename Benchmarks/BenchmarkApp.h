@@ -0,0 +1,57 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkApp.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__BenchmarkApp__
+#define __Stonefish__BenchmarkApp__
+
+#include <core/ConsoleSimulationApp.h>
+#include <map>
+#include "BenchmarkManager.h"
+
+//! A console application stepping the simulation as fast as possible and collecting timing statistics.
+class BenchmarkApp : public sf::ConsoleSimulationApp
+{
+public:
+    BenchmarkApp(std::string dataDirPath, BenchmarkManager* sim, sf::Scalar duration, const std::string& tracePath = "");
+
+    //! Writes the results in the JSON format.
+    void WriteReport(FILE* out, const std::string& scenario);
+
+protected:
+    void LoopInternal();
+
+private:
+    void CollectZones();
+
+    sf::Scalar duration;
+    std::string trace;
+    uint64_t steps;
+    uint64_t wallStart;
+    uint64_t wallEnd;
+    uint64_t collectTime;
+    uint64_t lostZones;
+    std::vector<double> stepTimes; //Per step (averaged within each batch)
+    std::vector<double> batchTimes;
+    std::map<std::string, std::vector<double>> zoneTimes;
+};
+
+#endif
@@ -0,0 +1,51 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkManager.cpp
+//  Stonefish
+//
+
+#include "BenchmarkManager.h"
+
+#include <core/ScenarioParser.h>
+#include <core/Console.h>
+#include <core/SimulationApp.h>
+
+BenchmarkManager::BenchmarkManager(sf::Scalar stepsPerSecond, const std::string& scenarioPath) 
+    : SimulationManager(stepsPerSecond, sf::Solver::SI, sf::CollisionFilter::EXCLUSIVE), scenario(scenarioPath), valid(false)
+{
+}
+
+void BenchmarkManager::BuildScenario()
+{
+    sf::ScenarioParser parser(this);
+    valid = parser.Parse(scenario);
+    if(valid)
+        return;
+    
+    cError("Errors detected when parsing scenario description!");
+    auto log = parser.getLog();
+    for(size_t i=0; i<log.size(); ++i)
+        if(log[i].type != sf::MessageType::INFO)
+            cError(log[i].text.c_str());
+}
+
+bool BenchmarkManager::isScenarioValid() const
+{
+    return valid;
+}
@@ -0,0 +1,41 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  BenchmarkManager.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__BenchmarkManager__
+#define __Stonefish__BenchmarkManager__
+
+#include <core/SimulationManager.h>
+
+class BenchmarkManager : public sf::SimulationManager
+{
+public:
+    BenchmarkManager(sf::Scalar stepsPerSecond, const std::string& scenarioPath);
+    
+    void BuildScenario();
+    bool isScenarioValid() const;
+
+private:
+    std::string scenario;
+    bool valid;
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  main.cpp
+//  Stonefish
+//
+
+#include "BenchmarkApp.h"
+#include "BenchmarkManager.h"
+#include <cstring>
+#include <cstdlib>
+
+static void PrintUsage(const char* name)
+{
+    printf("Usage: %s <scenario.scn> [-t seconds] [-r rate] [-b batch] [-o report.json] [-p trace.json]\n", name);
+    printf("  -t  simulated time [s] (default 10)\n");
+    printf("  -r  simulation rate [Hz] (default 500)\n");
+    printf("  -b  number of steps performed in one batch (default 1)\n");
+    printf("  -o  output file for the report (default stdout)\n");
+    printf("  -p  output file for the Chrome trace of the last batch of steps\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    if(argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string scenario(argv[1]);
+    double duration = 10.0;
+    double rate = 500.0;
+    unsigned int batch = 1;
+    std::string reportPath;
+    std::string tracePath;
+
+    for(int i=2; i<argc-1; i+=2)
+    {
+        if(strcmp(argv[i], "-t") == 0)
+            duration = atof(argv[i+1]);
+        else if(strcmp(argv[i], "-r") == 0)
+            rate = atof(argv[i+1]);
+        else if(strcmp(argv[i], "-b") == 0)
+            batch = (unsigned int)atoi(argv[i+1]);
+        else if(strcmp(argv[i], "-o") == 0)
+            reportPath = std::string(argv[i+1]);
+        else if(strcmp(argv[i], "-p") == 0)
+            tracePath = std::string(argv[i+1]);
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(scenario[0] != '/')
+        scenario = std::string(DATA_DIR_PATH) + scenario;
+
+    BenchmarkManager* simulationManager = new BenchmarkManager(rate, scenario);
+    BenchmarkApp app(std::string(DATA_DIR_PATH), simulationManager, duration, tracePath);
+    app.setStepBatch(batch);
+    app.Run(true, false, 1.0/rate);
+
+    if(!simulationManager->isScenarioValid())
+        return 1;
+
+    FILE* out = reportPath.empty() ? stdout : fopen(reportPath.c_str(), "w");
+    if(out == nullptr)
+    {
+        fprintf(stderr, "Could not open file '%s'!\n", reportPath.c_str());
+        return 1;
+    }
+    app.WriteReport(out, scenario);
+    if(out != stdout)
+        fclose(out);
+
+    return 0;
+}
@@ -95,6 +95,9 @@ namespace sf
          */
         void setMaxTorque(Scalar tau);
 
+        //! A method returning the control mode.
+        ServoControlMode getControlMode() const;
+        
         //! A method returning the desired position setpoint.
         Scalar getDesiredPosition() const;
         
@@ -27,19 +27,35 @@
 #define __Stonefish_FilteredCollisionDispatcher__
 
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#if BT_THREADSAFE
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#endif
 
 namespace sf
 {
+    class SimulationManager;
+
+#if BT_THREADSAFE
+    typedef btCollisionDispatcherMt CollisionDispatcherBase;
+#else
+    typedef btCollisionDispatcher CollisionDispatcherBase;
+#endif
+
     //! A class implementing a custom collision dispatcher object.
-    class FilteredCollisionDispatcher : public btCollisionDispatcher
+    /*!
+     When the library is built with Bullet multithreading enabled, the dispatcher processes
+     the narrowphase collision pairs in parallel, using the task scheduler set up by the simulation manager.
+     */
+    class FilteredCollisionDispatcher : public CollisionDispatcherBase
     {
     public:
         //! A constructor.
         /*!
          \param collisionConfiguration a pointer to the collision configuration structure
+         \param sm a pointer to the simulation manager owning the collision world
          \param inclusiveMode a flag that selects the mode of collision detection
          */
-        FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, bool inclusiveMode);
+        FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, SimulationManager* sm, bool inclusiveMode);
         
         //! A method that informs if two collision objects can collide.
         /*!
@@ -57,7 +73,18 @@ namespace sf
          */
         static void myNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
         
+        //! A method returning the simulation manager whose dispatcher is processing a collision pair in the calling thread.
+        /*!
+         Used by the contact added callback, which is called from the dispatcher threads and has no access to the world.
+         \return a pointer to the simulation manager (nullptr if no pair was dispatched in the calling thread)
+         */
+        static SimulationManager* getDispatchingManager();
+        
     private:
+        static void ManagerNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
+        
+
+        SimulationManager* simManager;
         bool inclusive;
     };
 }
@@ -26,7 +26,6 @@
 #ifndef __Stonefish_MaterialManager__
 #define __Stonefish_MaterialManager__
 
-#include <unordered_map>
 #include "core/NameManager.h"
 
 namespace sf
@@ -38,6 +37,7 @@ namespace sf
         Scalar density;
         Scalar restitution;
         Scalar magnetic; // <0 ferromagnetic, 0 nonmagnetic, >0 magnet
+        int id; // index in the material manager
     };
     
     //! A structure holding fluid properties.
@@ -64,28 +64,12 @@ namespace sf
         Scalar fDynamic;
     };
     
-    //! A structure representing a pair of materials.
-    struct MaterialPair
+    //! A structure holding precomputed properties of a contact between two materials.
+    struct ContactProperties
     {
-        int mat1Id;
-        int mat2Id;
-        
-        bool operator==(const MaterialPair& rhs) const
-        {
-            return (mat1Id == rhs.mat1Id && mat2Id == rhs.mat2Id)||(mat1Id == rhs.mat2Id && mat2Id == rhs.mat1Id);
-        }
-    };
-    
-    //! A hashing function for material interaction.
-    struct MaterialPairHash
-    {
-        std::size_t operator()(const MaterialPair& mp) const
-        {
-            if(mp.mat1Id <= mp.mat2Id)
-                return std::hash<int>()(mp.mat1Id) ^ (std::hash<int>()(mp.mat2Id) << 16);
-            else
-                return std::hash<int>()(mp.mat2Id) ^ (std::hash<int>()(mp.mat1Id) << 16);
-        }
+        Friction friction;
+        Scalar restitution; // combined restitution factor
+        Scalar magnetic; // attraction factor (>0 only between a magnet and a ferromagnetic material)
     };
     
     class NameManager;
@@ -136,6 +120,15 @@ namespace sf
          */
         Friction GetMaterialsInteraction(const std::string& mat1Name, const std::string& mat2Name);
         
+        //! A method returning the precomputed contact properties for a specified pair of materials.
+        /*!
+         Used in the contact callback; the lookup is a single access to a dense table.
+         \param mat1Index an id of the first material
+         \param mat2Index an id of the second material
+         \return a reference to a structure containing the contact properties
+         */
+        const ContactProperties& getContactProperties(int mat1Index, int mat2Index) const;
+        
         //! A method returning a list of materials (names).
         std::vector<std::string> GetMaterialsList();
         
@@ -182,9 +175,10 @@ namespace sf
         
     private:
         int getMaterialIndex(const std::string& name);
+        void UpdateContactProperties(int mat1Index, int mat2Index, Friction f);
         
         std::vector<Material> materials;
-        std::unordered_map<MaterialPair, Friction, MaterialPairHash> interactions;
+        std::vector<ContactProperties> contactTable; // N x N, symmetric
         std::vector<Fluid> fluids;
         
         NameManager materialNameManager;
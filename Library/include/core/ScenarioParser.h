@@ -112,6 +112,14 @@ namespace sf
          */
         virtual bool IncludeFiles(XMLNode* node);
 
+        //! A method that loads the resources referenced in the scenario in parallel, before the objects are created.
+        /*!
+         Meshes (with their physical properties), textures and heightmaps are decoded on multiple threads and stored
+         in the caches, from which they are taken when the objects are created in order.
+         \param node a pointer to the root node
+         */
+        virtual void PrefetchResources(XMLNode* node);
+
         //! A method used to parse solver configuration.
         /*!
          \param element a pointer to the XML node
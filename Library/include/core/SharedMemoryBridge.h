@@ -0,0 +1,219 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SharedMemoryBridge.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <atomic>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    //! Layout of the shared memory segments (version 1).
+    /*!
+     The main segment "/<name>" contains a header followed by the sensor and actuator directories. The data of each
+     sensor lives in a separate segment "/<name>.<index>", recreated when the size of the data grows (which is signalled
+     by incrementing the generation of the sensor). A data segment contains two slots, written alternately.
+     Each slot is protected by a sequence lock, so that readers never block the simulation.
+     */
+    const uint32_t SHM_MAGIC = 0x53464D53; //"SMFS"
+    const uint32_t SHM_VERSION = 1;
+    const size_t SHM_NAME_LENGTH = 64;
+    const size_t SHM_MAX_SETPOINTS = 4;
+    
+    //! A structure representing the header of the main segment.
+    struct ShmHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nSensors;
+        uint32_t nActuators;
+        std::atomic<uint64_t> step; //!< Number of simulation steps published.
+        std::atomic<double> time;   //!< Simulation time of the last step [s].
+    };
+    
+    //! A structure describing a sensor in the directory of the main segment.
+    struct ShmSensorInfo
+    {
+        char name[SHM_NAME_LENGTH];
+        uint32_t type;     //!< Value of SensorType.
+        uint32_t subtype;  //!< Value of ScalarSensorType or VisionSensorType.
+        uint32_t channels; //!< Number of channels (scalar sensors).
+        uint32_t width;    //!< Horizontal resolution (vision sensors).
+        uint32_t height;   //!< Vertical resolution (vision sensors).
+        std::atomic<uint32_t> generation; //!< Incremented each time the data segment is created (0 -> no data yet).
+    };
+    
+    //! A structure describing an actuator in the directory of the main segment, including the setpoint mailbox.
+    struct ShmActuatorInfo
+    {
+        char name[SHM_NAME_LENGTH];
+        uint32_t type;    //!< Value of ActuatorType.
+        uint32_t nValues; //!< Number of setpoint values accepted by the actuator.
+        std::atomic<uint32_t> lock;   //!< Sequence lock of the setpoint (odd while writing).
+        std::atomic<uint64_t> count;  //!< Number of setpoints written by the clients.
+        double values[SHM_MAX_SETPOINTS];
+    };
+    
+    //! A structure representing the header of a sensor data segment.
+    struct ShmDataHeader
+    {
+        std::atomic<uint32_t> latest; //!< Index of the slot containing the latest measurement.
+        uint32_t reserved;
+        uint64_t capacity;            //!< Maximum size of the data in a slot [bytes].
+    };
+    
+    //! A structure representing the header of a slot in a sensor data segment (followed by the data).
+    struct ShmSlotHeader
+    {
+        std::atomic<uint32_t> lock; //!< Sequence lock of the slot (odd while writing).
+        uint32_t reserved;
+        uint64_t sequence;          //!< Number of the measurement.
+        double timestamp;           //!< Simulation time of the measurement [s].
+        uint64_t size;              //!< Size of the data [bytes].
+    };
+    
+    class SimulationManager;
+    
+    //! A class publishing sensor data and receiving actuator setpoints through POSIX shared memory.
+    /*!
+     The bridge allows controllers running in separate processes on the same host to communicate with the simulator
+     without sockets or serialisation. Data of all sensors is copied to shared memory after each simulation step,
+     if a new measurement is available, and setpoints written by the clients are applied before each step.
+     */
+    class SharedMemoryBridge
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param name a name of the shared memory segment (without the leading slash)
+         \param sm a pointer to the simulation manager
+         */
+        SharedMemoryBridge(const std::string& name, SimulationManager* sm);
+        
+        //! A destructor.
+        ~SharedMemoryBridge();
+        
+        //! A method applying the setpoints received from the clients.
+        void ApplySetpoints();
+        
+        //! A method publishing new sensor measurements.
+        /*!
+         \param time the simulation time [s]
+         */
+        void Publish(Scalar time);
+        
+        //! A method informing if the shared memory was created successfully.
+        bool isOpen() const;
+        
+        //! A method returning the name of the shared memory segment.
+        std::string getName() const;
+        
+    private:
+        struct SensorSegment
+        {
+            void* mem;
+            size_t memSize;
+            uint64_t capacity;
+            uint64_t lastSequence;
+            bool published;
+        };
+        
+        bool CreateDataSegment(size_t index, size_t size);
+        
+        std::string name;
+        SimulationManager* sm;
+        void* mem;
+        size_t memSize;
+        std::vector<SensorSegment> segments;
+        std::vector<uint64_t> appliedSetpoints;
+    };
+    
+    //! A class used by external processes to access the data published by the shared memory bridge.
+    class SharedMemoryClient
+    {
+    public:
+        //! A constructor.
+        SharedMemoryClient();
+        
+        //! A destructor.
+        ~SharedMemoryClient();
+        
+        //! A method connecting to the shared memory of a simulator.
+        /*!
+         \param name a name of the shared memory segment (without the leading slash)
+         \return true if the connection succeeded
+         */
+        bool Open(const std::string& name);
+        
+        //! A method disconnecting from the shared memory.
+        void Close();
+        
+        //! A method reading the latest measurement of a sensor.
+        /*!
+         \param index the index of the sensor
+         \param data a buffer to store the data (resized when needed)
+         \param sequence output of the number of the measurement
+         \param timestamp output of the simulation time of the measurement [s]
+         \return true if a measurement was read
+         */
+        bool ReadSensor(size_t index, std::vector<uint8_t>& data, uint64_t& sequence, double& timestamp);
+        
+        //! A method writing a setpoint of an actuator.
+        /*!
+         \param index the index of the actuator
+         \param values a pointer to the setpoint values
+         \param n the number of values
+         \return true if the setpoint was written
+         */
+        bool WriteSetpoint(size_t index, const double* values, size_t n);
+        
+        //! A method returning the header of the main segment.
+        const ShmHeader* getHeader() const;
+        
+        //! A method returning the description of a sensor.
+        /*!
+         \param index the index of the sensor
+         \return a pointer to the description or nullptr if the index is out of range
+         */
+        const ShmSensorInfo* getSensorInfo(size_t index) const;
+        
+        //! A method returning the description of an actuator.
+        /*!
+         \param index the index of the actuator
+         \return a pointer to the description or nullptr if the index is out of range
+         */
+        const ShmActuatorInfo* getActuatorInfo(size_t index) const;
+        
+    private:
+        struct SensorMapping
+        {
+            void* mem;
+            size_t memSize;
+            uint32_t generation;
+        };
+        
+        std::string name;
+        void* mem;
+        size_t memSize;
+        std::vector<SensorMapping> mappings;
+    };
+}
@@ -81,6 +81,17 @@ namespace sf
 
         //! A method that performs a single simulation step and necessary updates.
         virtual void StepSimulation();
+
+        //! A method that sets the number of fixed steps performed in one call to StepSimulation.
+        /*!
+         Only used in the fixed step mode. Steps are performed back to back and the step completion
+         callback is fired once per batch, which maximises throughput of headless runs.
+         \param n number of steps in a batch (1 means no batching)
+         */
+        void setStepBatch(unsigned int n);
+
+        //! A method returning the number of fixed steps performed in one call to StepSimulation.
+        unsigned int getStepBatch() const;
         
         //! A method returning simulation state.
         SimulationState getState() const;
@@ -102,8 +113,18 @@ namespace sf
 
         //! A method informing if the application is graphical.
         virtual bool hasGraphics() = 0;
+
+        //! A method binding the application to the calling thread.
+        /*!
+         After this call getApp() returns this application in the calling thread, which allows
+         running multiple independent (console) simulations in one process, each in its own thread.
+         */
+        void MakeCurrent();
         
         //! A static method returning the pointer to the currently running application.
+        /*!
+         \return the application bound to the calling thread or the last created application
+         */
         static SimulationApp* getApp();
         
     protected:
@@ -120,6 +141,7 @@ namespace sf
         uint64_t startTime_;
         bool autostep_;
         Scalar timeStep_;
+        unsigned int stepBatch_;
         SimulationState state_;
 
     private:
@@ -129,6 +151,7 @@ namespace sf
         double physicsTime_;
         
         static SimulationApp* handle;
+        static thread_local SimulationApp* current;
     };
 }
 
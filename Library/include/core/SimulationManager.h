@@ -31,7 +31,9 @@
 #include "entities/forcefields/Atmosphere.h"
 #include "entities/SolidEntity.h"
 #include "utils/PerformanceMonitor.h"
+#include "utils/RayQueryBatch.h"
 #include "BulletSoftBody/btSoftMultiBodyDynamicsWorld.h"
+#include <unordered_set>
 
 namespace sf
 {
@@ -49,6 +51,7 @@ namespace sf
     class Sensor;
     class Comm;
     class Contact;
+    class SharedMemoryBridge;
     class OpenGLTrackball;
     class OpenGLDebugDrawer;
     
@@ -63,6 +66,22 @@ namespace sf
     {
         Entity* A;
         Entity* B;
+
+        //! A constructor creating an ordered pair, so that the order of entities does not matter.
+        Collision(const Entity* entA, const Entity* entB) 
+            : A(const_cast<Entity*>(entA < entB ? entA : entB)), B(const_cast<Entity*>(entA < entB ? entB : entA)) {}
+
+        bool operator==(const Collision& c) const { return A == c.A && B == c.B; }
+    };
+
+    //! A structure implementing a hash function for collision pairs.
+    struct CollisionHash
+    {
+        size_t operator()(const Collision& c) const
+        {
+            size_t h = std::hash<Entity*>()(c.A);
+            return h ^ (std::hash<Entity*>()(c.B) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
     };
     
     //! An abstract class managing the simulation world, the solver settings and implementing custom physics callbacks.
@@ -124,6 +143,18 @@ namespace sf
 
         //! A method that performs on simulation step of specified period.
         void StepSimulation(Scalar timeStep);
+
+        //! A method that performs a batch of fixed simulation steps back to back.
+        /*!
+         The settings mutex is taken once for the whole batch and the SimulationStepCompleted method
+         is called only once, from the post-tick callback of the last internal step, with the total time simulated.
+         The physics is integrated with the fixed step of the manager, the same as in StepSimulation, and the time
+         that does not fill a whole internal step is carried over to the next call (a batch shorter than the remaining
+         part of an internal step does not perform a step and is not reported).
+         \param n number of steps to perform
+         \param timeStep period of a single step [s]
+         */
+        void StepSimulationN(unsigned int n, Scalar timeStep);
         
         //! A method updating the drawing queue (thread safe)
         void UpdateDrawingQueue();
@@ -234,7 +265,7 @@ namespace sf
         /*!
          \param entA a pointer to the first entity
          \param entB a pointer to the second entity
-         \return
+         \return 0 if the pair is on the collision filter list, -1 otherwise
          */
         int CheckCollision(const Entity* entA, const Entity* entB);
         
@@ -248,6 +279,18 @@ namespace sf
         //! A method used to enable atmosphere simulation.
         void EnableAtmosphere();
         
+        //! A method used to enable the shared memory bridge.
+        /*!
+         The bridge publishes the data of all sensors and receives the actuator setpoints through POSIX shared memory,
+         allowing controllers running in separate processes to communicate with the simulator.
+         It has to be enabled after all sensors and actuators were created (e.g. at the end of BuildScenario).
+         \param name a name of the shared memory segment
+         */
+        void EnableSharedMemoryBridge(const std::string& name);
+        
+        //! A method used to disable the shared memory bridge.
+        void DisableSharedMemoryBridge();
+        
         //! A method used to pick an entity by shooting a camera ray.
         /*!
          \param eye the position of the camera eye in the world frame
@@ -454,6 +497,9 @@ namespace sf
         //! A method returning a pointer to the atmosphere object.
         Atmosphere* getAtmosphere();
         
+        //! A method returning a pointer to the shared memory bridge (nullptr if disabled).
+        SharedMemoryBridge* getSharedMemoryBridge();
+        
         //! A method setting the gravity constant used in the simulation.
         void setGravity(Scalar gravityConstant);
         
@@ -557,6 +603,7 @@ namespace sf
         void RenderBulletDebug();
         void InitializeSolver();
         void InitializeScenario();
+        void CheckMLCPFallbacks();
         
         // State
         Scalar simulationTime; // Time of simulation run in seconds
@@ -565,6 +612,8 @@ namespace sf
         uint64_t ssus;         // Simulation step time in us
         bool simulationFresh;
         bool callSimulationStepCompleted;
+        unsigned int batchSteps;     // Internal steps of the current batch
+        unsigned int batchStepsLeft; // Internal steps of the current batch not performed yet
 
         // Performance
         PerformanceMonitor perfMon;
@@ -572,6 +621,7 @@ namespace sf
         Scalar cpuUsage;
         unsigned int fdPrescaler;
         unsigned int fdCounter;
+        bool fdAdaptive; //At least one body updates hydrodynamics adaptively
         
         // Threading
         SDL_mutex* simSettingsMutex;
@@ -606,10 +656,14 @@ namespace sf
         std::vector<Actuator*> actuators;
         std::vector<Comm*> comms;
         std::vector<Contact*> contacts;
-        std::vector<Collision> collisions;
+        std::unordered_set<Collision, CollisionHash> collisions;
         NED* ned;
         Ocean* ocean;
         Atmosphere* atmosphere;
+        SharedMemoryBridge* shmBridge;
+        std::string shmName;
+        RayQueryBatch rayQueries;
+        std::vector<Sensor*> dueSensors;
         Scalar g;
         DisplayMode sdm;
         
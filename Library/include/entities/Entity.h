@@ -71,10 +71,11 @@ namespace sf
         bool useCustomCB;
         Scalar customVolume;
         Vector3 customCB;
+        bool adaptiveHydrodynamics;
 
         PhysicsSettings() : mode(PhysicsMode::SUBMERGED), collisions(true), buoyancy(true), estimateHydrodynamics(true),
             useCustomAddedMass(false), useCustomAddedInertia(false), customAddedMass(Vector3(0,0,0)), customAddedInertia(Vector3(0,0,0)),
-            useCustomVolume(false), useCustomCB(false), customVolume(0), customCB(Vector3(0,0,0))
+            useCustomVolume(false), useCustomCB(false), customVolume(0), customCB(Vector3(0,0,0)), adaptiveHydrodynamics(false)
         {
         }
     };
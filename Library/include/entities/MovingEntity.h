@@ -108,7 +108,7 @@ namespace sf
         virtual void getAABB(Vector3& min, Vector3& max) = 0;
         
         //! A method returning the material of the body.
-        Material getMaterial() const;
+        const Material& getMaterial() const;
         
         //! A method used to change the rendering style of the object.
         /*!
@@ -41,6 +41,7 @@ namespace sf
     enum class BodyFluidPosition {INSIDE, OUTSIDE, CROSSING_SURFACE};
     
     struct HydrodynamicsSettings;
+    struct MeshSoA;
     class Ocean;
     class Atmosphere;
     
@@ -96,8 +97,48 @@ namespace sf
         /*!
          \param settings a structure holding settings of fluid dynamics computation
          \param ocn a pointer to the ocean entity
+         \param bf the position of the body with respect to the fluid
          */
-        virtual void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn);
+        virtual void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, BodyFluidPosition bf);
+        
+        //! A method that decides if the hydrodynamic forces have to be recomputed in the current step.
+        /*!
+         With the adaptive update enabled, bodies crossing the surface are updated in every step, while bodies
+         staying in or out of the fluid are only updated when their position, orientation or velocity
+         relative to the fluid changed significantly.
+         Otherwise, the update follows the fluid dynamics prescaler of the simulation manager.
+         \param ocn a pointer to the ocean entity
+         \param bf the position of the body with respect to the fluid
+         \param scheduled a flag indicating if the update is scheduled by the prescaler
+         \return true if the forces should be recomputed
+         */
+        bool CheckHydrodynamicsUpdate(Ocean* ocn, BodyFluidPosition bf, bool scheduled);
+        
+        //! A method that checks the position of the body with respect to the fluid surface.
+        /*!
+         \param ocn a pointer to the ocean entity
+         \return the position of the body with respect to the fluid
+         */
+        BodyFluidPosition CheckBodyFluidPosition(Ocean* ocn);
+        
+        //! A method setting the thresholds triggering the adaptive update of the hydrodynamic forces.
+        /*!
+         \param position the change of position [m]
+         \param rotation the change of orientation [rad]
+         \param velocity the change of linear velocity relative to the fluid (including currents) [m/s]
+         \param angular the change of angular velocity [rad/s]
+         \param relative the change of velocity relative to the velocity at the last update
+         */
+        void setAdaptiveHydrodynamicsTolerances(Scalar position, Scalar rotation, Scalar velocity, Scalar angular, Scalar relative);
+        
+        //! A method setting the number of scheduled updates that can be skipped by the adaptive update.
+        /*!
+         \param n the maximum number of skipped updates
+         */
+        void setAdaptiveHydrodynamicsMaxSkipped(unsigned int n);
+        
+        //! A method returning if the hydrodynamic forces are updated adaptively.
+        bool isHydrodynamicsAdaptive() const;
         
         //! A method that corrects damping forces based on geometry approximation
         /*!
@@ -116,7 +157,7 @@ namespace sf
         //! A static method that computes fluid dynamics when a body is crossing the fluid surface.
         /*!
          \param settings a reference to a structure holding settings of the fluid dynamics computation
-         \param mesh a pointer to the body physics mesh data
+         \param mesh a pointer to the flat copy of the body physics mesh
          \param liquid a pointer to the fluid entity generating forces (currently only Ocean supported)
          \param T_CG a transform from the world frame to the body CG frame
          \param T_C a transform from the world frame to the physics frame
@@ -132,13 +173,13 @@ namespace sf
          \param _Vsub output of the submerged volume
          \param debug output of the debug rendering
         */
-        static void ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
+        static void ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const MeshSoA* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
                                                      const Vector3& linearV, const Vector3& angularV, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fdf, Vector3& _Tdf, 
                                                      Scalar& _Swet, Scalar& _Vsub, Renderable& debug);
         
         //! A static method that computes fluid dynamics when a body is completely submerged.
         /*!
-         \param mesh a pointer to the body physics mesh data
+         \param mesh a pointer to the flat copy of the body physics mesh
          \param liquid a pointer to the fluid entity generating forces
          \param T_CG a transform from the world frame to the body CG frame
          \param T_C a transform from the world frame to the body physics frame
@@ -149,7 +190,7 @@ namespace sf
          \param _Fdf output of the damping force resulting from skin friction
          \param _Tdf output of the torque induced by skin friction
         */
-        static void ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
+        static void ComputeHydrodynamicForcesSubmerged(const MeshSoA* mesh, Ocean* liquid, const Transform& T_CG, const Transform& T_C,
                                                        const Vector3& linearV, const Vector3& angularV, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fdf, Vector3& _Tdf);
         
         //! A method that computes aerodynamics.
@@ -240,6 +281,14 @@ namespace sf
          */
         void SetAddedMass(const Vector3& addedMass, const Vector3& addedInertia);
 
+        //! A method used to limit the number of faces of the mesh used in the geometry-based hydrodynamics.
+        /*!
+         A decimated copy of the physics mesh is created, which replaces it in the computation of buoyancy and drag.
+         The error introduced in the buoyancy and the centre of buoyancy is reported.
+         \param maxFaces the maximum number of faces (0 means using the full physics mesh)
+         */
+        void SetHydrodynamicsMeshFaces(unsigned int maxFaces);
+
         //! A method to set the body pose in the world frame.
         void setCGTransform(const Transform& trans);
         
@@ -361,6 +410,12 @@ namespace sf
         //! A method returning a pointer to the physics mesh.
         const Mesh* getPhysicsMesh();
 
+        //! A method returning a pointer to the mesh used in the geometry-based hydrodynamics (physics mesh if not decimated).
+        const Mesh* getHydrodynamicsMesh();
+
+        //! A method returning a pointer to the flat copy of the hydrodynamics mesh, used in fluid dynamics computations (built on first use).
+        const MeshSoA* getHydrodynamicsMeshSoA();
+
         //! A method that returns a copy of all physics mesh vertices in body origin frame.
         virtual std::vector<Vector3>* getMeshVertices() const;
         
@@ -391,7 +446,6 @@ namespace sf
         int getPhysicalObject() const;
         
     protected:
-        BodyFluidPosition CheckBodyFluidPosition(Ocean* ocn);
         void ComputeFluidDynamicsApprox(GeometryApproxType t);
         void ComputeSphericalApprox();
         void ComputeCylindricalApprox();
@@ -407,7 +461,9 @@ namespace sf
         //Body
         btMultiBodyLinkCollider* multibodyCollider;
         
-        Mesh* phyMesh; //Mesh used for physics calculation
+        std::shared_ptr<const Mesh> phyMesh; //Mesh used for physics calculation (may be shared between bodies)
+        Mesh* hydroMesh; //Decimated physics mesh used in the fluid dynamics computation (optional)
+        MeshSoA* hydroMeshSoA; //Flat copy of the hydrodynamics mesh used by the fluid dynamics kernels
         Scalar thick;
         Scalar volume;
         Scalar surface;
@@ -449,6 +505,21 @@ namespace sf
         Vector3 Fda;
         Vector3 Tda;
         
+        //Adaptive hydrodynamics update
+        bool fdUpdated;
+        unsigned int fdSkipped; //Number of skipped scheduled updates
+        BodyFluidPosition fdLastPosition;
+        Vector3 fdLastV;
+        Vector3 fdLastOmega;
+        Quaternion fdLastQ;
+        Vector3 fdLastP;
+        Scalar fdPosTol; //Position change [m]
+        Scalar fdRotTol; //Orientation change [rad]
+        Scalar fdLinTol; //Linear velocity change (relative to the fluid) [m/s]
+        Scalar fdAngTol; //Angular velocity change [rad/s]
+        Scalar fdRelTol; //Relative velocity change
+        unsigned int fdMaxSkipped; //Scheduled updates
+        
         //Motion
         Vector3 lastV;
         Vector3 lastOmega;
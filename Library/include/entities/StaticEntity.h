@@ -83,7 +83,7 @@ namespace sf
         Transform getTransform();
         
         //! A method returning the material of the entity.
-        Material getMaterial() const;
+        const Material& getMaterial() const;
         
         //! A method returning the rigid body associated with the entity.
         btRigidBody* getRigidBody();
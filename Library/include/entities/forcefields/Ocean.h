@@ -41,6 +41,7 @@ namespace sf
     
     class VelocityField;
     class Actuator;
+    class WaveField;
     
     //! A class implementing an ocean.
     class Ocean : public ForcefieldEntity
@@ -73,7 +74,7 @@ namespace sf
         /*!
          \param world a pointer to the dynamics world
          \param co a pointer to the collision object
-         \param recompute a flag deciding if hydrodynamic forces need to be recomputed
+         \param recompute a flag deciding if hydrodynamic forces need to be recomputed (bodies with adaptive update decide on their own)
          */
         void ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool recompute);
         
@@ -85,6 +86,9 @@ namespace sf
         Vector3 GetFluidVelocity(const Vector3& point) const;
         glm::vec3 GetFluidVelocity(const glm::vec3& point) const;
         
+        //! A method informing if the water velocity is the same at every point.
+        bool hasUniformCurrents() const;
+        
         //! A method checking if a point is inside fluid
         /*!
          \param point the position of a point to be checked [m]
@@ -107,6 +111,16 @@ namespace sf
         Scalar GetDepth(const Vector3& point);
         GLfloat GetDepth(const glm::vec3& point);
         
+        //! A method computing the depth of the ocean at multiple points.
+        /*!
+         \param x a pointer to the X coordinates of the points [m]
+         \param y a pointer to the Y coordinates of the points [m]
+         \param z a pointer to the Z coordinates of the points [m]
+         \param depth a pointer to the output buffer [m]
+         \param n the number of points
+         */
+        void GetDepth(const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* depth, size_t n);
+        
         //! A method to enable all defined currents.
         void EnableCurrents();
         
@@ -115,6 +129,21 @@ namespace sf
 
         //! A method updating the currents data in the OpenGL ocean.
         void UpdateCurrentsData();
+
+        //! A method to configure the computation of the wave field used by the hydrodynamics.
+        /*!
+         The rendered ocean is rebuilt to use the same wave field, so the method has to be called
+         before the vision sensors are created.
+         \param resolution the size of the FFT grid (power of 2, 16-1024)
+         \param updateRate the rate at which the wave field is updated [Hz] (0 means every simulation step)
+         */
+        void ConfigureWaves(unsigned int resolution, Scalar updateRate);
+
+        //! A method advancing the wave field in time.
+        /*!
+         \param dt the time step [s]
+         */
+        void UpdateWaves(Scalar dt);
         
         //! A method used to setup the properties of the water.
         /*!
@@ -137,6 +166,9 @@ namespace sf
         //! A method returning a pointer to the fluid filling the ocean.
         Fluid getLiquid() const;
         
+        //! A method returning a pointer to the wave field used by the hydrodynamics (nullptr if no waves).
+        WaveField* getWaveField();
+
         //! A method returning a pointer to the OpenGL object implementing the ocean.
         OpenGLOcean* getOpenGLOcean();
 
@@ -166,6 +198,7 @@ namespace sf
         Fluid liquid;
         std::vector<VelocityField*> currents;
         OpenGLOcean* glOcean;
+        WaveField* waveField;
         OceanCurrentsUBO glOceanCurrentsUBOData;
         Scalar depth;
         Scalar waterType;
@@ -0,0 +1,125 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  WaveField.h
+//  Stonefish
+//
+
+#pragma once
+
+#include "graphics/OpenGLOcean.h"
+#include <SDL2/SDL_thread.h>
+
+namespace sf
+{
+    //! A class implementing a CPU simulation of the ocean waves, used by the fluid dynamics.
+    /*!
+     The wave field is evolved from the same spectrum as the rendered ocean, using an FFT computed on the CPU.
+     It does not depend on the rendering pipeline, so it works also in console (headless) simulations.
+     A new field is computed in a background thread, one update period ahead of the simulation,
+     and swapped in when the simulation time reaches it.
+     */
+    class WaveField
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param state the state of the ocean (the same as used for rendering)
+         \param resolution the size of the FFT grid (rounded down to a power of 2, 16-1024)
+         \param updateRate the rate at which the wave field is updated [Hz] (0 means every simulation step)
+         */
+        WaveField(GLfloat state, unsigned int resolution = 256, GLfloat updateRate = 20.f);
+
+        //! A destructor.
+        ~WaveField();
+
+        //! A method advancing the wave field in time.
+        /*!
+         \param dt the time step [s]
+         */
+        void Advance(GLfloat dt);
+
+        //! A method to get wave height at a specified coordinate.
+        /*!
+         \param x the x coordinate in world frame [m]
+         \param y the y coordinate in world frame [m]
+         \return wave height [m]
+         */
+        GLfloat ComputeWaveHeight(GLfloat x, GLfloat y) const;
+
+        //! A method returning the size of the FFT grid.
+        unsigned int getResolution() const;
+
+        //! A method returning the update rate of the wave field [Hz].
+        GLfloat getUpdateRate() const;
+
+        //! A static method setting up the spectrum parameters for a given ocean state.
+        /*!
+         \param params a reference to the ocean parameters
+         \param state the state of the ocean
+         */
+        static void SetSeaState(OceanParams& params, GLfloat state);
+
+        //! A static method generating the initial wave spectrum for all grids.
+        /*!
+         \param params a reference to the ocean parameters, where the spectrum will be stored
+         */
+        static void GenerateSpectrum(OceanParams& params);
+
+        //! A static method evaluating the directional wave spectrum.
+        /*!
+         \param params a reference to the ocean parameters
+         \param kx the x component of the wave number [1/m]
+         \param ky the y component of the wave number [1/m]
+         \param omnispectrum a flag to return the omnidirectional spectrum
+         \return the spectrum value
+         */
+        static float Spectrum(const OceanParams& params, float kx, float ky, bool omnispectrum = false);
+
+    private:
+        void Evolve(GLfloat t, GLfloat* h1, GLfloat* h2);
+        void InverseFFT(GLfloat* re, GLfloat* im);
+        void InverseFFTColumns(GLfloat* re, GLfloat* im);
+        void Transpose(GLfloat* data);
+        GLfloat Interpolate(const GLfloat* data, GLfloat x, GLfloat y) const;
+        void RequestField(GLfloat t);
+        void WaitForField();
+
+        static float Omega(const OceanParams& params, float k);
+        static void GetSpectrumSample(const OceanParams& params, int i, int j, float lengthScale, float kMin, long* seed, float* result);
+        static int WorkerThread(void* data);
+
+        OceanParams params;
+        GLfloat period;
+        GLfloat time;
+        GLfloat nextTime;
+        std::vector<GLfloat> heights[2][2]; // [buffer][grid]
+        std::vector<GLfloat> transposed;
+        std::vector<GLfloat> twiddles; // Interleaved cos/sin
+        std::vector<unsigned int> bitReversed;
+        unsigned int front;
+
+        SDL_Thread* worker;
+        SDL_mutex* workerMutex;
+        SDL_cond* workerCond;
+        GLfloat requestedTime;
+        bool requested;
+        bool ready;
+        bool quit;
+    };
+}
@@ -74,8 +74,9 @@ namespace sf
         /*!
          \param settings a structure holding settings of the hydrodynamic computation
          \param ocn a pointer to a fluid entity (only Ocean supported now)
+         \param bf the position of the body with respect to the fluid
          */
-        void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn);
+        void ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, BodyFluidPosition bf);
         
         //! A method that computes aerodynamics.
         /*!
@@ -98,6 +99,13 @@ namespace sf
         //! A method returning the material of the body.
         Material getMaterial(size_t partId) const;
         
+        //! A method returning the id of the material of a part.
+        /*!
+         \param partId the index of the part
+         \return the id of the material or -1 if the part does not exist
+         */
+        int getMaterialId(size_t partId) const;
+        
         //! A method returning the part id for the collision shape id.
         size_t getPartId(size_t collisionShapeId) const;
 
@@ -75,6 +75,16 @@ namespace sf
         //! A method that returns the type of solid.
         SolidType getSolidType();
         
+        //! A method that enables the simplification of the collision hull.
+        /*!
+         By default the collision shape is the exact convex hull of the physics mesh. When simplified, vertices
+         are added until the exact hull is approximated within the tolerance or the vertex limit is reached.
+         The hull is exact only when both limits are zero.
+         \param maxVertices the maximum number of vertices of the hull (0 means no limit)
+         \param tolerance the maximum distance of the exact hull from the simplified one [m]
+         */
+        void setHullSimplification(unsigned int maxVertices, Scalar tolerance);
+        
         //! A method that returns the collision shape.
         btCollisionShape* BuildCollisionShape();
         
@@ -82,7 +92,9 @@ namespace sf
         void BuildGraphicalObject();
         
     private:
-        Mesh *graMesh; //Mesh used for rendering
+        std::shared_ptr<const Mesh> graMesh; //Mesh used for rendering
+        unsigned int hullMaxVertices;
+        Scalar hullTolerance;
     };
 }
 
@@ -42,6 +42,36 @@ namespace sf
         GLint location;
     };
     
+    //! A template mapping C++ types to GLSL variable types.
+    template<typename T> struct GLSLParameterType;
+    template<> struct GLSLParameterType<bool> { static constexpr ParameterType value = BOOLEAN; };
+    template<> struct GLSLParameterType<GLuint> { static constexpr ParameterType value = UINT; };
+    template<> struct GLSLParameterType<GLint> { static constexpr ParameterType value = INT; };
+    template<> struct GLSLParameterType<GLfloat> { static constexpr ParameterType value = FLOAT; };
+    template<> struct GLSLParameterType<glm::vec2> { static constexpr ParameterType value = VEC2; };
+    template<> struct GLSLParameterType<glm::vec3> { static constexpr ParameterType value = VEC3; };
+    template<> struct GLSLParameterType<glm::vec4> { static constexpr ParameterType value = VEC4; };
+    template<> struct GLSLParameterType<glm::ivec2> { static constexpr ParameterType value = IVEC2; };
+    template<> struct GLSLParameterType<glm::ivec3> { static constexpr ParameterType value = IVEC3; };
+    template<> struct GLSLParameterType<glm::ivec4> { static constexpr ParameterType value = IVEC4; };
+    template<> struct GLSLParameterType<glm::uvec2> { static constexpr ParameterType value = UVEC2; };
+    template<> struct GLSLParameterType<glm::uvec3> { static constexpr ParameterType value = UVEC3; };
+    template<> struct GLSLParameterType<glm::uvec4> { static constexpr ParameterType value = UVEC4; };
+    template<> struct GLSLParameterType<glm::mat3> { static constexpr ParameterType value = MAT3; };
+    template<> struct GLSLParameterType<glm::mat4> { static constexpr ParameterType value = MAT4; };
+
+    //! A structure representing a typed handle to a GLSL uniform, resolved once.
+    template<typename T>
+    struct GLSLUniformHandle
+    {
+        GLint location;
+
+        GLSLUniformHandle() : location(-1) {}
+
+        //! A method informing if the handle points to an existing uniform.
+        bool isValid() const { return location >= 0; }
+    };
+    
     //! A structure containing information about a GLSL attribute.
     struct GLSLAttribute
     {
@@ -98,7 +128,7 @@ namespace sf
          \param type the type of the attribute
          \return success
          */
-        bool AddAttribute(std::string name, ParameterType type);
+        bool AddAttribute(const std::string& name, ParameterType type);
         
         //! A method to define a GLSL uniform.
         /*!
@@ -106,7 +136,7 @@ namespace sf
          \param type the type of the uniform
          \return success
          */
-        bool AddUniform(std::string name, ParameterType type);
+        bool AddUniform(const std::string& name, ParameterType type);
         
         //! A method used to set a GLSL attribute.
         /*!
@@ -114,7 +144,7 @@ namespace sf
          \param x the value of the attribute
          \return success
          */
-        bool SetAttribute(std::string name, GLfloat x);
+        bool SetAttribute(const std::string& name, GLfloat x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -122,7 +152,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, bool x);
+        bool SetUniform(const std::string& name, bool x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -130,7 +160,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLfloat x);
+        bool SetUniform(const std::string& name, GLfloat x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -138,7 +168,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec2 x);
+        bool SetUniform(const std::string& name, glm::vec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -146,7 +176,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec3 x);
+        bool SetUniform(const std::string& name, glm::vec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -154,7 +184,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::vec4 x);
+        bool SetUniform(const std::string& name, glm::vec4 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -162,7 +192,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLuint x);
+        bool SetUniform(const std::string& name, GLuint x);
 
         //! A method used to set a GLSL uniform.
         /*!
@@ -170,7 +200,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, GLint x);
+        bool SetUniform(const std::string& name, GLint x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -178,7 +208,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec2 x);
+        bool SetUniform(const std::string& name, glm::ivec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -186,7 +216,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec3 x);
+        bool SetUniform(const std::string& name, glm::ivec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -194,7 +224,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::ivec4 x);
+        bool SetUniform(const std::string& name, glm::ivec4 x);
 
         //! A method used to set a GLSL uniform.
         /*!
@@ -202,7 +232,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec2 x);
+        bool SetUniform(const std::string& name, glm::uvec2 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -210,7 +240,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec3 x);
+        bool SetUniform(const std::string& name, glm::uvec3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -218,7 +248,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::uvec4 x);
+        bool SetUniform(const std::string& name, glm::uvec4 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -226,7 +256,7 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::mat3 x);
+        bool SetUniform(const std::string& name, glm::mat3 x);
         
         //! A method used to set a GLSL uniform.
         /*!
@@ -234,21 +264,60 @@ namespace sf
          \param x the value of the uniform
          \return success
          */
-        bool SetUniform(std::string name, glm::mat4 x);
+        bool SetUniform(const std::string& name, glm::mat4 x);
+
+        //! A method returning a typed handle to a GLSL uniform.
+        /*!
+         The handle should be obtained once, after the uniform was defined, and used in the calls
+         to SetUniform done every frame, which avoids searching the uniform by name.
+         \param name the name of the uniform
+         \return a handle to the uniform (invalid if the uniform doesn't exist or has a different type)
+         */
+        template<typename T>
+        GLSLUniformHandle<T> getUniformHandle(const std::string& name) const
+        {
+            GLSLUniformHandle<T> handle;
+            GLint location;
+            if(GetUniform(name, GLSLParameterType<T>::value, location))
+                handle.location = location;
+            return handle;
+        }
+
+        //! A set of methods used to set a GLSL uniform using a handle.
+        /*!
+         The shader has to be in use.
+         \param h the handle of the uniform
+         \param x the value of the uniform
+         */
+        void SetUniform(const GLSLUniformHandle<bool>& h, bool x);
+        void SetUniform(const GLSLUniformHandle<GLuint>& h, GLuint x);
+        void SetUniform(const GLSLUniformHandle<GLint>& h, GLint x);
+        void SetUniform(const GLSLUniformHandle<GLfloat>& h, GLfloat x);
+        void SetUniform(const GLSLUniformHandle<glm::vec2>& h, glm::vec2 x);
+        void SetUniform(const GLSLUniformHandle<glm::vec3>& h, glm::vec3 x);
+        void SetUniform(const GLSLUniformHandle<glm::vec4>& h, glm::vec4 x);
+        void SetUniform(const GLSLUniformHandle<glm::ivec2>& h, glm::ivec2 x);
+        void SetUniform(const GLSLUniformHandle<glm::ivec3>& h, glm::ivec3 x);
+        void SetUniform(const GLSLUniformHandle<glm::ivec4>& h, glm::ivec4 x);
+        void SetUniform(const GLSLUniformHandle<glm::uvec2>& h, glm::uvec2 x);
+        void SetUniform(const GLSLUniformHandle<glm::uvec3>& h, glm::uvec3 x);
+        void SetUniform(const GLSLUniformHandle<glm::uvec4>& h, glm::uvec4 x);
+        void SetUniform(const GLSLUniformHandle<glm::mat3>& h, const glm::mat3& x);
+        void SetUniform(const GLSLUniformHandle<glm::mat4>& h, const glm::mat4& x);
 
         //! A method used to bind a GLSL uniform block.
         /*!
          \param name the name of the uniform block
          \param bindingPoint the index of the binding point
          */
-        bool BindUniformBlock(std::string name, GLuint bindingPoint);
+        bool BindUniformBlock(const std::string& name, GLuint bindingPoint);
 
         //! A method used to bind a GLSL shader storage block.
         /*!
          \param name the name of the shader storage block
          \param bindingPoint the index of the binding point
          */
-        bool BindShaderStorageBlock(std::string name, GLuint bindingPoint);
+        bool BindShaderStorageBlock(const std::string& name, GLuint bindingPoint);
 
         //! A method to check if the shader is valid.
         bool isValid();
@@ -279,8 +348,8 @@ namespace sf
         static GLuint LoadShader(GLenum shaderType, const std::string& filename, const std::string& header, GLint* shaderCompiled);
         
     private:
-        bool GetAttribute(std::string name, ParameterType type, GLint& index);
-        bool GetUniform(std::string name, ParameterType type, GLint& location);
+        bool GetAttribute(const std::string& name, ParameterType type, GLint& index);
+        bool GetUniform(const std::string& name, ParameterType type, GLint& location) const;
         
         std::vector<GLSLAttribute> attributes;
         std::vector<GLSLUniform> uniforms;
@@ -32,6 +32,7 @@
 #include "graphics/OpenGLPointLight.h"
 #include "graphics/OpenGLSpotLight.h"
 #include <map>
+#include <unordered_map>
 
 namespace sf
 {
@@ -91,6 +92,21 @@ namespace sf
         }
     };
 
+    //! A structure holding handles of the material shader uniforms set for every draw.
+    struct MaterialUniforms
+    {
+        GLSLUniformHandle<glm::mat4> MVP;
+        GLSLUniformHandle<glm::mat4> M;
+        GLSLUniformHandle<glm::mat3> N;
+        GLSLUniformHandle<glm::mat3> MV;
+        GLSLUniformHandle<glm::mat4> VP;
+        GLSLUniformHandle<glm::mat3> VN;
+        GLSLUniformHandle<GLfloat> FC;
+        GLSLUniformHandle<glm::vec3> eyePos;
+        GLSLUniformHandle<glm::vec3> viewDir;
+        GLSLUniformHandle<GLfloat> cableRadius;
+    };
+
     //! A class implementing OpenGL content management and core rendering funtions.
     class OpenGLContent
     {
@@ -223,6 +239,21 @@ namespace sf
          */
         void DrawObject(int objectId, int lookId, const glm::mat4& M);
 
+        //! A method to draw multiple instances of an object in a single call.
+        /*!
+         \param objectId the id of the graphical object
+         \param lookId the id of the graphical material
+         \param M a list of model matrices, one per instance
+         */
+        void DrawObjectInstanced(int objectId, int lookId, const std::vector<glm::mat4>& M);
+
+        //! A method to draw solid renderables, merging the ones sharing geometry and look into instanced draws.
+        /*!
+         \param renderables a list of renderables (other than solids are skipped)
+         \param indices a list of indices of the renderables to draw
+         */
+        void DrawObjectGroups(const std::vector<Renderable>& renderables, const std::vector<size_t>& indices);
+
         //! A method to draw the light source.
         /*!
          \param lightId the id of the light
@@ -254,7 +285,15 @@ namespace sf
          \param mesh a pointer to the mesh structure
          \return an id of the built object
          */
-        unsigned int BuildObject(Mesh* mesh);
+        unsigned int BuildObject(const Mesh* mesh);
+        
+        //! A method returning the id of the object owning the geometry buffers of an object.
+        /*!
+         Objects built from identical meshes share the buffers, which allows drawing them with instancing.
+         \param objectId the id of the graphical object
+         \return the id of the object owning the geometry
+         */
+        int getGeometryId(int objectId) const;
         
         //! A method to build a cable object.
         /*!
@@ -297,9 +336,8 @@ namespace sf
         /*!
          \param look a reference to the look structure
          \param texturable a flag determining if the object rendered is texturable
-         \param M the model matrix
          */
-        void UseLook(const Look& look, bool texturable, const glm::mat4& M);
+        void UseLook(const Look& look, bool texturable);
         
         //! A method to use a cable look.
         /*!
@@ -399,7 +437,7 @@ namespace sf
          \param filename a path to the model file
          \param scale the scale of the model
          \param smooth a flag to decide if model normals should be smoothed after loading
-         \return a pointer to the allocated mesh structure
+         \return a pointer to the allocated mesh structure (a copy of the mesh stored in the mesh cache)
          */
         static Mesh* LoadMesh(const std::string& filename, GLfloat scale, bool smooth);
         
@@ -531,9 +569,11 @@ namespace sf
          \param bsRadius a reference to a variable that will store the sphere radius
          \param bsCenterOffset a reference to a variable that will store the sphere center position
          */
-        static void AABS(Mesh* mesh, GLfloat& bsRadius, glm::vec3& bsCenterOffset);
+        static void AABS(const Mesh* mesh, GLfloat& bsRadius, glm::vec3& bsCenterOffset);
         
     private:
+        void SetInstanceAttributes(const glm::mat4& M);
+
         //Modes
         DrawingMode mode;
         GLfloat maxAnisotropy;
@@ -547,12 +587,15 @@ namespace sf
         NameManager lookNameManager;
         std::string currentLookName;
         std::string currentShaderMode;
+        GLSLShader* currentShader;
+        const MaterialUniforms* currentUniforms;
         
         glm::vec3 eyePos;
         glm::vec3 viewDir;
         glm::mat4 view; //Current view matrix;
         glm::mat4 projection; //Current projection matrix
         glm::mat4 viewProjection; //Current view-projection matrix
+        glm::mat3 viewNormal; //Current normal matrix of the view
         glm::vec2 viewportSize; //Current view-port size
         GLfloat FC; //Current logarithmic depth buffer constant
         
@@ -566,9 +609,22 @@ namespace sf
         LightsUBO lightsUBOData;
         GLuint viewUBO;
         
+        //Instancing
+        GLuint instanceVBO; //per-instance data of the current instanced draw
+        std::vector<InstanceData> instanceData;
+        std::vector<size_t> instanceOrder;
+        std::vector<glm::mat4> instanceMatrices;
+        std::unordered_map<uint64_t, unsigned int> geometryLookup; //mesh hash -> id of the object owning the geometry
+        
         //Shaders
         std::map<std::string, GLSLShader*> basicShaders;
         std::vector<MaterialShader> materialShaders;
+        std::unordered_map<const GLSLShader*, MaterialUniforms> materialUniforms;
+        GLSLShader* shadowShader;
+        GLSLShader* flatShader;
+        GLSLUniformHandle<glm::mat4> shadowVP;
+        GLSLUniformHandle<glm::mat4> flatMVP;
+        GLSLUniformHandle<GLfloat> flatFC;
         GLSLShader* lightSourceShader[2];
     };
 }
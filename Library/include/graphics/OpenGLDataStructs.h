@@ -85,6 +85,11 @@
 #define SSBO_PARTICLE_VEL       ((GLuint)8)
 #define SSBO_QTREE_INDIRECT     ((GLuint)9)
 #define SSBO_QTREE_SIZE         ((GLuint)10)
+#define SSBO_SONAR_OBJECTS      ((GLuint)11)
+
+//Per-instance vertex attributes of objects (mat4 and mat3 take 4 and 3 locations)
+#define ATTRIB_INSTANCE_M       ((GLuint)4)
+#define ATTRIB_INSTANCE_N       ((GLuint)8)
 
 //Light params
 #define MAX_POINT_LIGHTS        ((GLint)32)
@@ -344,6 +349,16 @@ namespace sf
         GLuint vboIndex;
         GLsizei faceCount;
         bool texturable;
+        glm::vec3 bsCenter; //Bounding sphere center (local frame)
+        GLfloat bsRadius; //Bounding sphere radius
+        int geometryId; //Id of the object owning the buffers (shared by objects built from identical meshes)
+    };
+
+    //! A structure holding per-instance data of an object (vertex attribs 4-10).
+    struct InstanceData
+    {
+        glm::mat4 M; //Model matrix
+        glm::mat3 N; //Normal matrix
     };
 
     //! A structure representing a cable.
@@ -526,6 +541,7 @@ namespace sf
         int lookId;
         int objectId;
         std::string materialName;
+        int materialId;
         glm::mat4 model;
         glm::vec3 cor;
         glm::vec3 vel;
@@ -539,6 +555,7 @@ namespace sf
             lookId = -1;
             objectId = -1;
             materialName = "";
+            materialId = -1;
             model = glm::mat4(1.f);
             cor = glm::vec3(0.f);
             vel = glm::vec3(0.f);
@@ -32,6 +32,7 @@
 namespace sf
 {
     class GLSLShader;
+    class OpenGLReadbackBuffer;
     class Camera;
     class SolidEntity;
     
@@ -170,7 +171,7 @@ namespace sf
         GLuint renderDepthTex;
         GLuint linearDepthTex;
         GLuint linearDepthFBO;
-        GLuint linearDepthPBO;
+        OpenGLReadbackBuffer* linearDepthReadback;
         static GLSLShader** depthCameraOutputShader;
         static GLSLShader* depthVisualizeShader;
     };
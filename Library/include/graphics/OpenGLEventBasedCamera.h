@@ -32,6 +32,7 @@
 namespace sf
 {
     class EventBasedCamera;
+    class OpenGLReadbackBuffer;
  
     //! A class implementing a real camera in OpenGL.
     class OpenGLEventBasedCamera : public OpenGLCamera
@@ -127,7 +128,7 @@ namespace sf
         
     private:
         EventBasedCamera* camera;
-        GLuint outputPBO;
+        OpenGLReadbackBuffer* outputReadback; // Buffer 0 - events, buffer 1 - event count
         GLuint renderLogLumTex;   // Last logarithm luminance image
         GLuint renderEventTex[3]; // Events, last event timestamps, crossings
         GLuint renderEventCounter; // Atomic event counter
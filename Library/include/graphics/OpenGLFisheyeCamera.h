@@ -32,6 +32,7 @@ namespace sf
 {
     class FisheyeCamera;
     class GLSLShader;
+    class OpenGLReadbackBuffer;
     class Ocean;
 
     //! An OpenGL view rendering an equidistant fisheye from a cubemap.
@@ -80,7 +81,7 @@ namespace sf
         GLuint displayTex;
         GLuint outputFBO;
         GLuint displayFBO;
-        GLuint outputPBO;
+        OpenGLReadbackBuffer* outputReadback;
 
         glm::vec3 eye;
         glm::vec3 dir;
@@ -73,8 +73,9 @@ namespace sf
         //! A constructor.
         /*!
          \param size the size of the ocean surface mesh [m]
+         \param fftSize the size of the FFT grid used to simulate the waves (power of 2, 16-1024)
          */
-        OpenGLOcean(GLfloat size);
+        OpenGLOcean(GLfloat size, GLuint fftSize = 256);
         
         //! A destructor.
         virtual ~OpenGLOcean();
@@ -250,10 +251,6 @@ namespace sf
         void computeWeight(int N, int k, float &Wr, float &Wi);
         float ComputeSlopeVariance();
         float GetSlopeVariance(float kx, float ky, float *spectrumSample);
-        void GenerateWavesSpectrum();
-        void GetSpectrumSample(int i, int j, float lengthScale, float kMin, float *result);
-        float spectrum(float kx, float ky, bool omnispectrum = false);
-        float omega(float k);
 
         int oceanBoxObj;
         bool particlesEnabled;
@@ -32,6 +32,7 @@
 namespace sf
 {
     class GLSLShader;
+    class OpenGLReadbackBuffer;
     class Camera;
     class SolidEntity;
     
@@ -169,8 +170,7 @@ namespace sf
         GLuint renderDepthTex;
         GLuint renderFlowTex[2];
         GLuint displayFlowTex;
-        GLuint outputPBO;
-        GLuint displayPBO;
+        OpenGLReadbackBuffer* readback; // Buffer 0 - output, buffer 1 - display
         GLuint displayFBO;
         GLuint displayVAO;
         GLuint displayVBO;
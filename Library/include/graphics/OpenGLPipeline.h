@@ -77,6 +77,12 @@ namespace sf
 		
         //! A method that draws all normal objects.
         void DrawObjects();
+        
+        //! A method that draws a subset of normal objects.
+        /*!
+         \param indices a list of indices of the objects in the drawing queue (e.g. result of view culling)
+         */
+        void DrawObjects(const std::vector<size_t>& indices);
 		
 		//! A method that draws all lights.
 		void DrawLights();
@@ -111,6 +117,7 @@ namespace sf
     private:
         void PerformDrawingQueueCopy(SimulationManager* sim);
         void DrawHelpers();
+        void DrawRenderable(const Renderable& r);
         
         RenderSettings rSettings;
         HelperSettings hSettings;
@@ -118,6 +125,9 @@ namespace sf
         std::vector<Renderable> drawingQueueCopy;
         std::vector<Renderable> selectedDrawingQueue;
         std::vector<Renderable> selectedDrawingQueueCopy;
+        std::vector<size_t> queueIndices;
+        std::vector<size_t> solidRun;
+        std::vector<size_t> visibleQueue;
         SDL_mutex* drawingQueueMutex;
         std::deque<unsigned int> viewsQueue;
         GLuint screenFBO;
@@ -0,0 +1,114 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLReadbackBuffer.h
+//  Stonefish
+//
+
+#pragma once
+
+#include "graphics/OpenGLDataStructs.h"
+
+namespace sf
+{
+    //! A class implementing an asynchronous, multi-buffered readback of GPU data through pixel buffer objects.
+    /*!
+     Each frame written to the ring consists of one or more pixel buffer objects (e.g. raw data and display image)
+     and is protected by a fence. Reading returns the newest frame for which the GPU has already finished
+     the transfer, without blocking the CPU. When the ring is full, the oldest pending frame is dropped.
+     */
+    class OpenGLReadbackBuffer
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param size the size of the single buffer in a frame [B]
+         \param depth the number of frames in the ring
+         */
+        OpenGLReadbackBuffer(GLsizeiptr size, unsigned int depth = 3);
+
+        //! A constructor.
+        /*!
+         \param sizes the sizes of the buffers making up a frame [B]
+         \param depth the number of frames in the ring
+         */
+        OpenGLReadbackBuffer(const std::vector<GLsizeiptr>& sizes, unsigned int depth = 3);
+
+        //! A destructor.
+        ~OpenGLReadbackBuffer();
+
+        //! A method that starts writing a new frame.
+        void BeginWrite();
+
+        //! A method that binds one of the buffers of the frame being written as the pixel pack buffer.
+        /*!
+         \param buffer the index of the buffer in the frame
+         */
+        void BindForWriting(unsigned int buffer = 0);
+
+        //! A method that finishes writing the frame and inserts a fence into the command stream.
+        void EndWrite();
+
+        //! A method that selects the newest frame already transferred by the GPU (non-blocking).
+        /*!
+         \return true if a completed frame is available for mapping
+         */
+        bool AcquireLatest();
+
+        //! A method that maps one of the buffers of the acquired frame for reading.
+        /*!
+         \param buffer the index of the buffer in the frame
+         \return a pointer to the mapped data or nullptr on failure
+         */
+        void* Map(unsigned int buffer = 0);
+
+        //! A method that unmaps the currently mapped buffer.
+        void Unmap();
+
+        //! A method returning the id of one of the buffers of the frame being written.
+        /*!
+         \param buffer the index of the buffer in the frame
+         \return the OpenGL id of the buffer
+         */
+        GLuint getWriteBuffer(unsigned int buffer = 0) const;
+
+        //! A method informing if there are frames waiting for the transfer to finish.
+        bool isPending() const;
+
+        //! A method returning the number of frames in the ring.
+        unsigned int getDepth() const;
+
+    private:
+        struct Frame
+        {
+            std::vector<GLuint> pbos;
+            GLsync fence;
+        };
+
+        void Allocate(const std::vector<GLsizeiptr>& sizes, unsigned int depth);
+        void DropOldest();
+
+        std::vector<Frame> frames;
+        std::vector<GLsizeiptr> bufferSizes;
+        unsigned int first; // Oldest pending frame
+        unsigned int count; // Number of pending frames
+        unsigned int writing;
+        unsigned int reading;
+        bool mapped;
+    };
+}
@@ -31,6 +31,7 @@
 namespace sf
 {
     class ColorCamera;
+    class OpenGLReadbackBuffer;
  
     //! A class implementing a real camera in OpenGL.
     class OpenGLRealCamera : public OpenGLCamera
@@ -108,7 +109,7 @@ namespace sf
         ColorCamera* camera;
         GLuint cameraFBO;
         GLuint cameraColorTex[2];
-        GLuint cameraPBO;
+        OpenGLReadbackBuffer* cameraReadback;
         
         glm::mat4 cameraTransform;
         glm::vec3 eye;
@@ -31,6 +31,8 @@
 
 namespace sf
 {
+    class WaveField;
+    
     //! A structure hold the quad-tree information for each camera.
     struct OceanQT
     {
@@ -49,9 +51,9 @@ namespace sf
         /*!
          \param size the size of the ocean surface mesh [m]
          \param state the state of the ocean, if >0 the ocean is rendered with geometric waves otherwise as a plane with wave texture
-         \param hydrodynamics a pointer to a mutex
+         \param waves a pointer to the wave field used by the hydrodynamics (defines the FFT grid size)
          */
-        OpenGLRealOcean(GLfloat size, GLfloat state, SDL_mutex* hydrodynamics);
+        OpenGLRealOcean(GLfloat size, GLfloat state, const WaveField* waves);
         
         //! A destructor.
         ~OpenGLRealOcean();
@@ -62,6 +64,14 @@ namespace sf
 		 */
         void Simulate(GLfloat dt) override;
          
+        //! A method to get wave height at a specified coordinate.
+        /*!
+         \param x the x coordinate in world frame [m]
+         \param y the y coordinate in world frame [m]
+         \return wave height [m], sampled from the wave field used by the hydrodynamics
+         */
+        GLfloat ComputeWaveHeight(GLfloat x, GLfloat y) override;
+         
         //! A method that resets the quad tree.
         /*!
          \param view a pointer to the active view
@@ -97,14 +107,6 @@ namespace sf
          \param view a pointer to the active view
          */
         void DrawUnderwaterMask(OpenGLView* view) override;
-                
-        //! A method to get wave height at a specified coordinate.
-        /*!
-         \param x the x coordinate in world frame [m]
-         \param y the y coordinate in world frame [m]
-         \return wave height [m]
-         */
-        GLfloat ComputeWaveHeight(GLfloat x, GLfloat y) override;
 
         //! A method do enable wireframe rendering.
         /*!
@@ -114,14 +116,11 @@ namespace sf
         
     private:
         void InitializeSimulation() override;
-        GLfloat ComputeInterpolatedWaveData(GLfloat x, GLfloat y, GLuint channel);
 
+        const WaveField* waveField;
         GLuint vao;
         GLuint oceanBuffers[2];
-        GLuint fftPBO;
         std::map<OpenGLView*, OceanQT> oceanTrees; 
-        SDL_mutex* hydroMutex;
-        GLfloat* fftData;
         GLint qtGridTessFactor;
         GLint qtGPUTessFactor;
         GLint qtPatchIndexCount;
@@ -32,6 +32,7 @@
 namespace sf
 {
     class GLSLShader;
+    class OpenGLReadbackBuffer;
     class Camera;
     class SolidEntity;
     class Ocean;
@@ -155,8 +156,7 @@ namespace sf
         GLuint renderDepthTex;
         GLuint renderSegTex[2];
         GLuint displaySegTex;
-        GLuint outputPBO;
-        GLuint displayPBO;
+        OpenGLReadbackBuffer* readback; // Buffer 0 - output, buffer 1 - display
         GLuint displayFBO;
         GLuint displayVAO;
         GLuint displayVBO;
@@ -27,14 +27,25 @@
 #define __Stonefish_OpenGLSonar__
 
 #include "graphics/OpenGLView.h"
+#include "graphics/GLSLShader.h"
 #include <random>
 
 namespace sf
 {
-    class GLSLShader;
+    class OpenGLReadbackBuffer;
  
     enum class SonarOutputFormat { U8, U16, U32, F32 };
 
+    //! A structure holding per-object data shared by all sonar views (std430 layout).
+    struct alignas(16) SonarObjectData
+    {
+        glm::mat4 M;
+        glm::vec4 N[3]; //Normal matrix columns, padded
+        GLfloat restitution;
+        GLfloat pad[3];
+    };
+    static_assert(sizeof(SonarObjectData) == 128, "SonarObjectData has to match the std430 layout of the shader struct");
+
     //! An abstract class representing a sonar view.
     class OpenGLSonar : public OpenGLView
     {
@@ -128,7 +139,29 @@ namespace sf
         //! A static method to destroy shaders.
         static void Destroy();
         
+        //! A static method returning the size of a single sample of the sonar output.
+        /*!
+         \param format the output format of the sonar
+         \return size of the sample [bytes]
+         */
+        static size_t getSampleSize(SonarOutputFormat format);
+        
+        //! A static method that uploads the data of the objects to be drawn by all sonar views.
+        /*!
+         Has to be called once per frame, before the sonar outputs are computed, with the same 
+         list of renderables. The model and normal matrices, as well as the restitution of the material,
+         are computed once and indexed by the sonar views using the position of the renderable in the list.
+         \param objects a list of renderables
+         */
+        static void UpdateObjectData(const std::vector<Renderable>& objects);
+        
     protected:
+        //! A method that allocates the readback buffers for the sonar data and the display image.
+        /*!
+         \param nSamples the number of samples in the sonar output
+         */
+        void AllocateReadback(GLuint nSamples);
+
         //Sonar specific
         glm::mat4 sonarTransform_;
         glm::vec3 eye_;
@@ -152,14 +185,18 @@ namespace sf
         SonarOutputFormat outputFormat_;
         GLuint inputRangeIntensityTex_;
         GLuint inputDepthRBO_;
-        GLuint outputPBO_;
         GLuint displayTex_;
         GLuint displayFBO_;
-        GLuint displayPBO_;
+        OpenGLReadbackBuffer* readback_; // Buffer 0 - output, buffer 1 - display
         GLuint displayVAO_;
         GLuint displayVBO_;
         
         static GLSLShader* sonarInputShader_[2];
+        static GLSLUniformHandle<glm::mat4> sonarInputVP_[2];
+        static GLSLUniformHandle<GLuint> sonarInputObjectIndex_[2];
+        static GLuint objectDataSSBO_;
+        static size_t objectDataCapacity_;
+        static std::vector<SonarObjectData> objectData_;
         static GLSLShader* sonarVisualizeShader_[2];
     };
 }
@@ -32,6 +32,7 @@
 namespace sf
 {
     class GLSLShader;
+    class OpenGLReadbackBuffer;
     class Camera;
     class SolidEntity;
     
@@ -175,8 +176,7 @@ namespace sf
         GLuint renderDepthTex;
         GLuint renderTex[3];
         GLuint displayTex;
-        GLuint outputPBO;
-        GLuint displayPBO;
+        OpenGLReadbackBuffer* readback; // Buffer 0 - output, buffer 1 - display
         GLuint displayFBO;
         GLuint displayVAO;
         GLuint displayVBO;
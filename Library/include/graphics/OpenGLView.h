@@ -137,6 +137,16 @@ namespace sf
          */
         static void ExtractFrustumFromVP(glm::vec4 frustum[6], const glm::mat4& VP);
         
+        //! A method selecting the renderables that can be visible in the view.
+        /*!
+         Solid objects are tested using their bounding spheres. Other renderables are always kept.
+         \param objects a list of renderables
+         \param VP the view-projection matrix used for drawing
+         \param depthPlanes a flag indicating if the near and far planes should be tested (only valid when depth clamping is disabled)
+         \param visible a list to be filled with the indices of the potentially visible renderables
+         */
+        void CullObjects(const std::vector<Renderable>& objects, const glm::mat4& VP, bool depthPlanes, std::vector<size_t>& visible) const;
+        
     protected:
         GLint originX;
         GLint originY;
@@ -146,6 +156,7 @@ namespace sf
         bool enabled;
         bool continuous;
         ViewUBO viewUBOData;
+        std::vector<size_t> visibleObjects;
     };
 }
     
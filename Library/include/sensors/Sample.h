@@ -42,6 +42,14 @@ namespace sf
          */
         Sample(const std::vector<Scalar>& data, bool invalid = false, uint64_t index = 0);
         
+        //! A constructor.
+        /*!
+         \param timestamp the time of the measurement [s]
+         \param data a vector of values of the measurement
+         \param index a number specifying the id of the sample
+         */
+        Sample(Scalar timestamp, const std::vector<Scalar>& data, uint64_t index);
+        
         //! A copy constructor.
         /*!
          \param other a reference to a sample object
@@ -67,6 +75,9 @@ namespace sf
         
         //! A method returning a pointer to the sample data.
         Scalar* getDataPointer();
+        
+        //! A method returning a constant pointer to the sample data.
+        const Scalar* getDataPointer() const;
 
         //! A method returning the id of the sample.
         uint64_t getId() const;
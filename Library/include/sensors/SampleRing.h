@@ -0,0 +1,114 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SampleRing.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <atomic>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    //! A class implementing a single producer ring buffer of sensor samples.
+    /*!
+     Samples are stored as flat blocks of channel values, in storage allocated once, so that writing a sample
+     does not touch the heap. Each slot carries a sequence number, odd while the slot is written, which readers
+     check before and after copying a sample. Readers are lock-free with retry: they never block the producer,
+     but copy a sample again if it was being written in the meantime, so a reader racing a fast producer may retry repeatedly. With unlimited history the storage grows geometrically and the replaced blocks are
+     kept until destruction, so that concurrent readers stay valid.
+     */
+    class SampleRing
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param historyLength defines: -1 -> only the last sample, 0 -> unlimited history, >0 -> history with a specified length
+         */
+        SampleRing(int historyLength);
+        
+        //! A destructor.
+        ~SampleRing();
+        
+        //! A method returning a pointer to the storage of the next sample (producer only).
+        /*!
+         \param channels the number of channels of a sample (used to allocate the storage on first call)
+         \return a pointer to the values of the next sample
+         */
+        Scalar* BeginWrite(unsigned short channels);
+        
+        //! A method publishing the sample written after the last call to BeginWrite (producer only).
+        /*!
+         \param timestamp the time of the sample [s]
+         */
+        void EndWrite(Scalar timestamp);
+        
+        //! A method removing all samples from the history (producer only).
+        void Clear();
+        
+        //! A method copying a sample from the history.
+        /*!
+         \param index the index of the sample in the history (0 is the oldest one)
+         \param values a pointer to the output buffer (at least getNumOfChannels() elements)
+         \param timestamp output of the time of the sample [s]
+         \param id output of the number of the sample (counted from the creation of the buffer)
+         \return true if the sample was available
+         */
+        bool Read(size_t index, Scalar* values, Scalar& timestamp, uint64_t& id) const;
+        
+        //! A method copying the last sample.
+        /*!
+         \param values a pointer to the output buffer (at least getNumOfChannels() elements)
+         \param timestamp output of the time of the sample [s]
+         \param id output of the number of the sample (counted from the creation of the buffer)
+         \return true if a sample was available
+         */
+        bool ReadLast(Scalar* values, Scalar& timestamp, uint64_t& id) const;
+        
+        //! A method returning the number of samples in the history.
+        size_t getSize() const;
+        
+        //! A method returning the number of samples written since the creation of the buffer.
+        uint64_t getCount() const;
+        
+        //! A method returning the number of channels of a sample.
+        unsigned short getNumOfChannels() const;
+        
+    private:
+        struct Storage
+        {
+            Storage(size_t capacity, size_t stride);
+            
+            size_t capacity;
+            std::vector<Scalar> data; //Timestamp followed by the channel values, for each slot
+            std::vector<std::atomic<uint64_t>> seq; //2n+1 while sample n is written, 2n+2 when it is complete
+        };
+        
+        bool ReadAbsolute(uint64_t n, Scalar* values, Scalar& timestamp) const;
+        void Grow();
+        
+        size_t limit; //0 means unlimited
+        std::atomic<unsigned short> nChannels;
+        std::atomic<Storage*> storage;
+        std::vector<Storage*> retired;
+        std::atomic<uint64_t> head; //Number of published samples
+        std::atomic<uint64_t> tail; //Number of the oldest sample in the history
+    };
+}
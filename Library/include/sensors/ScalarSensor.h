@@ -26,8 +26,8 @@
 #ifndef __Stonefish_ScalarSensor__
 #define __Stonefish_ScalarSensor__
 
-#include <deque>
 #include "sensors/Sensor.h"
+#include "sensors/SampleRing.h"
 
 namespace sf
 {
@@ -127,6 +127,9 @@ namespace sf
         Sample getLastSample() const;
         
         //! A method returing a pointer to a copy of the history of sensor measurements.
+        /*!
+         The history is read without blocking the simulation. The caller takes the ownership of the copy.
+         */
         const std::vector<Sample>* getHistory();
         
         //! A method returning the value of the measurement.
@@ -156,12 +159,13 @@ namespace sf
         
     protected:
         void AddSampleToHistory(const Sample& s);
-        std::deque<Sample*> history;
+        void AddSampleToHistory(const Scalar* data, size_t n);
+        template<size_t N> void AddSampleToHistory(const Scalar (&data)[N]) { AddSampleToHistory(data, N); }
+        SampleRing history;
         std::vector<SensorChannel> channels;
-        uint64_t sampleCount;
         
     private:
-        int historyLen;
+        void WriteSampleToHistory(const Scalar* values, size_t n, Scalar timestamp);
     };
 }
     
@@ -29,6 +29,7 @@
 #include <random>
 #include <SDL2/SDL_mutex.h>
 #include "StonefishCommon.h"
+#include "sensors/SensorData.h"
 
 namespace sf
 {
@@ -36,6 +37,7 @@ namespace sf
     enum class SensorType {JOINT, LINK, VISION, OTHER};
     
     struct Renderable;
+    class RayQueryBatch;
     
     //! An abstract class representing a sensor.
     class Sensor
@@ -63,12 +65,34 @@ namespace sf
          */
         void Update(Scalar dt);
         
+        //! A method that starts the update of the sensor readings, if the sensor is due for an update.
+        /*!
+         Ray-based sensors add their rays to the batch, which has to be executed before calling FinishUpdate.
+         \param dt a time step of the simulation [s]
+         \param rays a pointer to the ray query batch of the simulation tick (nullptr if the sensor should trace its rays by itself)
+         \return true if the sensor is due for an update
+         */
+        bool PrepareUpdate(Scalar dt, RayQueryBatch* rays);
+        
+        //! A method that finishes the update started by PrepareUpdate.
+        void FinishUpdate();
+        
         //! A method used to mark data as old.
         void MarkDataOld();
 
         //! A method to check if new data is available.
         bool isNewDataAvailable() const;
         
+        //! A method returning a read-only view of the latest measurement.
+        /*!
+         The view can be used without copying the data and without locking the sensor, e.g., to serialise
+         the measurement in another thread. The data stays valid as long as the returned pointer is held.
+         Publishing of the views starts with the first call of this method, therefore it can return nullptr
+         until the next measurement is produced.
+         \return a shared pointer to the view or nullptr if no data is available
+         */
+        std::shared_ptr<const SensorData> getLatestData() const;
+        
         //! A method to set the sampling rate of the sensor.
         /*!
          \param f the sampling frequency of the sensor [Hz]
@@ -116,8 +140,23 @@ namespace sf
         virtual void getSensorVelocity(Vector3& linear, Vector3& angular) const = 0;
         
     protected:
+        //! A method used to add the rays needed by the next update to a batch (ray-based sensors).
+        /*!
+         \param batch a reference to the ray query batch
+         */
+        virtual void QueueRays(RayQueryBatch& batch);
+        
+        //! A method returning the batch containing the results of the rays queued for the current update.
+        /*!
+         If the rays were not queued in the batch of the simulation tick, they are traced immediately.
+         \param local a reference to a batch used when tracing immediately
+         \return a pointer to the batch with the results
+         */
+        const RayQueryBatch* getRayResults(RayQueryBatch& local);
+        
         Scalar freq;
         SDL_mutex* updateMutex;
+        SensorDataBuffer latestData;
         
         static std::random_device randomDevice;
         static std::mt19937 randomGenerator;
@@ -125,6 +164,8 @@ namespace sf
     private:
         std::string name;
         Scalar eleapsedTime;
+        Scalar pendingDt;
+        const RayQueryBatch* rayBatch;
         bool newDataAvailable;
         bool renderable;
         bool enabled;
@@ -0,0 +1,113 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorData.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <atomic>
+#include <SDL2/SDL_atomic.h>
+#include "StonefishCommon.h"
+
+namespace sf
+{
+    //! A structure representing a read-only view of a single measurement.
+    /*!
+     The view is handed out as a shared pointer. The underlying buffer stays pinned, i.e., it is not
+     overwritten by the sensor, as long as at least one copy of the pointer exists.
+     */
+    struct SensorData
+    {
+        uint64_t sequence;  //!< Number of the measurement (counted from the creation of the sensor).
+        Scalar timestamp;   //!< Simulation time of the measurement [s].
+        const void* data;   //!< Pointer to the measurement data.
+        size_t size;        //!< Size of the measurement data [bytes].
+        
+        //! A method returning the data as an array of a specific type.
+        template<typename T> const T* as() const { return static_cast<const T*>(data); }
+        
+        //! A method returning the number of elements of a specific type in the data.
+        template<typename T> size_t count() const { return size/sizeof(T); }
+    };
+    
+    //! A class implementing a pool of reference-counted buffers, used to publish sensor measurements.
+    /*!
+     A single producer writes a measurement into a buffer which is not referenced by any reader and publishes it as
+     the latest one. Readers obtain the latest measurement without copying it and without blocking the producer
+     (only a shared pointer is copied under a spin lock). Buffers are reused when released by all readers, so that
+     in the steady state publishing does not touch the heap. Publishing is only done after the first request
+     for the data, to avoid copying measurements nobody reads.
+     */
+    class SensorDataBuffer
+    {
+    public:
+        //! A constructor.
+        SensorDataBuffer();
+        
+        //! A method returning a pointer to the storage of the next measurement (producer only).
+        /*!
+         \param size the size of the measurement [bytes]
+         \return a pointer to the storage or nullptr if nobody requested the data yet
+         */
+        void* BeginWrite(size_t size);
+        
+        //! A method publishing the measurement written after the last call to BeginWrite (producer only).
+        /*!
+         \param timestamp the time of the measurement [s]
+         \param sequence the number of the measurement
+         */
+        void EndWrite(Scalar timestamp, uint64_t sequence);
+        
+        //! A method copying a measurement into the next buffer and publishing it (producer only).
+        /*!
+         \param data a pointer to the measurement data
+         \param size the size of the measurement [bytes]
+         \param timestamp the time of the measurement [s]
+         \param sequence the number of the measurement
+         */
+        void Publish(const void* data, size_t size, Scalar timestamp, uint64_t sequence);
+        
+        //! A method dropping the latest measurement (producer only).
+        void Clear();
+        
+        //! A method returning a view of the latest measurement.
+        /*!
+         The first call enables publishing, so it may return nullptr even if the sensor produced data before.
+         \return a shared pointer to the view or nullptr if no data is available
+         */
+        std::shared_ptr<const SensorData> getLatest() const;
+        
+        //! A method informing if anybody requested the data.
+        bool isActive() const;
+        
+    private:
+        struct Block
+        {
+            SensorData view;
+            std::vector<uint8_t> bytes;
+        };
+        
+        std::vector<std::shared_ptr<Block>> pool;
+        std::shared_ptr<Block> writing;
+        std::shared_ptr<Block> latest;
+        mutable std::atomic<bool> active;
+        mutable SDL_SpinLock lock;
+    };
+}
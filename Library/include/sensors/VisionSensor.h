@@ -109,10 +109,12 @@ namespace sf
         
     protected:
         virtual void InitGraphics() = 0;
+        void PublishData(const void* data, size_t size);
         
     private:
         Entity* attach;
         Transform o2s;
+        uint64_t frameCount;
     };
 }
 
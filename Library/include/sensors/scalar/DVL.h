@@ -94,6 +94,10 @@ namespace sf
         ScalarSensorType getScalarSensorType() const override;
         
     private:
+        void QueueRays(RayQueryBatch& batch) override;
+        Vector3 getBeamDirection(const Transform& dvlTrans, unsigned int beam) const;
+        
+        size_t firstRay;
         Scalar beamAngle;
         bool beamPosZ;
         Scalar range[4];
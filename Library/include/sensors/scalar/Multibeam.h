@@ -73,6 +73,9 @@ namespace sf
         Scalar getAngleRange() const;
         
     private:
+        void QueueRays(RayQueryBatch& batch) override;
+        
+        size_t firstRay;
         Scalar angRange;
         unsigned int angSteps;
         std::vector<Scalar> angles;
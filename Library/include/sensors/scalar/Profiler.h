@@ -70,6 +70,9 @@ namespace sf
         ScalarSensorType getScalarSensorType() const override;
         
     private:
+        void QueueRays(RayQueryBatch& batch) override;
+        
+        size_t ray;
         Scalar angRange;
         unsigned int angSteps;
         unsigned int currentAngStep;
@@ -64,6 +64,37 @@ namespace sf
      \return a pointer to an allocated mesh structure
      */
     Mesh* LoadOBJ(const std::string& path, GLfloat scale);
+
+    //! A function returning the path of the preprocessed geometry file corresponding to a geometry file.
+    /*!
+     \param path a path to the geometry file (e.g. "hull.obj")
+     \return a path to the preprocessed geometry file (e.g. "hull.sfm")
+     */
+    std::string GetPreprocessedGeometryPath(const std::string& path);
+
+    //! A function to load geometry from a preprocessed geometry (SFM) file.
+    /*!
+     The file is memory mapped and the data is copied directly into the mesh structure, without parsing.
+     A refined mesh is used only if it was produced at the requested scale, otherwise the unrefined mesh
+     is scaled and refined when loading.
+     \param path a path to the file
+     \param scale a scale to apply to the data
+     \param refine the refinement threshold of the requested mesh (0 means the mesh was not refined)
+     \param sourcePath a path to the original geometry file; the data is rejected if the original changed after conversion ("" skips the check)
+     \param unitProps an optional output of the physical properties of the mesh, for zero thickness and unit density
+     \return a pointer to an allocated mesh structure (nullptr if the file is missing, outdated, corrupted or does not contain the requested mesh)
+     */
+    Mesh* LoadSFM(const std::string& path, GLfloat scale, GLfloat refine = 0.f, const std::string& sourcePath = "", MeshProperties* unitProps = nullptr);
+
+    //! A function to save preprocessed geometry to a SFM file.
+    /*!
+     \param path a path to the output file
+     \param sourcePath a path to the original geometry file, used to detect outdated data ("" if none)
+     \param meshes a list of meshes (in unit scale), each paired with the refinement threshold used to produce it (0 if not refined)
+     \param refineScale the scale of the geometry when the refined meshes were produced
+     \return success
+     */
+    bool SaveSFM(const std::string& path, const std::string& sourcePath, const std::vector<std::pair<GLfloat, const Mesh*>>& meshes, GLfloat refineScale = 1.f);
     
     //! A function to compute all physical properties of a mesh.
     /*!
@@ -88,6 +119,28 @@ namespace sf
      */
     MeshProperties ComputePhysicalProperties(const Mesh* mesh, Scalar thickness, Scalar density);
     
+    //! A function to compute a simplified convex hull of a mesh.
+    /*!
+     The exact hull is computed first and then rebuilt incrementally, always adding the hull vertex
+     farthest from the current approximation, until one of the limits is reached.
+     \param mesh a pointer to the mesh structure
+     \param maxVertices the maximum number of vertices of the simplified hull (0 means no limit)
+     \param tolerance the maximum distance of the exact hull vertices from the simplified hull [m]
+     \return a list of vertices of the simplified hull
+     */
+    std::vector<Vector3> ComputeConvexHull(const Mesh* mesh, unsigned int maxVertices, Scalar tolerance);
+
+    //! A function to create a decimated copy of a mesh.
+    /*!
+     Vertices are clustered on a uniform grid, with the cell size chosen to approach the requested number of faces.
+     The resulting faces have similar sizes. Clustering can tear the surface or make it non-manifold, so only
+     closed, manifold results are accepted, which keeps the volume integrals consistent.
+     \param mesh a pointer to the mesh structure
+     \param maxFaces the maximum number of faces of the decimated mesh
+     \return a pointer to a newly allocated mesh (nullptr if no closed, manifold decimation was found)
+     */
+    Mesh* DecimateMesh(const Mesh* mesh, size_t maxFaces);
+
     //! A function to compute inertial axis for a given moment of inertia.
     /*!
      \param I the inertia tensor
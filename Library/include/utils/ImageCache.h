@@ -0,0 +1,85 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ImageCache.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <string>
+
+namespace sf
+{
+    //! A class implementing a store of images decoded ahead of time.
+    /*!
+     Images can be decoded in parallel, before the objects using them are created, and then taken over
+     by the code that would otherwise decode them. Each prefetched image can be taken only once.
+     The vertical flip setting of the image loader has to be the same when decoding and using the image.
+     The store is thread safe.
+     */
+    class ImageCache
+    {
+    public:
+        //! A static method decoding an image and storing it in the cache.
+        /*!
+         \param path a path to the image file
+         \param channels the number of channels requested
+         \param wide a flag specifying if the image should be decoded with 16 bits per channel
+         \return success
+         */
+        static bool Prefetch(const std::string& path, int channels, bool wide = false);
+
+        //! A static method taking over a prefetched image.
+        /*!
+         \param path a path to the image file
+         \param channels the number of channels requested
+         \param wide a flag specifying if the image was decoded with 16 bits per channel
+         \param width output of the width of the image [px]
+         \param height output of the height of the image [px]
+         \param fileChannels output of the number of channels in the file
+         \return a pointer to the image data, to be released with stbi_image_free (nullptr if not prefetched)
+         */
+        static void* Take(const std::string& path, int channels, bool wide, int& width, int& height, int& fileChannels);
+
+        //! A static method checking if an image file stores 16 bits per channel.
+        /*!
+         \param path a path to the image file
+         \return is the image 16 bit?
+         */
+        static bool Is16Bit(const std::string& path);
+
+        //! A static method releasing all images that were not taken.
+        static void Clear();
+
+    private:
+        ImageCache() = delete;
+
+        struct Image
+        {
+            void* data;
+            int width;
+            int height;
+            int channels;
+        };
+        typedef std::tuple<std::string, int, bool> ImageKey;
+        static std::map<ImageKey, Image> images;
+    };
+}
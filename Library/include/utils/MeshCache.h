@@ -0,0 +1,96 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshCache.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <map>
+#include <tuple>
+#include "StonefishCommon.h"
+#include "utils/GeometryFileUtil.h"
+
+namespace sf
+{
+    //! A class implementing a process-wide cache of the meshes loaded from files.
+    /*!
+     Meshes are keyed on the file path, the scale and the processing applied after loading
+     (normal smoothing and refinement). The cached meshes are immutable and shared between all users,
+     so that scenarios containing many copies of the same model parse and process each file only once.
+     Physical properties and simplified convex hulls computed for a cached mesh are also stored.
+     If a preprocessed geometry (SFM) file, up to date with the original, exists next to it, it is loaded instead.
+     The cache is thread safe and it is cleared when the scenario is destroyed, so that modified files are reloaded.
+     */
+    class MeshCache
+    {
+    public:
+        //! A static method returning a processed mesh, loading it from file if not cached.
+        /*!
+         \param path a path to the geometry file
+         \param scale a scale to apply to the data
+         \param smooth a flag specifying if the normals should be smoothed
+         \param refine a threshold used to refine the mesh (0 means no refinement)
+         \return a shared pointer to the mesh (nullptr if loading failed)
+         */
+        static std::shared_ptr<const Mesh> Get(const std::string& path, GLfloat scale, bool smooth = false, GLfloat refine = 0.f);
+
+        //! A static method returning the physical properties of a cached mesh, computing them if not cached.
+        /*!
+         \param mesh a shared pointer to a mesh obtained from the cache
+         \param thickness a value of the wall thickness [m]
+         \param density the density of the material the mesh is made of [kg/m3]
+         \return a structure containing properties of the mesh
+         */
+        static MeshProperties GetPhysicalProperties(const std::shared_ptr<const Mesh>& mesh, Scalar thickness, Scalar density);
+
+        //! A static method returning a simplified convex hull of a cached mesh, computing it if not cached.
+        /*!
+         \param mesh a shared pointer to a mesh obtained from the cache
+         \param maxVertices the maximum number of vertices of the hull (0 means no limit)
+         \param tolerance the maximum distance of the exact hull from the simplified one [m]
+         \return a list of vertices of the hull
+         */
+        static std::vector<Vector3> GetConvexHull(const std::shared_ptr<const Mesh>& mesh, unsigned int maxVertices, Scalar tolerance);
+
+        //! A static method creating a modifiable copy of a mesh.
+        /*!
+         \param mesh a pointer to the mesh to copy
+         \return a pointer to a newly allocated mesh
+         */
+        static Mesh* Copy(const Mesh* mesh);
+
+        //! A static method returning the number of cached meshes.
+        static size_t getNumOfMeshes();
+
+        //! A static method removing all meshes and properties from the cache.
+        static void Clear();
+
+    private:
+        MeshCache() = delete;
+
+        typedef std::tuple<std::string, GLfloat, bool, GLfloat> MeshKey;
+        typedef std::tuple<const Mesh*, Scalar, Scalar> PropertiesKey;
+        typedef std::tuple<const Mesh*, unsigned int, Scalar> HullKey;
+        static std::map<MeshKey, std::shared_ptr<const Mesh>> meshes;
+        static std::map<PropertiesKey, std::pair<std::shared_ptr<const Mesh>, MeshProperties>> properties; //Keeps the mesh alive, so that the key stays unique
+        static std::map<HullKey, std::pair<std::shared_ptr<const Mesh>, std::vector<Vector3>>> hulls;
+        static std::map<const Mesh*, MeshProperties> unitProperties; //Read from preprocessed files (unit density, zero thickness)
+    };
+}
@@ -0,0 +1,89 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshSoA.h
+//  Stonefish
+//
+
+#pragma once
+
+#include "graphics/OpenGLDataStructs.h"
+
+namespace sf
+{
+    //! A structure holding a flat, structure-of-arrays copy of a mesh, used by the fluid dynamics kernels.
+    struct MeshSoA
+    {
+        std::vector<GLfloat> x; //!< X coordinates of vertices (padded to a multiple of 8)
+        std::vector<GLfloat> y; //!< Y coordinates of vertices (padded to a multiple of 8)
+        std::vector<GLfloat> z; //!< Z coordinates of vertices (padded to a multiple of 8)
+        std::vector<GLuint> faces; //!< Vertex indices, three per face
+        std::vector<GLfloat> cx; //!< X coordinates of face centroids (padded to a multiple of 8)
+        std::vector<GLfloat> cy; //!< Y coordinates of face centroids (padded to a multiple of 8)
+        std::vector<GLfloat> cz; //!< Z coordinates of face centroids (padded to a multiple of 8)
+        std::vector<GLfloat> nx; //!< X components of unit face normals (padded to a multiple of 8)
+        std::vector<GLfloat> ny; //!< Y components of unit face normals (padded to a multiple of 8)
+        std::vector<GLfloat> nz; //!< Z components of unit face normals (padded to a multiple of 8)
+        std::vector<GLfloat> area; //!< Face areas (padded with zeros to a multiple of 8)
+        size_t nVertices; //!< Number of actual vertices
+        
+        //! A constructor.
+        /*!
+         \param mesh a pointer to the source mesh
+         */
+        MeshSoA(const Mesh* mesh);
+        
+        //! A method returning the number of vertices.
+        size_t getNumOfVertices() const;
+        
+        //! A method returning the number of faces.
+        size_t getNumOfFaces() const;
+        
+        //! A method returning the size of the buffers needed to store transformed vertices.
+        size_t getPaddedSize() const;
+        
+        //! A method returning the size of the buffers needed to store per face data.
+        size_t getPaddedFacesSize() const;
+        
+        //! A method transforming all vertices (SIMD accelerated when available).
+        /*!
+         \param T the transformation matrix
+         \param tx a pointer to the output buffer for the X coordinates (at least getPaddedSize() elements)
+         \param ty a pointer to the output buffer for the Y coordinates (at least getPaddedSize() elements)
+         \param tz a pointer to the output buffer for the Z coordinates (at least getPaddedSize() elements)
+         */
+        void Transform(const glm::mat4& T, GLfloat* tx, GLfloat* ty, GLfloat* tz) const;
+        
+        //! A method computing the drag of a fully submerged mesh, in the mesh frame (SIMD accelerated when available).
+        /*!
+         The relative fluid velocity at a face centroid c is u - omega x c, where u is the constant flow
+         optionally increased by the per face flow. Torques are computed with respect to the mesh origin.
+         \param u the relative velocity of the fluid at the mesh origin [m/s]
+         \param omega the angular velocity of the mesh [rad/s]
+         \param ux a pointer to the X components of the per face flow (nullptr if the flow is uniform)
+         \param uy a pointer to the Y components of the per face flow (nullptr if the flow is uniform)
+         \param uz a pointer to the Z components of the per face flow (nullptr if the flow is uniform)
+         \param Fq output of the sum of quadratic drag terms
+         \param Tq output of the sum of quadratic drag moments
+         \param Ff output of the sum of skin friction terms
+         \param Tf output of the sum of skin friction moments
+         */
+        void SubmergedDrag(const glm::vec3& u, const glm::vec3& omega, const GLfloat* ux, const GLfloat* uy, const GLfloat* uz,
+                           glm::vec3& Fq, glm::vec3& Tq, glm::vec3& Ff, glm::vec3& Tf) const;
+    };
+}
@@ -0,0 +1,120 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Profiler.h
+//  Stonefish
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Profiling aliases
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_ZONE(name) sf::ProfilerZone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+
+namespace sf
+{
+    //! A structure holding a single profiled zone.
+    struct ProfilerEvent
+    {
+        const char* name; //!< Name of the zone (static string)
+        uint64_t start; //!< Start time [ns]
+        uint64_t duration; //!< Duration [ns]
+        uint32_t thread; //!< Index of the thread that executed the zone
+        uint32_t depth; //!< Nesting depth of the zone
+    };
+
+    //! A class implementing a low overhead, scoped-zone profiler.
+    /*!
+     Zones are recorded in a ring buffer owned by the thread that executed them, so that recording
+     does not require any locks. The buffer is allocated when the thread records its first zone
+     and released when the thread exits (together with the zones it has not yet collected). Zones can be nested.
+     When enabled, the profiler also captures the internal zones of the Bullet Physics library (broadphase,
+     narrowphase, constraint solver, etc.).
+     */
+    class Profiler
+    {
+    public:
+        //! A static method to enable or disable recording of zones.
+        /*!
+         Enabling installs the profiling hooks of Bullet Physics, while disabling restores the previous ones.
+         \param enabled a flag specifying if the zones should be recorded
+         */
+        static void setEnabled(bool enabled);
+
+        //! A static method informing if the zones are recorded.
+        static bool isEnabled();
+
+        //! A static method opening a zone in the calling thread.
+        /*!
+         \param name a name of the zone (has to be a static string)
+         */
+        static void BeginZone(const char* name);
+
+        //! A static method closing the last opened zone in the calling thread.
+        static void EndZone();
+
+        //! A static method returning a copy of all recorded zones.
+        /*!
+         \param lost an optional pointer to a variable that will store the number of zones overwritten before being collected
+         \return a list of zones from all threads, sorted by start time
+         */
+        static std::vector<ProfilerEvent> getEvents(uint64_t* lost = nullptr);
+
+        //! A static method discarding all recorded zones.
+        static void Clear();
+
+        //! A static method saving the recorded zones in the Chrome trace format (JSON).
+        /*!
+         The file can be opened in chrome://tracing or Perfetto.
+         \param path a path to the output file
+         \return success
+         */
+        static bool ExportChromeTrace(const std::string& path);
+
+    private:
+        Profiler() = delete;
+        struct ThreadBuffer;
+        struct ThreadBufferOwner;
+        static ThreadBuffer* getThreadBuffer(bool create);
+        static void ReleaseThreadBuffer(ThreadBuffer* tb);
+
+        static std::atomic<bool> enabled;
+        static std::atomic<uint32_t> threadCount;
+        static std::vector<ThreadBuffer*> buffers;
+    };
+
+    //! A class implementing a scoped profiler zone.
+    class ProfilerZone
+    {
+    public:
+        //! A constructor.
+        /*!
+         \param name a name of the zone (has to be a static string)
+         */
+        ProfilerZone(const char* name) { Profiler::BeginZone(name); }
+
+        //! A destructor.
+        ~ProfilerZone() { Profiler::EndZone(); }
+    };
+}
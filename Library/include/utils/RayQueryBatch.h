@@ -0,0 +1,134 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  RayQueryBatch.h
+//  Stonefish
+//
+
+#pragma once
+
+#include "StonefishCommon.h"
+
+class btSoftMultiBodyDynamicsWorld;
+class btCollisionObject;
+
+namespace sf
+{
+    //! A structure representing the result of a ray query.
+    struct RayHit
+    {
+        Scalar fraction;                  //!< Fraction of the ray length at which the first hit occurred (1 if no hit).
+        Vector3 normal;                   //!< Normal of the hit surface in the world frame.
+        const btCollisionObject* object;  //!< Collision object hit by the ray (nullptr if no hit).
+        
+        //! A method informing if the ray hit anything.
+        bool hasHit() const { return object != nullptr; }
+    };
+    
+    //! A class implementing a batch of ray queries, traced against the collision world in parallel.
+    /*!
+     Rays are added by the sensors during a simulation tick and traced together. Each ray traverses the broadphase
+     trees with its own stack (the broadphase ray test of Bullet shares one stack and cannot run concurrently)
+     and the objects beyond the closest hit found so far are skipped. Only the first hit of each ray is reported.
+     */
+    class RayQueryBatch
+    {
+    public:
+        //! A constructor.
+        RayQueryBatch();
+        
+        //! A method removing all rays and results from the batch.
+        void Clear();
+        
+        //! A method adding a ray, using the default filter of the sensors (hitting static, dynamic and colliding animated bodies).
+        /*!
+         \param from the start point of the ray in the world frame
+         \param to the end point of the ray in the world frame
+         \return an id of the ray in the batch
+         */
+        size_t Add(const Vector3& from, const Vector3& to);
+        
+        //! A method adding a ray.
+        /*!
+         \param from the start point of the ray in the world frame
+         \param to the end point of the ray in the world frame
+         \param group the collision group of the ray
+         \param mask the collision mask of the ray
+         \return an id of the ray in the batch
+         */
+        size_t Add(const Vector3& from, const Vector3& to, int group, int mask);
+        
+        //! A method tracing all rays in the batch.
+        /*!
+         Large batches are traced in parallel if the broadphase is a dynamic AABB tree, otherwise serially.
+         \param world a pointer to the collision world
+         */
+        void Execute(btSoftMultiBodyDynamicsWorld* world);
+        
+        //! A method returning the result of a ray query (valid after Execute).
+        /*!
+         \param id the id of the ray in the batch
+         \return the first hit of the ray
+         */
+        const RayHit& getResult(size_t id) const;
+        
+        //! A method returning the start point of a ray.
+        /*!
+         \param id the id of the ray in the batch
+         */
+        const Vector3& getFrom(size_t id) const;
+        
+        //! A method returning the end point of a ray.
+        /*!
+         \param id the id of the ray in the batch
+         */
+        const Vector3& getTo(size_t id) const;
+        
+        //! A method returning the point of the first hit of a ray (the end point if no hit).
+        /*!
+         \param id the id of the ray in the batch
+         */
+        Vector3 getHitPoint(size_t id) const;
+        
+        //! A method returning the number of rays in the batch.
+        size_t getSize() const;
+        
+        //! A static method tracing a single ray immediately.
+        /*!
+         \param world a pointer to the collision world
+         \param from the start point of the ray in the world frame
+         \param to the end point of the ray in the world frame
+         \return the first hit of the ray
+         */
+        static RayHit Cast(btSoftMultiBodyDynamicsWorld* world, const Vector3& from, const Vector3& to);
+        
+    private:
+        struct RayQuery
+        {
+            Vector3 from;
+            Vector3 to;
+            int group;
+            int mask;
+        };
+        
+        static void Trace(btSoftMultiBodyDynamicsWorld* world, const RayQuery& q, RayHit& hit);
+        
+        std::vector<RayQuery> queries;
+        std::vector<RayHit> results;
+    };
+}
@@ -21,24 +21,24 @@
 
 layout(location = 0) in vec3 vt;
 layout(location = 1) in vec3 n;
+layout(location = 4) in mat4 M; //Model matrix (per instance)
+layout(location = 8) in mat3 N; //Normal matrix (per instance)
 
 out vec3 normal;
 out vec4 fragPos;
 out vec3 eyeSpaceNormal;
 out float logz;
 
-uniform mat4 MVP;
-uniform mat4 M;
-uniform mat3 N;
-uniform mat3 MV;
+uniform mat4 VP;
+uniform mat3 VN;
 uniform float FC;
 
 void main()
 {
 	normal = normalize(N * n);
-	eyeSpaceNormal = normalize(MV * n);
+	eyeSpaceNormal = normalize(VN * N * n);
 	fragPos = M * vec4(vt, 1.0);
-	gl_Position = MVP * vec4(vt, 1.0); 
+	gl_Position = VP * fragPos; 
     gl_Position.z = log2(max(1e-6, 1.0 + gl_Position.w)) * 2.0 * FC - 1.0;
     logz = 1.0 + gl_Position.w;
 }
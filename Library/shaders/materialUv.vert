@@ -23,6 +23,8 @@ layout(location = 0) in vec3 vt;
 layout(location = 1) in vec3 n;
 layout(location = 2) in vec2 uv;
 layout(location = 3) in vec3 t;
+layout(location = 4) in mat4 M; //Model matrix (per instance)
+layout(location = 8) in mat3 N; //Normal matrix (per instance)
 
 out vec3 normal;
 out mat3 TBN;
@@ -31,10 +33,8 @@ out vec4 fragPos;
 out vec3 eyeSpaceNormal;
 out float logz;
 
-uniform mat4 MVP;
-uniform mat4 M;
-uniform mat3 N;
-uniform mat3 MV;
+uniform mat4 VP;
+uniform mat3 VN;
 uniform float FC;
 
 void main()
@@ -43,10 +43,10 @@ void main()
     vec3 tangent = normalize(N * t);
     vec3 bitangent = cross(normal, tangent);
     TBN = mat3(tangent, bitangent, normal);
-	eyeSpaceNormal = normalize(MV * n);
+	eyeSpaceNormal = normalize(VN * N * n);
 	texCoord = uv;
 	fragPos = M * vec4(vt, 1.0);
-	gl_Position = MVP * vec4(vt, 1.0); 
+	gl_Position = VP * fragPos; 
     gl_Position.z = log2(max(1e-6, 1.0 + gl_Position.w)) * 2.0 * FC - 1.0;
     logz = 1.0 + gl_Position.w;
 }
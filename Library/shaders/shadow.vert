@@ -20,9 +20,10 @@
 #version 330
 
 layout(location = 0) in vec3 vertex;
-uniform mat4 MVP;
+layout(location = 4) in mat4 M; //Model matrix (per instance)
+uniform mat4 VP;
 
 void main()
 {
-	gl_Position = MVP * vec4(vertex, 1.0);
+	gl_Position = VP * M * vec4(vertex, 1.0);
 }
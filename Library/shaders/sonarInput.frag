@@ -21,10 +21,10 @@
 
 in vec3 normal;
 in vec3 fragPos;
+flat in float restitution;
 layout(location = 0) out vec2 rangeIntensity;
 
 uniform vec3 eyePos;
-uniform float restitution;
 
 void main()
 {
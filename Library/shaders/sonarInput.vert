@@ -17,21 +17,35 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#version 330
+#version 430
+
+struct SonarObject
+{
+    mat4 M;
+    mat3 N;
+    float restitution;
+};
+
+layout(std430) buffer SonarObjects
+{
+    SonarObject objects[];
+};
 
 layout(location = 0) in vec3 vt;
 layout(location = 1) in vec3 n;
 
 out vec3 normal;
 out vec3 fragPos;
+flat out float restitution;
 
-uniform mat4 MVP;
-uniform mat4 M;
-uniform mat3 N;
+uniform mat4 VP;
+uniform uint objectIndex;
 
 void main()
 {
-	normal = normalize(N * n);
-	fragPos = (M * vec4(vt, 1.0)).xyz;
-    gl_Position = MVP * vec4(vt, 1.0); 
+    vec4 worldPos = objects[objectIndex].M * vec4(vt, 1.0);
+	normal = normalize(objects[objectIndex].N * n);
+	fragPos = worldPos.xyz;
+    restitution = objects[objectIndex].restitution;
+    gl_Position = VP * worldPos; 
 }
@@ -22,10 +22,10 @@
 in mat3 TBN;
 in vec2 texCoord;
 in vec3 fragPos;
+flat in float restitution;
 layout(location = 0) out vec2 rangeIntensity;
 
 uniform vec3 eyePos;
-uniform float restitution;
 uniform sampler2D texNormal;
 
 void main()
@@ -17,7 +17,19 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#version 330
+#version 430
+
+struct SonarObject
+{
+    mat4 M;
+    mat3 N;
+    float restitution;
+};
+
+layout(std430) buffer SonarObjects
+{
+    SonarObject objects[];
+};
 
 layout(location = 0) in vec3 vt;
 layout(location = 1) in vec3 n;
@@ -27,18 +39,21 @@ layout(location = 3) in vec3 t;
 out mat3 TBN;
 out vec2 texCoord;
 out vec3 fragPos;
+flat out float restitution;
 
-uniform mat4 MVP;
-uniform mat4 M;
-uniform mat3 N;
+uniform mat4 VP;
+uniform uint objectIndex;
 
 void main()
 {
+    mat3 N = objects[objectIndex].N;
+    vec4 worldPos = objects[objectIndex].M * vec4(vt, 1.0);
 	vec3 normal = normalize(N * n);
     vec3 tangent = normalize(N * t);
     vec3 bitangent = cross(normal, tangent);
     TBN = mat3(tangent, bitangent, normal);
 	texCoord = uv;
-	fragPos = (M * vec4(vt, 1.0)).xyz;
-    gl_Position = MVP * vec4(vt, 1.0); 
+	fragPos = worldPos.xyz;
+    restitution = objects[objectIndex].restitution;
+    gl_Position = VP * worldPos; 
 }
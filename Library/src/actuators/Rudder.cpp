@@ -188,6 +188,7 @@ std::vector<Renderable> Rudder::Render()
     Renderable item;
     item.type = RenderableType::SOLID;
     item.materialName = rudder->getMaterial().name;
+    item.materialId = rudder->getMaterial().id;
     item.objectId = rudder->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? rudder->getLook() : -1;
 	item.model = glMatrixFromTransform(rudderTrans);
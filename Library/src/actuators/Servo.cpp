@@ -97,6 +97,11 @@ void Servo::setMaxTorque(Scalar tau)
         fe->setMaxMotorForceTorque(jId, tauMax);
 }
 
+ServoControlMode Servo::getControlMode() const
+{
+    return mode;
+}
+
 Scalar Servo::getDesiredPosition() const
 {
     return pSetpoint;
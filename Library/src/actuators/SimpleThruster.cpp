@@ -153,6 +153,7 @@ std::vector<Renderable> SimpleThruster::Render()
     Renderable item;
     item.type = RenderableType::SOLID;
     item.materialName = propeller_->getMaterial().name;
+    item.materialId = propeller_->getMaterial().id;
     item.objectId = propeller_->getGraphicalObject();
     item.lookId = dm == DisplayMode::GRAPHICAL ? propeller_->getLook() : -1;
 	item.model = glMatrixFromTransform(thrustTrans);
@@ -27,6 +27,7 @@
 
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
+#include "utils/MeshCache.h"
 #include <algorithm>
 
 namespace sf 
@@ -45,11 +46,10 @@ VariableBuoyancy::VariableBuoyancy(std::string uniqueName, const std::vector<std
     
     for(size_t i=0; i<volumeMeshPaths.size(); ++i)
     {
-        Mesh* mesh = LoadGeometryFromFile(volumeMeshPaths[i], 1.f);
-        if(mesh == NULL)
+        std::shared_ptr<const Mesh> mesh = MeshCache::Get(volumeMeshPaths[i], 1.f);
+        if(mesh == nullptr)
             abort();
-        Vprops.push_back(ComputePhysicalProperties(mesh, Scalar(0), density));
-        delete mesh;
+        Vprops.push_back(MeshCache::GetPhysicalProperties(mesh, Scalar(0), density));
     }
     auto volumeCompare = [](MeshProperties& mp1, MeshProperties& mp2) { return mp1.volume < mp2.volume; };
     std::sort(Vprops.begin(), Vprops.end(), volumeCompare);
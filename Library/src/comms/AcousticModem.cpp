@@ -30,6 +30,7 @@
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLPipeline.h"
+#include "utils/RayQueryBatch.h"
 
 namespace sf
 {
@@ -102,11 +103,7 @@ bool AcousticModem::mutualContact(uint64_t device1Id, uint64_t device2Id)
         
     if(node1->getOcclusionTest() || node2->getOcclusionTest())
     {
-        btCollisionWorld::ClosestRayResultCallback closest(pos1, pos2);
-        closest.m_collisionFilterGroup = MASK_DYNAMIC;
-        closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-        SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(pos1, pos2, closest);
-        return !closest.hasHit();
+        return !RayQueryBatch::Cast(SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld(), pos1, pos2).hasHit();
     }
     else
         return true;
@@ -103,6 +103,7 @@ void ConsoleSimulationApp::StopSimulation()
 int ConsoleSimulationApp::RunSimulation(void* data)
 {
     ConsoleSimulationApp& simApp = static_cast<ConsoleSimulationThreadData*>(data)->app;
+    simApp.MakeCurrent();
     SimulationManager* simManager = simApp.getSimulationManager();
     simManager->setCallSimulationStepCompleted(simApp.timeStep_ == Scalar(0));
 
@@ -26,7 +26,6 @@
 #include "core/FilteredCollisionDispatcher.h"
 
 #include "BulletDynamics/Dynamics/btRigidBody.h"
-#include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "entities/SolidEntity.h"
 #include "sensors/Contact.h"
@@ -34,10 +33,26 @@
 namespace sf
 {
 
-FilteredCollisionDispatcher::FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, bool inclusiveMode) : btCollisionDispatcher(collisionConfiguration)
+static thread_local SimulationManager* dispatchingManager = nullptr;
+
+FilteredCollisionDispatcher::FilteredCollisionDispatcher(btCollisionConfiguration* collisionConfiguration, SimulationManager* sm, bool inclusiveMode) 
+    : CollisionDispatcherBase(collisionConfiguration)
 {
+    simManager = sm;
     inclusive = inclusiveMode;
-    // setNearCallback(myNearCallback);
+    setNearCallback(ManagerNearCallback);
+}
+
+SimulationManager* FilteredCollisionDispatcher::getDispatchingManager()
+{
+    return dispatchingManager;
+}
+
+void FilteredCollisionDispatcher::ManagerNearCallback(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
+{
+    //Pairs may be processed by worker threads, which do not know the world they work for
+    dispatchingManager = static_cast<FilteredCollisionDispatcher&>(dispatcher).simManager;
+    btCollisionDispatcher::defaultNearCallback(collisionPair, dispatcher, dispatchInfo);
 }
 
 bool FilteredCollisionDispatcher::needsCollision(const btCollisionObject* body0, const btCollisionObject* body1)
@@ -55,9 +70,9 @@ bool FilteredCollisionDispatcher::needsCollision(const btCollisionObject* body0,
         return false;
 
     if(inclusive)
-        needs = SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) > -1;
+        needs = simManager->CheckCollision(ent0, ent1) > -1;
     else //exclusive
-        needs = SimulationApp::getApp()->getSimulationManager()->CheckCollision(ent0, ent1) == -1;
+        needs = simManager->CheckCollision(ent0, ent1) == -1;
     
     return needs;
 }
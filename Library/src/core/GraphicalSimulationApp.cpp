@@ -1096,6 +1096,7 @@ int GraphicalSimulationApp::RenderLoadingScreen(void* data)
 int GraphicalSimulationApp::RunSimulation(void* data)
 {
     GraphicalSimulationApp& simApp = static_cast<GraphicalSimulationThreadData*>(data)->app;
+    simApp.MakeCurrent();
     SimulationManager* simManager = simApp.getSimulationManager();
 
     simManager->setCallSimulationStepCompleted(simApp.timeStep_ == Scalar(0));
@@ -43,7 +43,7 @@ void MaterialManager::ClearMaterialsAndFluids()
 {
     materials.clear();
     fluids.clear();
-    interactions.clear();
+    contactTable.clear();
     materialNameManager.ClearNames();
     fluidNameManager.ClearNames();
 }
@@ -56,28 +56,27 @@ std::string MaterialManager::CreateMaterial(const std::string& uniqueName, Scala
     mat.density = density;
     mat.restitution = restitution;
     mat.magnetic = magnetic;
+    mat.id = (int)materials.size();
     materials.push_back(mat);
     
-    cInfo("Material %s (%d) created.", mat.name.c_str(), materials.size()-1);
+    cInfo("Material %s (%d) created.", mat.name.c_str(), mat.id);
+    
+    //Grow contact table (keeping existing interactions)
+    size_t n = materials.size();
+    std::vector<ContactProperties> table(n * n);
+    for(size_t i=0; i < n-1; ++i)
+        for(size_t j=0; j < n-1; ++j)
+            table[i * n + j] = contactTable[i * (n-1) + j];
+    contactTable.swap(table);
     
     //Set initial friction coefficients
     Friction f;
     f.fStatic = Scalar(1);
     f.fDynamic = Scalar(1);
     
-    MaterialPair p;
-    p.mat1Id = (int)materials.size()-1;
-    
-    for(unsigned int i=0; i < materials.size(); ++i)
-    {
-        p.mat2Id = i;
-        interactions.insert({p,f});
-    }
+    for(size_t i=0; i < n; ++i)
+        UpdateContactProperties(mat.id, (int)i, f);
     
-    //Display interactions
-    //for(std::pair<MaterialPair, Friction> element : interactions)
-    //	std::cout << "(" << element.first.mat1Id << "," << element.first.mat2Id << ")" << std::endl;
-
     return mat.name;
 }
 
@@ -95,38 +94,43 @@ std::string MaterialManager::CreateFluid(const std::string& uniqueName, Scalar d
 
 bool MaterialManager::SetMaterialsInteraction(const std::string& firstMaterialName, const std::string& secondMaterialName, Scalar staticFricCoeff, Scalar dynamicFricCoeff)
 {
-    MaterialPair p;
-    p.mat1Id = getMaterialIndex(firstMaterialName);
-    p.mat2Id = getMaterialIndex(secondMaterialName);
+    int mat1Id = getMaterialIndex(firstMaterialName);
+    int mat2Id = getMaterialIndex(secondMaterialName);
     
-    Friction f;
-    f.fStatic = staticFricCoeff;
-    f.fDynamic = dynamicFricCoeff;
-    
-    try
-    {
-        interactions.at(p) = f;
-        return true;
-    }
-    catch(const std::out_of_range& e)
+    if(mat1Id < 0 || mat2Id < 0)
     {
         cError("Material pair (%s,%s) not found!", firstMaterialName.c_str(), secondMaterialName.c_str());
         return false;
     }
+    
+    Friction f;
+    f.fStatic = staticFricCoeff;
+    f.fDynamic = dynamicFricCoeff;
+    UpdateContactProperties(mat1Id, mat2Id, f);
+    return true;
+}
+
+void MaterialManager::UpdateContactProperties(int mat1Index, int mat2Index, Friction f)
+{
+    const Material& mat1 = materials[mat1Index];
+    const Material& mat2 = materials[mat2Index];
+    
+    ContactProperties cp;
+    cp.friction = f;
+    cp.restitution = mat1.restitution * mat2.restitution;
+    cp.magnetic = Scalar(0);
+    if((mat1.magnetic < Scalar(0) && mat2.magnetic > Scalar(0))
+        || (mat1.magnetic > Scalar(0) && mat2.magnetic < Scalar(0))) //No magnet-magnet support
+        cp.magnetic = btFabs(mat1.magnetic) * btFabs(mat2.magnetic) / Scalar(1e4);
+    
+    size_t n = materials.size();
+    contactTable[mat1Index * n + mat2Index] = cp;
+    contactTable[mat2Index * n + mat1Index] = cp;
 }
 
 Friction MaterialManager::GetMaterialsInteraction(int mat1Index, int mat2Index)
 {
-    MaterialPair p;
-    p.mat1Id = mat1Index;
-    p.mat2Id = mat2Index;
-        
-    try
-    {
-        Friction f = interactions.at(p);
-        return f;
-    }
-    catch(const std::out_of_range& e)
+    if(mat1Index < 0 || mat2Index < 0 || mat1Index >= (int)materials.size() || mat2Index >= (int)materials.size())
     {
         cError("Material pair (%d,%d) not found!", mat1Index, mat2Index);
         
@@ -136,6 +140,18 @@ Friction MaterialManager::GetMaterialsInteraction(int mat1Index, int mat2Index)
         
         return f;
     }
+    
+    return contactTable[mat1Index * materials.size() + mat2Index].friction;
+}
+
+const ContactProperties& MaterialManager::getContactProperties(int mat1Index, int mat2Index) const
+{
+    static const ContactProperties noContact = {{Scalar(0), Scalar(0)}, Scalar(0), Scalar(0)};
+    
+    if((unsigned int)mat1Index >= materials.size() || (unsigned int)mat2Index >= materials.size())
+        return noContact;
+    
+    return contactTable[mat1Index * materials.size() + mat2Index];
 }
 
 Friction MaterialManager::GetMaterialsInteraction(const std::string& mat1Name, const std::string& mat2Name)
@@ -90,8 +90,12 @@
 #include "joints/FixedJoint.h"
 #include "graphics/OpenGLDataStructs.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/MeshCache.h"
+#include "utils/ImageCache.h"
 #include "tinyexpr.h"
 #include <sstream>
+#include <functional>
+#include <unistd.h>
 
 namespace sf
 {
@@ -190,6 +194,9 @@ bool ScenarioParser::Parse(std::string filename)
         log.Print(MessageType::ERROR, "Materials not properly defined!");
         return false;
     }
+
+    //Load resources in parallel (taken over by the objects created below)
+    PrefetchResources(root);
     
     //Load looks (optional)
     if(isGraphicalSim())
@@ -357,6 +364,7 @@ bool ScenarioParser::Parse(std::string filename)
         element = element->NextSiblingElement("contact");
     }
     
+    ImageCache::Clear(); //Release images that were not used
     log.Print(MessageType::INFO, "Parsing finished normally.");
     return true;
 }
@@ -577,6 +585,153 @@ bool ScenarioParser::IncludeFiles(XMLNode* node)
     return true;
 }
 
+void ScenarioParser::PrefetchResources(XMLNode* node)
+{
+    enum class ResourceType {MESH, TEXTURE, HEIGHTMAP};
+    struct Resource
+    {
+        ResourceType type;
+        std::string path;
+        GLfloat scale;
+        GLfloat refine;
+        bool properties;
+        Scalar thickness;
+        Scalar density;
+    };
+    std::vector<Resource> resources;
+    
+    auto fileExists = [](const std::string& path) { return access(path.c_str(), R_OK) == 0; };
+    auto addMesh = [&](const std::string& path, Scalar scale, GLfloat refine, bool props, Scalar thickness, Scalar density)
+    {
+        if(fileExists(path))
+            resources.push_back(Resource{ResourceType::MESH, path, (GLfloat)scale, refine, props, thickness, density});
+    };
+    auto addImage = [&](ResourceType type, const char* path)
+    {
+        if(path == nullptr || path[0] == '\0')
+            return;
+        std::string fullPath = GetFullPath(std::string(path));
+        if(fileExists(fullPath))
+            resources.push_back(Resource{type, fullPath, 1.f, 0.f, false, Scalar(0), Scalar(0)});
+    };
+    
+    //Collect resources, using the same keys as the objects that will load them
+    std::function<void(XMLElement*)> collect = [&](XMLElement* element)
+    {
+        for(XMLElement* e = element->FirstChildElement(); e != nullptr; e = e->NextSiblingElement())
+        {
+            std::string name(e->Name());
+            const char* file = nullptr;
+            
+            if(name == "mesh" && e->QueryStringAttribute("filename", &file) == XML_SUCCESS && file[0] != '\0')
+            {
+                Scalar scale(1);
+                e->QueryAttribute("scale", &scale);
+                std::string path = GetFullPath(std::string(file));
+                std::string parent(element->Name());
+                
+                //Find the kind of the owner
+                std::string owner = "";
+                for(XMLNode* n = element; n != nullptr && n->ToElement() != nullptr; n = n->Parent())
+                {
+                    std::string on(n->ToElement()->Name());
+                    if(on == "static" || on == "animated" || on == "actuator")
+                    {
+                        owner = on;
+                        break;
+                    }
+                }
+                
+                if(owner == "static" || owner == "animated") //Obstacle, AnimatedEntity
+                    addMesh(path, scale, 0.f, false, Scalar(0), Scalar(0));
+                else if(owner == "actuator")
+                {
+                    if(parent == "volume") //VariableBuoyancy
+                    {
+                        Scalar density = sm->getOcean() != nullptr ? sm->getOcean()->getLiquid().density : Scalar(1000);
+                        addMesh(path, Scalar(1), 0.f, true, Scalar(0), density);
+                    }
+                    else //Propeller, rudder
+                        addMesh(path, scale, 3.f, false, Scalar(0), Scalar(0));
+                }
+                else if(parent == "physical") //Polyhedron
+                {
+                    Scalar thickness(-1);
+                    XMLElement* item;
+                    if((item = element->FirstChildElement("thickness")) != nullptr)
+                        item->QueryAttribute("value", &thickness);
+                    const char* mat = nullptr;
+                    XMLElement* solid = element->Parent()->ToElement();
+                    bool props = solid != nullptr && (item = solid->FirstChildElement("material")) != nullptr 
+                                 && item->QueryStringAttribute("name", &mat) == XML_SUCCESS;
+                    Scalar density = props ? sm->getMaterialManager()->getMaterial(std::string(mat)).density : Scalar(0);
+                    addMesh(path, scale, 3.f, props, thickness, density);
+                }
+                else
+                    addMesh(path, scale, 0.f, false, Scalar(0), Scalar(0));
+            }
+            else if(name == "visual" && isGraphicalSim() && e->QueryStringAttribute("filename", &file) == XML_SUCCESS && file[0] != '\0') //Sensor visual
+            {
+                Scalar scale(1);
+                e->QueryAttribute("scale", &scale);
+                addMesh(GetFullPath(std::string(file)), scale, 0.f, false, Scalar(0), Scalar(0));
+            }
+            else if(name == "look" && isGraphicalSim())
+            {
+                file = nullptr;
+                e->QueryStringAttribute("texture", &file);
+                addImage(ResourceType::TEXTURE, file);
+                file = nullptr;
+                e->QueryStringAttribute("normal_map", &file);
+                addImage(ResourceType::TEXTURE, file);
+                file = nullptr;
+                e->QueryStringAttribute("temperature_map", &file);
+                addImage(ResourceType::TEXTURE, file);
+            }
+            else if(name == "height_map" && e->QueryStringAttribute("filename", &file) == XML_SUCCESS)
+                addImage(ResourceType::HEIGHTMAP, file);
+            
+            collect(e);
+        }
+    };
+    ImageCache::Clear();
+    if(node->ToElement() == nullptr)
+        return;
+    collect(node->ToElement());
+    
+    if(resources.size() == 0)
+        return;
+    
+    //Load in parallel (the image loader flip setting is not changed, it is the same as when the objects are created)
+    int64_t start = GetTimeInMicroseconds();
+    SimulationApp* app = SimulationApp::getApp();
+    #pragma omp parallel for schedule(dynamic)
+    for(size_t i = 0; i < resources.size(); ++i)
+    {
+        app->MakeCurrent(); //Console output of the loaders
+        const Resource& r = resources[i];
+        switch(r.type)
+        {
+            case ResourceType::MESH:
+            {
+                std::shared_ptr<const Mesh> mesh = MeshCache::Get(r.path, r.scale, false, r.refine);
+                if(mesh != nullptr && r.properties)
+                    MeshCache::GetPhysicalProperties(mesh, r.thickness, r.density);
+            }
+                break;
+
+            case ResourceType::TEXTURE:
+                ImageCache::Prefetch(r.path, 3);
+                break;
+
+            case ResourceType::HEIGHTMAP:
+                ImageCache::Prefetch(r.path, 1, ImageCache::Is16Bit(r.path));
+                break;
+        }
+    }
+    log.Print(MessageType::INFO, "Prefetched %lu resources in %1.3lf s.", resources.size(), (GetTimeInMicroseconds() - start)/1e6);
+}
+
 bool ScenarioParser::ParseSolver(XMLElement* element)
 {
     XMLElement* item;
@@ -663,6 +818,17 @@ bool ScenarioParser::ParseEnvironment(XMLElement* element)
         sm->EnableOcean(wavesHeight, sm->getMaterialManager()->getFluid(waterName));
         sm->getOcean()->setWaterType(jerlov);
         sm->getOcean()->SetConditions(waterTemperature);
+
+        //Wave field used by the hydrodynamics
+        if((item = ocean->FirstChildElement("waves")) != nullptr && wavesHeight > Scalar(0))
+        {
+            unsigned int wavesResolution(256);
+            Scalar wavesRate(20);
+            item->QueryAttribute("resolution", &wavesResolution);
+            item->QueryAttribute("rate", &wavesRate);
+            if(wavesResolution != 256 || wavesRate != Scalar(20))
+                sm->getOcean()->ConfigureWaves(wavesResolution, wavesRate);
+        }
         
         //Particles
         bool particles = true;
@@ -1910,6 +2076,7 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
         Vector3 I;
         Vector3 Cf(-1,-1,-1);
         Vector3 Cd(-1,-1,-1);    
+        unsigned int hydroFaces = 0;
         bool cgok;
         unsigned int uvMode = 0;
         float uvScale = 1.f;
@@ -1953,6 +2120,7 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             if(item->QueryStringAttribute("quadratic_drag", &xyz) == XML_SUCCESS)
                 ParseVector(xyz, Cd);
             item->QueryBoolAttribute("compute_added_mass", &phy.estimateHydrodynamics);
+            item->QueryBoolAttribute("adaptive", &phy.adaptiveHydrodynamics);
             Scalar volOverride;
             if(item->QueryAttribute("volume", &volOverride) == XML_SUCCESS && volOverride > Scalar(0))
             {
@@ -1986,6 +2154,7 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
                 else
                     log.Print(MessageType::WARNING, "Hydrodynamics of rigid body '%s': failed to parse added inertia.", solidName.c_str());
             }
+            item->QueryAttribute("max_faces", &hydroFaces);
         } 
 
         //Origin    
@@ -2086,6 +2255,8 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             Scalar phyScale(1);
             Transform phyOrigin;
             Scalar thickness(-1);
+            int hullMaxVertices(-1);
+            Scalar hullTolerance(-1);
 
             if((item = element->FirstChildElement("physical")) == nullptr)
             {
@@ -2102,6 +2273,11 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             item2->QueryAttribute("scale", &phyScale);
             if((item2 = item->FirstChildElement("thickness")) != nullptr)
                 item2->QueryAttribute("value", &thickness);
+            if((item2 = item->FirstChildElement("hull")) != nullptr)
+            {
+                item2->QueryAttribute("max_vertices", &hullMaxVertices);
+                item2->QueryAttribute("tolerance", &hullTolerance);
+            }
             if((item2 = item->FirstChildElement("origin")) == nullptr || !ParseTransform(item2, phyOrigin))
             {
                 log.Print(MessageType::ERROR, "Physical mesh of rigid body '%s' not properly defined!", solidName.c_str());
@@ -2132,6 +2308,10 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             {
                 solid = new Polyhedron(solidName, phy, GetFullPath(std::string(phyMesh)), phyScale, phyOrigin, std::string(mat), std::string(look), thickness); 
             }
+            
+            if(hullMaxVertices >= 0 || hullTolerance >= Scalar(0))
+                ((Polyhedron*)solid)->setHullSimplification(hullMaxVertices >= 0 ? (unsigned int)hullMaxVertices : 0, 
+                                                             hullTolerance >= Scalar(0) ? hullTolerance : Scalar(0));
         }
         else
         {
@@ -2150,6 +2330,8 @@ bool ScenarioParser::ParseSolid(XMLElement* element, SolidEntity*& solid, std::s
             solid->SetArbitraryPhysicalProperties(newMass, newI, newCg);
         }
         solid->SetHydrodynamicCoefficients(Cd, Cf);
+        if(hydroFaces > 0)
+            solid->SetHydrodynamicsMeshFaces(hydroFaces);
     }
 
     //Contact properties (soft contact)
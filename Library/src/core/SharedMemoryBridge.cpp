@@ -0,0 +1,503 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SharedMemoryBridge.cpp
+//  Stonefish
+//
+
+#include "core/SharedMemoryBridge.h"
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "core/SimulationApp.h"
+#include "core/SimulationManager.h"
+#include "sensors/ScalarSensor.h"
+#include "sensors/vision/Camera.h"
+#include "actuators/Motor.h"
+#include "actuators/Servo.h"
+#include "actuators/Propeller.h"
+#include "actuators/Thruster.h"
+#include "actuators/SimpleThruster.h"
+#include "actuators/Rudder.h"
+#include "actuators/VariableBuoyancy.h"
+#include "actuators/SuctionCup.h"
+#include "actuators/Push.h"
+
+namespace sf
+{
+
+//Segment layout helpers (shared by the bridge and the client)
+static inline size_t ShmAlign(size_t size)
+{
+    return (size + 63) & ~(size_t)63; //Cache line
+}
+
+static inline size_t ShmSensorsOffset()
+{
+    return ShmAlign(sizeof(ShmHeader));
+}
+
+static inline size_t ShmActuatorsOffset(uint32_t nSensors)
+{
+    return ShmSensorsOffset() + ShmAlign(nSensors * sizeof(ShmSensorInfo));
+}
+
+static inline size_t ShmSlotOffset(uint64_t capacity, uint32_t slot)
+{
+    return ShmAlign(sizeof(ShmDataHeader)) + slot * ShmAlign(sizeof(ShmSlotHeader) + capacity);
+}
+
+static inline std::string ShmDataPath(const std::string& name, size_t index)
+{
+    return "/" + name + "." + std::to_string(index);
+}
+
+//Existing segments are never removed, as they may belong to another running simulator
+static void* ShmCreate(const std::string& path, size_t size)
+{
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600); //Accessible only to the user running the simulator
+    if(fd < 0)
+    {
+        if(errno == EEXIST)
+            cError("Shared memory '%s' already exists! Another simulator is using the name or it was not removed after a crash (delete '/dev/shm%s').", 
+                   path.c_str(), path.c_str());
+        return nullptr;
+    }
+    if(ftruncate(fd, (off_t)size) != 0)
+    {
+        close(fd);
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED)
+    {
+        shm_unlink(path.c_str());
+        return nullptr;
+    }
+    memset(mem, 0, size);
+    return mem;
+}
+
+static void* ShmOpen(const std::string& path, bool writable, size_t& size)
+{
+    int fd = shm_open(path.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if(fd < 0)
+        return nullptr;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    size = (size_t)st.st_size;
+    void* mem = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return mem == MAP_FAILED ? nullptr : mem;
+}
+
+static uint32_t SetpointSize(ActuatorType type)
+{
+    switch(type)
+    {
+        case ActuatorType::LIGHT:
+            return 0;
+        case ActuatorType::SIMPLE_THRUSTER:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+//Bridge
+SharedMemoryBridge::SharedMemoryBridge(const std::string& name_, SimulationManager* sm_) : name(name_), sm(sm_), mem(nullptr), memSize(0)
+{
+    std::vector<Sensor*> sensors;
+    for(unsigned int i=0; sm->getSensor(i) != nullptr; ++i)
+        sensors.push_back(sm->getSensor(i));
+    std::vector<Actuator*> actuators;
+    for(unsigned int i=0; sm->getActuator(i) != nullptr; ++i)
+        actuators.push_back(sm->getActuator(i));
+    
+    memSize = ShmActuatorsOffset((uint32_t)sensors.size()) + ShmAlign(actuators.size() * sizeof(ShmActuatorInfo));
+    mem = ShmCreate("/" + name, memSize);
+    if(mem == nullptr)
+    {
+        cError("Shared memory '/%s' could not be created!", name.c_str());
+        return;
+    }
+    
+    uint8_t* base = (uint8_t*)mem;
+    ShmHeader* header = (ShmHeader*)base;
+    header->version = SHM_VERSION;
+    header->nSensors = (uint32_t)sensors.size();
+    header->nActuators = (uint32_t)actuators.size();
+    
+    ShmSensorInfo* sInfo = (ShmSensorInfo*)(base + ShmSensorsOffset());
+    for(size_t i=0; i<sensors.size(); ++i)
+    {
+        strncpy(sInfo[i].name, sensors[i]->getName().c_str(), SHM_NAME_LENGTH-1);
+        sInfo[i].type = (uint32_t)sensors[i]->getType();
+        if(sensors[i]->getType() == SensorType::VISION)
+        {
+            VisionSensor* vs = (VisionSensor*)sensors[i];
+            sInfo[i].subtype = (uint32_t)vs->getVisionSensorType();
+            Camera* cam = dynamic_cast<Camera*>(vs);
+            if(cam != nullptr)
+                cam->getResolution(sInfo[i].width, sInfo[i].height);
+        }
+        else
+        {
+            ScalarSensor* ss = (ScalarSensor*)sensors[i];
+            sInfo[i].subtype = (uint32_t)ss->getScalarSensorType();
+            sInfo[i].channels = ss->getNumOfChannels();
+        }
+        
+        sensors[i]->getLatestData(); //Enable publishing of the data views
+        SensorSegment seg;
+        seg.mem = nullptr;
+        seg.memSize = 0;
+        seg.capacity = 0;
+        seg.lastSequence = 0;
+        seg.published = false;
+        segments.push_back(seg);
+    }
+    
+    ShmActuatorInfo* aInfo = (ShmActuatorInfo*)(base + ShmActuatorsOffset(header->nSensors));
+    for(size_t i=0; i<actuators.size(); ++i)
+    {
+        strncpy(aInfo[i].name, actuators[i]->getName().c_str(), SHM_NAME_LENGTH-1);
+        aInfo[i].type = (uint32_t)actuators[i]->getType();
+        aInfo[i].nValues = SetpointSize(actuators[i]->getType());
+    }
+    appliedSetpoints.resize(actuators.size(), 0);
+    
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SHM_MAGIC; //Mark segment as ready
+    cInfo("Shared memory bridge '/%s' created (%zu sensors, %zu actuators).", name.c_str(), sensors.size(), actuators.size());
+}
+
+SharedMemoryBridge::~SharedMemoryBridge()
+{
+    //Only the segments created by this bridge are mapped
+    for(size_t i=0; i<segments.size(); ++i)
+        if(segments[i].mem != nullptr)
+        {
+            munmap(segments[i].mem, segments[i].memSize);
+            shm_unlink(ShmDataPath(name, i).c_str());
+        }
+    
+    if(mem != nullptr)
+    {
+        munmap(mem, memSize);
+        shm_unlink(("/" + name).c_str());
+    }
+}
+
+bool SharedMemoryBridge::isOpen() const
+{
+    return mem != nullptr;
+}
+
+std::string SharedMemoryBridge::getName() const
+{
+    return name;
+}
+
+bool SharedMemoryBridge::CreateDataSegment(size_t index, size_t size)
+{
+    SensorSegment& seg = segments[index];
+    uint64_t capacity = std::max((uint64_t)ShmAlign(size), seg.capacity * 2); //Grow geometrically for variable size data
+    
+    if(seg.mem != nullptr) //Readers keep the old mapping until they notice the new generation
+    {
+        munmap(seg.mem, seg.memSize);
+        shm_unlink(ShmDataPath(name, index).c_str()); //Created by this bridge
+        seg.mem = nullptr;
+    }
+    
+    seg.memSize = ShmSlotOffset(capacity, 2);
+    seg.mem = ShmCreate(ShmDataPath(name, index), seg.memSize);
+    if(seg.mem == nullptr)
+    {
+        cError("Shared memory '%s' could not be created!", ShmDataPath(name, index).c_str());
+        seg.memSize = 0;
+        seg.capacity = 0;
+        return false;
+    }
+    seg.capacity = capacity;
+    ((ShmDataHeader*)seg.mem)->capacity = capacity;
+    
+    ShmSensorInfo* sInfo = (ShmSensorInfo*)((uint8_t*)mem + ShmSensorsOffset());
+    sInfo[index].generation.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+void SharedMemoryBridge::Publish(Scalar time)
+{
+    if(mem == nullptr)
+        return;
+    
+    for(size_t i=0; i<segments.size(); ++i)
+    {
+        std::shared_ptr<const SensorData> view = sm->getSensor((unsigned int)i)->getLatestData();
+        SensorSegment& seg = segments[i];
+        if(view == nullptr || (seg.published && view->sequence == seg.lastSequence))
+            continue;
+        
+        if(view->size > seg.capacity && !CreateDataSegment(i, view->size))
+            continue;
+        if(seg.mem == nullptr)
+            continue;
+        
+        //Write the slot not containing the latest measurement, under a sequence lock
+        ShmDataHeader* dh = (ShmDataHeader*)seg.mem;
+        uint32_t slot = seg.published ? dh->latest.load(std::memory_order_relaxed) ^ 1 : 0;
+        ShmSlotHeader* sh = (ShmSlotHeader*)((uint8_t*)seg.mem + ShmSlotOffset(seg.capacity, slot));
+        uint32_t lock = sh->lock.load(std::memory_order_relaxed);
+        sh->lock.store(lock + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        sh->sequence = view->sequence;
+        sh->timestamp = (double)view->timestamp;
+        sh->size = view->size;
+        memcpy((uint8_t*)sh + sizeof(ShmSlotHeader), view->data, view->size);
+        sh->lock.store(lock + 2, std::memory_order_release);
+        dh->latest.store(slot, std::memory_order_release);
+        
+        seg.lastSequence = view->sequence;
+        seg.published = true;
+    }
+    
+    ShmHeader* header = (ShmHeader*)mem;
+    header->time.store((double)time, std::memory_order_relaxed);
+    header->step.fetch_add(1, std::memory_order_release);
+}
+
+void SharedMemoryBridge::ApplySetpoints()
+{
+    if(mem == nullptr)
+        return;
+    
+    ShmHeader* header = (ShmHeader*)mem;
+    ShmActuatorInfo* aInfo = (ShmActuatorInfo*)((uint8_t*)mem + ShmActuatorsOffset(header->nSensors));
+    
+    for(size_t i=0; i<appliedSetpoints.size(); ++i)
+    {
+        uint64_t count = aInfo[i].count.load(std::memory_order_acquire);
+        if(count == appliedSetpoints[i] || aInfo[i].nValues == 0)
+            continue;
+        
+        //Read the setpoint under a sequence lock (retried in the next step if being written)
+        double v[SHM_MAX_SETPOINTS];
+        uint32_t lock = aInfo[i].lock.load(std::memory_order_acquire);
+        if(lock & 1)
+            continue;
+        memcpy(v, aInfo[i].values, sizeof(v));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(aInfo[i].lock.load(std::memory_order_relaxed) != lock)
+            continue;
+        appliedSetpoints[i] = count;
+        
+        Actuator* act = sm->getActuator((unsigned int)i);
+        switch(act->getType())
+        {
+            case ActuatorType::MOTOR:
+                ((Motor*)act)->setCommand(Scalar(v[0]));
+                break;
+                
+            case ActuatorType::SERVO:
+            {
+                Servo* srv = (Servo*)act;
+                if(srv->getControlMode() == ServoControlMode::POSITION)
+                    srv->setDesiredPosition(Scalar(v[0]));
+                else
+                    srv->setDesiredVelocity(Scalar(v[0]));
+            }
+                break;
+                
+            case ActuatorType::PROPELLER:
+                ((Propeller*)act)->setSetpoint(Scalar(v[0]));
+                break;
+                
+            case ActuatorType::THRUSTER:
+                ((Thruster*)act)->setSetpoint(Scalar(v[0]));
+                break;
+                
+            case ActuatorType::SIMPLE_THRUSTER:
+                ((SimpleThruster*)act)->setSetpoint(Scalar(v[0]), Scalar(v[1]));
+                break;
+                
+            case ActuatorType::RUDDER:
+                ((Rudder*)act)->setSetpoint(Scalar(v[0]));
+                break;
+                
+            case ActuatorType::VBS:
+                ((VariableBuoyancy*)act)->setFlowRate(Scalar(v[0]));
+                break;
+                
+            case ActuatorType::SUCTION_CUP:
+                ((SuctionCup*)act)->setPump(v[0] > 0.5);
+                break;
+                
+            case ActuatorType::PUSH:
+                ((Push*)act)->setForce(Scalar(v[0]));
+                break;
+                
+            default:
+                break;
+        }
+    }
+}
+
+//Client
+SharedMemoryClient::SharedMemoryClient() : mem(nullptr), memSize(0)
+{
+}
+
+SharedMemoryClient::~SharedMemoryClient()
+{
+    Close();
+}
+
+bool SharedMemoryClient::Open(const std::string& name_)
+{
+    Close();
+    mem = ShmOpen("/" + name_, true, memSize);
+    if(mem == nullptr)
+        return false;
+    
+    const ShmHeader* header = (const ShmHeader*)mem;
+    if(header->magic != SHM_MAGIC || header->version != SHM_VERSION
+       || memSize < ShmActuatorsOffset(header->nSensors) + header->nActuators * sizeof(ShmActuatorInfo))
+    {
+        Close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    
+    name = name_;
+    SensorMapping mp;
+    mp.mem = nullptr;
+    mp.memSize = 0;
+    mp.generation = 0;
+    mappings.resize(header->nSensors, mp);
+    return true;
+}
+
+void SharedMemoryClient::Close()
+{
+    for(size_t i=0; i<mappings.size(); ++i)
+        if(mappings[i].mem != nullptr)
+            munmap(mappings[i].mem, mappings[i].memSize);
+    mappings.clear();
+    
+    if(mem != nullptr)
+    {
+        munmap(mem, memSize);
+        mem = nullptr;
+        memSize = 0;
+    }
+}
+
+const ShmHeader* SharedMemoryClient::getHeader() const
+{
+    return (const ShmHeader*)mem;
+}
+
+const ShmSensorInfo* SharedMemoryClient::getSensorInfo(size_t index) const
+{
+    if(mem == nullptr || index >= mappings.size())
+        return nullptr;
+    return (const ShmSensorInfo*)((const uint8_t*)mem + ShmSensorsOffset()) + index;
+}
+
+const ShmActuatorInfo* SharedMemoryClient::getActuatorInfo(size_t index) const
+{
+    if(mem == nullptr || index >= getHeader()->nActuators)
+        return nullptr;
+    return (const ShmActuatorInfo*)((const uint8_t*)mem + ShmActuatorsOffset(getHeader()->nSensors)) + index;
+}
+
+bool SharedMemoryClient::ReadSensor(size_t index, std::vector<uint8_t>& data, uint64_t& sequence, double& timestamp)
+{
+    const ShmSensorInfo* info = getSensorInfo(index);
+    if(info == nullptr)
+        return false;
+    
+    //(Re)map the data segment if it was (re)created
+    SensorMapping& map = mappings[index];
+    uint32_t generation = info->generation.load(std::memory_order_acquire);
+    if(generation == 0)
+        return false;
+    if(generation != map.generation)
+    {
+        if(map.mem != nullptr)
+            munmap(map.mem, map.memSize);
+        map.mem = ShmOpen(ShmDataPath(name, index), false, map.memSize);
+        map.generation = map.mem != nullptr ? generation : 0;
+        if(map.mem == nullptr)
+            return false;
+    }
+    
+    const ShmDataHeader* dh = (const ShmDataHeader*)map.mem;
+    if(map.memSize < ShmSlotOffset(dh->capacity, 2))
+        return false;
+    
+    for(unsigned int t=0; t<16; ++t) //Retry if the slot was overwritten while copying
+    {
+        uint32_t slot = dh->latest.load(std::memory_order_acquire) & 1;
+        const ShmSlotHeader* sh = (const ShmSlotHeader*)((const uint8_t*)map.mem + ShmSlotOffset(dh->capacity, slot));
+        uint32_t lock = sh->lock.load(std::memory_order_acquire);
+        if(lock == 0 || (lock & 1))
+            continue;
+        uint64_t size = sh->size;
+        if(size > dh->capacity)
+            continue;
+        data.resize(size);
+        memcpy(data.data(), (const uint8_t*)sh + sizeof(ShmSlotHeader), size);
+        sequence = sh->sequence;
+        timestamp = sh->timestamp;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(sh->lock.load(std::memory_order_relaxed) == lock)
+            return true;
+    }
+    return false;
+}
+
+bool SharedMemoryClient::WriteSetpoint(size_t index, const double* values, size_t n)
+{
+    ShmActuatorInfo* info = (ShmActuatorInfo*)getActuatorInfo(index);
+    if(info == nullptr || n > SHM_MAX_SETPOINTS)
+        return false;
+    
+    uint32_t lock = info->lock.load(std::memory_order_relaxed);
+    info->lock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for(size_t i=0; i<n; ++i)
+        info->values[i] = values[i];
+    info->lock.store(lock + 2, std::memory_order_release);
+    info->count.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+}
@@ -32,10 +32,11 @@ namespace sf
 {
 
 SimulationApp::SimulationApp(std::string title, std::string dataDirPath, SimulationManager* sim)
-    : console_{new Console()}, startTime_{0}, autostep_{true}, timeStep_{Scalar(0)}, state_{SimulationState::NOT_READY},
+    : console_{new Console()}, startTime_{0}, autostep_{true}, timeStep_{Scalar(0)}, stepBatch_{1}, state_{SimulationState::NOT_READY},
       simManager_{sim}, title_{title}, dataPath_{dataDirPath}, physicsTime_{0.0}
 {
     SimulationApp::handle = this;
+    MakeCurrent();
 
     //Version info
     if(STONEFISH_VER_PATCH != 0)
@@ -48,6 +49,8 @@ SimulationApp::~SimulationApp()
 {
     if(SimulationApp::handle == this)
         SimulationApp::handle = nullptr;
+    if(SimulationApp::current == this)
+        SimulationApp::current = nullptr;
 }
 
 SimulationState SimulationApp::getState() const
@@ -80,6 +83,11 @@ Console* SimulationApp::getConsole()
     return console_;
 }
 
+void SimulationApp::MakeCurrent()
+{
+    SimulationApp::current = this;
+}
+
 void SimulationApp::Init()
 {
 }
@@ -98,6 +106,7 @@ void SimulationApp::Run(bool autostart, bool autostep, Scalar timeStep)
     autostep_ = autostep;
     timeStep_ = timeStep < Scalar(0) ? Scalar(0) : timeStep;
 
+    MakeCurrent();
     Init();
     if(autostart) StartSimulation();
 	Loop();
@@ -136,6 +145,10 @@ void SimulationApp::StepSimulation()
     {
         simManager_->AdvanceSimulation();
     }
+    else if (stepBatch_ > 1) // Batched fixed step simulation
+    {
+        simManager_->StepSimulationN(stepBatch_, timeStep_);
+    }
     else // Fixed step simulation
     {   
         simManager_->StepSimulation(timeStep_);
@@ -143,6 +156,16 @@ void SimulationApp::StepSimulation()
     }
 }
 
+void SimulationApp::setStepBatch(unsigned int n)
+{
+    stepBatch_ = n == 0 ? 1 : n;
+}
+
+unsigned int SimulationApp::getStepBatch() const
+{
+    return stepBatch_;
+}
+
 void SimulationApp::Quit()
 {
     state_ = SimulationState::FINISHED;
@@ -154,10 +177,11 @@ void SimulationApp::CleanUp()
 
 //Static
 SimulationApp* SimulationApp::handle = NULL;
+thread_local SimulationApp* SimulationApp::current = NULL;
 
 SimulationApp* SimulationApp::getApp()
 {
-    return SimulationApp::handle;
+    return SimulationApp::current != NULL ? SimulationApp::current : SimulationApp::handle;
 }
 
 }
@@ -39,12 +39,15 @@
 #include <typeinfo>
 #include <omp.h>
 #include <algorithm>
+#include "LinearMath/btThreads.h"
+#include "utils/Profiler.h"
 #include "core/FilteredCollisionDispatcher.h"
 #include "core/GraphicalSimulationApp.h"
 #include "core/NameManager.h"
 #include "core/MaterialManager.h"
 #include "core/Robot.h"
 #include "core/NED.h"
+#include "core/SharedMemoryBridge.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
@@ -53,6 +56,7 @@
 #include "utils/SystemUtil.hpp"
 #include "utils/UnitSystem.h"
 #include "utils/RayTest.hpp"
+#include "utils/MeshCache.h"
 #include "entities/Entity.h"
 #include "entities/CableEntity.h"
 #include "entities/FeatherstoneEntity.h"
@@ -78,6 +82,9 @@ extern ContactDestroyedCallback gContactDestroyedCallback;
 namespace sf
 {
 
+//Guards forces applied from the contact callback (narrowphase may run in parallel)
+static btSpinMutex contactForceMutex;
+
 SimulationManager::SimulationManager(Scalar stepsPerSecond, Solver st, CollisionFilter cft) 
     : perfMon(PerformanceMonitor(100))
 {
@@ -91,11 +98,14 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, Solver st, Collision
     linSleepThreshold = Scalar(0);
     angSleepThreshold = Scalar(0);
     fdCounter = 0;
+    fdAdaptive = false;
     currentTime = 0;
     timeOffset = 0;
     simulationTime = 0;
     mlcpFallbacks = 0;
     callSimulationStepCompleted = true;
+    batchSteps = 0;
+    batchStepsLeft = 0;
     dynamicsWorld = nullptr;
     mbSolver = nullptr;
     sbSolver = nullptr;
@@ -104,6 +114,7 @@ SimulationManager::SimulationManager(Scalar stepsPerSecond, Solver st, Collision
     dwDispatcher = nullptr;
     ocean = nullptr;
     atmosphere = nullptr;
+    shmBridge = nullptr;
     trackball = nullptr;
     sdm = DisplayMode::GRAPHICAL;
     simHydroMutex = SDL_CreateMutex();
@@ -174,6 +185,7 @@ void SimulationManager::AddSolidEntity(SolidEntity* ent, const Transform& origin
 {
     if(ent != nullptr)
     {
+        fdAdaptive |= ent->isHydrodynamicsAdaptive();
         entities.push_back(ent);
         ent->AddToSimulation(this, origin);
     }
@@ -197,6 +209,8 @@ void SimulationManager::AddFeatherstoneEntity(FeatherstoneEntity* ent, const Tra
 {
     if(ent != nullptr)
     {
+        for(unsigned int i=0; i<ent->getNumOfLinks(); ++i)
+            fdAdaptive |= ent->getLink(i).solid->isHydrodynamicsAdaptive();
         entities.push_back(ent);
         ent->AddToSimulation(this, origin);
     }
@@ -229,7 +243,7 @@ void SimulationManager::EnableOcean(Scalar waves, Fluid f)
     
     bool hasGraphics = SimulationApp::getApp()->hasGraphics();
 
-    ocean = new Ocean("Ocean", hasGraphics ? waves : 0.0, f);
+    ocean = new Ocean("Ocean", waves, f);
     ocean->AddToSimulation(this);
     
     if(hasGraphics)
@@ -257,6 +271,28 @@ void SimulationManager::EnableAtmosphere()
     }
 }
 
+void SimulationManager::EnableSharedMemoryBridge(const std::string& name)
+{
+    DisableSharedMemoryBridge();
+    shmName = name;
+    shmBridge = new SharedMemoryBridge(name, this);
+    if(!shmBridge->isOpen())
+    {
+        delete shmBridge;
+        shmBridge = nullptr;
+    }
+}
+
+void SimulationManager::DisableSharedMemoryBridge()
+{
+    if(shmBridge != nullptr)
+    {
+        delete shmBridge;
+        shmBridge = nullptr;
+    }
+    shmName = "";
+}
+
 void SimulationManager::AddSensor(Sensor* sens)
 {
     if(sens != nullptr)
@@ -309,49 +345,29 @@ void SimulationManager::AddContact(Contact* cnt)
 
 int SimulationManager::CheckCollision(const Entity *entA, const Entity *entB)
 {
-    for(size_t i = 0; i < collisions.size(); ++i)
-    {
-        if((collisions[i].A == entA && collisions[i].B == entB) 
-            || (collisions[i].B == entA && collisions[i].A == entB))
-                return (int)i;
-    }
-    
-    return -1;
+    if(collisions.empty())
+        return -1;
+    return collisions.find(Collision(entA, entB)) != collisions.end() ? 0 : -1;
 }
 
 void SimulationManager::EnableCollision(const Entity* entA, const Entity* entB)
 {
-    int colId = CheckCollision(entA, entB);
-    
-    if(collisionFilter == CollisionFilter::INCLUSIVE && colId == -1)
-    {
-        Collision c;
-        c.A = const_cast<Entity*>(entA);
-        c.B = const_cast<Entity*>(entB);
-        collisions.push_back(c);
-    }
-    else if(collisionFilter == CollisionFilter::EXCLUSIVE && colId > -1)
-    {
-        collisions.erase(collisions.begin() + colId);
-    }
+    if(collisionFilter == CollisionFilter::INCLUSIVE)
+        collisions.insert(Collision(entA, entB));
+    else //exclusive
+        collisions.erase(Collision(entA, entB));
 }
     
 void SimulationManager::DisableCollision(const Entity* entA, const Entity* entB)
 {
-    int colId = CheckCollision(entA, entB);
-    if(collisionFilter == CollisionFilter::EXCLUSIVE && colId == -1)
-    {
-        Collision c;
-        c.A = const_cast<Entity*>(entA);
-        c.B = const_cast<Entity*>(entB);
-        collisions.push_back(c);
-        cInfo("Disabling collisions between '%s' and '%s'.", entA->getName().c_str(), entB->getName().c_str());
-    }
-    else if(collisionFilter == CollisionFilter::INCLUSIVE && colId > -1)
-    {
-        collisions.erase(collisions.begin() + colId);
+    bool changed;
+    if(collisionFilter == CollisionFilter::EXCLUSIVE)
+        changed = collisions.insert(Collision(entA, entB)).second;
+    else //inclusive
+        changed = collisions.erase(Collision(entA, entB)) > 0;
+    
+    if(changed)
         cInfo("Disabling collisions between '%s' and '%s'.", entA->getName().c_str(), entB->getName().c_str());
-    }
 }
 
 Contact* SimulationManager::getContact(Entity* entA, Entity* entB)
@@ -512,6 +528,11 @@ Ocean* SimulationManager::getOcean()
     return ocean;
 }
 
+SharedMemoryBridge* SimulationManager::getSharedMemoryBridge()
+{
+    return shmBridge;
+}
+
 Atmosphere* SimulationManager::getAtmosphere()
 {
     return atmosphere;
@@ -745,13 +766,21 @@ void SimulationManager::InitializeSolver()
     switch(collisionFilter)
     {
         case CollisionFilter::INCLUSIVE:
-            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, true);
+            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, this, true);
             break;
 
         case CollisionFilter::EXCLUSIVE:
-            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, false);
+            dwDispatcher = new FilteredCollisionDispatcher(dwCollisionConfig, this, false);
             break;
     }
+
+    //Enable parallel collision dispatch (only available if Bullet was built thread-safe)
+    btITaskScheduler* scheduler = btGetOpenMPTaskScheduler();
+    if(scheduler != nullptr && btGetTaskScheduler() != scheduler)
+    {
+        scheduler->setNumThreadsUsed(scheduler->getMaxNumThreads());
+        btSetTaskScheduler(scheduler);
+    }
     
     //Choose constraint solver
     if(solver == Solver::SI)
@@ -879,6 +908,9 @@ void SimulationManager::RestartScenario()
     InitializeScenario();
     BuildScenario(); //Defined by specific application
     
+    if(!shmName.empty() && shmBridge == nullptr) //Recreate the bridge for the new sensors and actuators
+        EnableSharedMemoryBridge(shmName);
+    
     if(SimulationApp::getApp()->hasGraphics())
     {    
         if(isOceanEnabled())
@@ -892,6 +924,12 @@ void SimulationManager::RestartScenario()
 
 void SimulationManager::DestroyScenario()
 {
+    if(shmBridge != nullptr) //The bridge references the sensors and actuators (name is kept for restart)
+    {
+        delete shmBridge;
+        shmBridge = nullptr;
+    }
+    
     if(dynamicsWorld != nullptr)
     {
         //remove objects from dynamic world
@@ -929,6 +967,7 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<entities.size(); ++i)
         delete entities[i];
     entities.clear();
+    fdAdaptive = false;
     
     if(ocean != nullptr)
     {
@@ -949,6 +988,7 @@ void SimulationManager::DestroyScenario()
     for(size_t i=0; i<contacts.size(); ++i)
         delete contacts[i];
     contacts.clear();
+    collisions.clear();
     
     for(size_t i=0; i<sensors.size(); ++i)
         delete sensors[i];
@@ -967,6 +1007,8 @@ void SimulationManager::DestroyScenario()
         
     if(materialManager != nullptr)
         materialManager->ClearMaterialsAndFluids();
+    
+    MeshCache::Clear(); //Geometry files may change before the next scenario is built
 
     if(SimulationApp::getApp() != nullptr && SimulationApp::getApp()->hasGraphics())
 	{
@@ -1115,6 +1157,41 @@ void SimulationManager::StepSimulation(Scalar timeStep)
     perfMon.PhysicsFinished();
     SDL_UnlockMutex(simSettingsMutex);
 
+    CheckMLCPFallbacks();
+}
+
+//Bullet keeps the time that was not integrated yet in a protected member
+struct WorldLocalTime : public btDiscreteDynamicsWorld
+{
+    static Scalar get(const btDiscreteDynamicsWorld* world) { return world->*(&WorldLocalTime::m_localTime); }
+};
+
+void SimulationManager::StepSimulationN(unsigned int n, Scalar timeStep)
+{
+    if(n == 0 || timeStep <= Scalar(0))
+        return;
+
+    //Integrate with the fixed step of the manager, like StepSimulation
+    Scalar fixedStep = (Scalar)ssus/Scalar(1000000.0);
+    Scalar batchTime = Scalar(n) * timeStep;
+    int maxSubSteps = (int)btCeil(batchTime/fixedStep) + 1;
+
+    SDL_LockMutex(simSettingsMutex);
+    //Number of internal steps, computed the same way as in Bullet (the post-tick reports the last one)
+    Scalar localTime = WorldLocalTime::get(dynamicsWorld) + batchTime;
+    batchSteps = localTime >= fixedStep ? (unsigned int)btMin((int)(localTime/fixedStep), maxSubSteps) : 0;
+    batchStepsLeft = batchSteps;
+    perfMon.PhysicsStarted();
+    dynamicsWorld->stepSimulation(batchTime, maxSubSteps, fixedStep);
+    perfMon.PhysicsFinished();
+    batchStepsLeft = 0;
+    SDL_UnlockMutex(simSettingsMutex);
+
+    CheckMLCPFallbacks();
+}
+
+void SimulationManager::CheckMLCPFallbacks()
+{
     //Inform about MLCP failures
     if(solver != Solver::SI)
     {
@@ -1246,11 +1323,16 @@ std::string SimulationManager::CreateLook(const std::string& name, Color color,
 bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	const btCollisionObjectWrapper* colObj0Wrap,int partId0,int index0,const btCollisionObjectWrapper* colObj1Wrap,int partId1,int index1)
 {
     //Retrieve entities associated with colliding objects
-    Entity* ent0 = (Entity*)colObj0Wrap->getCollisionObject()->getUserPointer();
-    Entity* ent1 = (Entity*)colObj1Wrap->getCollisionObject()->getUserPointer();
+    const btCollisionObject* co0 = colObj0Wrap->getCollisionObject();
+    const btCollisionObject* co1 = colObj1Wrap->getCollisionObject();
+    Entity* ent0 = (Entity*)co0->getUserPointer();
+    Entity* ent1 = (Entity*)co1->getUserPointer();
+    
+    //Get the manager of the world from the dispatcher (the callback may run in a worker thread)
+    SimulationManager* sm = FilteredCollisionDispatcher::getDispatchingManager();
     
     //Check if entities are real
-    if(ent0 == nullptr || ent1 == nullptr)
+    if(ent0 == nullptr || ent1 == nullptr || sm == nullptr)
     {
         cp.m_combinedFriction = Scalar(0.);
         cp.m_combinedRollingFriction = Scalar(0.);
@@ -1259,26 +1341,28 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     }
     
     //Get material and contact velocity information
-    MaterialManager* mm = SimulationApp::getApp()->getSimulationManager()->getMaterialManager();
-    
-    Material mat0;
+    int matId0 = co0->getUserIndex(); //Material id cached on the collision object (-1 for compounds)
     Vector3 contactVelocity0;
     Scalar contactAngularVelocity0;
+    EntityType type0 = ent0->getType();
     
-    if(ent0->getType() == EntityType::STATIC)
+    if(type0 == EntityType::STATIC)
     {
-        StaticEntity* sent0 = (StaticEntity*)ent0;
-        mat0 = sent0->getMaterial();
+        if(matId0 < 0)
+            matId0 = ((StaticEntity*)ent0)->getMaterial().id;
         contactVelocity0.setZero();
         contactAngularVelocity0 = Scalar(0);
     }
-    else if(ent0->getType() == EntityType::SOLID)
+    else if(type0 == EntityType::SOLID)
     {
         SolidEntity* sent0 = (SolidEntity*)ent0;
-        if(sent0->getSolidType() == SolidType::COMPOUND)
-            mat0 = ((Compound*)sent0)->getMaterial(((Compound*)sent0)->getPartId(index0));
-        else
-            mat0 = sent0->getMaterial();
+        if(matId0 < 0)
+        {
+            if(sent0->getSolidType() == SolidType::COMPOUND)
+                matId0 = ((Compound*)sent0)->getMaterialId(((Compound*)sent0)->getPartId(index0));
+            else
+                matId0 = sent0->getMaterial().id;
+        }
         //Vector3 localPoint0 = sent0->getTransform().getBasis() * cp.m_localPointA;
         Vector3 localPoint0 = sent0->getCGTransform().inverse() * cp.getPositionWorldOnA();
         contactVelocity0 = sent0->getLinearVelocityInLocalPoint(localPoint0);
@@ -1292,24 +1376,28 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
         return true;
     }
     
-    Material mat1;
+    int matId1 = co1->getUserIndex(); //Material id cached on the collision object (-1 for compounds)
     Vector3 contactVelocity1;
     Scalar contactAngularVelocity1;
+    EntityType type1 = ent1->getType();
     
-    if(ent1->getType() == EntityType::STATIC)
+    if(type1 == EntityType::STATIC)
     {
-        StaticEntity* sent1 = (StaticEntity*)ent1;
-        mat1 = sent1->getMaterial();
+        if(matId1 < 0)
+            matId1 = ((StaticEntity*)ent1)->getMaterial().id;
         contactVelocity1.setZero();
         contactAngularVelocity1 = Scalar(0);
     }
-    else if(ent1->getType() == EntityType::SOLID)
+    else if(type1 == EntityType::SOLID)
     {
         SolidEntity* sent1 = (SolidEntity*)ent1;
-        if(sent1->getSolidType() == SolidType::COMPOUND)
-            mat1 = ((Compound*)sent1)->getMaterial(((Compound*)sent1)->getPartId(index1));
-        else
-            mat1 = sent1->getMaterial();
+        if(matId1 < 0)
+        {
+            if(sent1->getSolidType() == SolidType::COMPOUND)
+                matId1 = ((Compound*)sent1)->getMaterialId(((Compound*)sent1)->getPartId(index1));
+            else
+                matId1 = sent1->getMaterial().id;
+        }
         //Vector3 localPoint1 = sent1->getTransform().getBasis() * cp.m_localPointB;
         Vector3 localPoint1 = sent1->getCGTransform().inverse() * cp.getPositionWorldOnB();
         contactVelocity1 = sent1->getLinearVelocityInLocalPoint(localPoint1);
@@ -1323,6 +1411,9 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
         return true;
     }
 
+    //Precomputed properties of the material pair
+    const ContactProperties& props = sm->getMaterialManager()->getContactProperties(matId0, matId1);
+
     //Calculate contact forces
     //A. Stribeck friction model
     Vector3 relLocalVel = contactVelocity1 - contactVelocity0;
@@ -1330,8 +1421,7 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     Vector3 slipVel = relLocalVel - normalVel;
     Scalar sigma = 1000;
     // f = (static - dynamic)/(sigma * v^2 + 1) + dynamic
-    Friction f = mm->GetMaterialsInteraction(mat0.name, mat1.name);
-    cp.m_combinedFriction = (f.fStatic - f.fDynamic)/(sigma * slipVel.length2() + Scalar(1)) + f.fDynamic;
+    cp.m_combinedFriction = (props.friction.fStatic - props.friction.fDynamic)/(sigma * slipVel.length2() + Scalar(1)) + props.friction.fDynamic;
     
     //Rolling friction not possible to generalize - needs special treatment
     cp.m_combinedRollingFriction = Scalar(0);
@@ -1349,40 +1439,43 @@ bool SimulationManager::CustomMaterialCombinerCallback(btManifoldPoint& cp,	cons
     Scalar relAngularVelocity10 = contactAngularVelocity1 - contactAngularVelocity0;
     
     //calculate contact normal force and friction torque
-    Scalar normalForce = cp.m_appliedImpulse * SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond();
+    Scalar normalForce = cp.m_appliedImpulse * sm->getStepsPerSecond();
     Scalar T = cp.m_combinedFriction * normalForce * 0.002;
 
     //apply damping torque
-    if(ent0->getType() == EntityType::SOLID && !btFuzzyZero(relAngularVelocity01))
+    btMutexLock(&contactForceMutex);
+    if(type0 == EntityType::SOLID && !btFuzzyZero(relAngularVelocity01))
         ((SolidEntity*)ent0)->ApplyTorque(cp.m_normalWorldOnB * relAngularVelocity01/btFabs(relAngularVelocity01) * T);
     
-    if(ent1->getType() == EntityType::SOLID && !btFuzzyZero(relAngularVelocity10))
+    if(type1 == EntityType::SOLID && !btFuzzyZero(relAngularVelocity10))
         ((SolidEntity*)ent1)->ApplyTorque(cp.m_normalWorldOnB * relAngularVelocity10/btFabs(relAngularVelocity10) * T);
+    btMutexUnlock(&contactForceMutex);
     
     //Restitution
-    cp.m_combinedRestitution = mat0.restitution * mat1.restitution;
+    cp.m_combinedRestitution = props.restitution;
     
     //B. Magnetic attraction (only between magnet and ferromagnetic body, no magnet-magnet support)
-    if((mat0.magnetic < Scalar(0) && mat1.magnetic > Scalar(0))
-        || (mat0.magnetic > Scalar(0) && mat1.magnetic < Scalar(0)))
+    if(props.magnetic > Scalar(0))
     {
         Scalar d = btClamped(cp.getDistance(), Scalar(0.0001), BT_LARGE_FLOAT);
-        Scalar mag = (btFabs(mat0.magnetic) * btFabs(mat1.magnetic))/(d*d)/Scalar(1e4);
+        Scalar mag = props.magnetic/(d*d);
         btClamp(mag, Scalar(0), Scalar(10000)); //Arbitrary limit of 10kN
         Vector3 mForce = cp.m_normalWorldOnB * mag;
 
-        if(ent0->getType() == EntityType::SOLID)
+        btMutexLock(&contactForceMutex);
+        if(type0 == EntityType::SOLID)
         {
             SolidEntity* sent0 = (SolidEntity*)ent0;
             sent0->ApplyCentralForce(-mForce);
             sent0->ApplyTorque((cp.m_positionWorldOnA - sent0->getCGTransform().getOrigin()).cross(-mForce));
         }
-        if(ent1->getType() == EntityType::SOLID)
+        if(type1 == EntityType::SOLID)
         {
             SolidEntity* sent1 = (SolidEntity*)ent1;
             sent1->ApplyCentralForce(mForce);
             sent1->ApplyTorque((cp.m_positionWorldOnB - sent1->getCGTransform().getOrigin()).cross(mForce));
         }
+        btMutexUnlock(&contactForceMutex);
 
         cp.m_combinedRestitution = Scalar(0); //Allows sticking of bodies together
     }
@@ -1514,21 +1607,37 @@ void SimulationManager::SolveICTickCallback(btDynamicsWorld* world, Scalar timeS
 //Used to apply and accumulate forces
 void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar timeStep)
 {
+    PROFILE_ZONE("Tick");
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
     btSoftMultiBodyDynamicsWorld* dynamicsWorld = static_cast<btSoftMultiBodyDynamicsWorld*>(world);
         
     //Clear all forces to ensure that no summing occurs
     dynamicsWorld->clearForces(); //Includes clearing of multibody forces!
+
+    //Advance the wave field used by the hydrodynamics
+    if(simManager->ocean != nullptr)
+    {
+        Profiler::BeginZone("Waves");
+        simManager->ocean->UpdateWaves(timeStep);
+        Profiler::EndZone();
+    }
         
     //loop through all actuators -> apply forces to bodies (free and connected by joints)
+    Profiler::BeginZone("Actuators");
+    if(simManager->shmBridge != nullptr)
+        simManager->shmBridge->ApplySetpoints();
     for(size_t i = 0; i < simManager->actuators.size(); ++i)
         simManager->actuators[i]->Update(timeStep);
+    Profiler::EndZone();
     
     //loop through all joints -> apply damping forces to bodies connected by joints
+    Profiler::BeginZone("Joint damping");
     for(size_t i = 0; i < simManager->joints.size(); ++i)
         simManager->joints[i]->ApplyDamping();
+    Profiler::EndZone();
     
-    //loop through all entities that may need special actions
+    //loop through all entities that may need special actions (gravity, multibody damping, triggers)
+    Profiler::BeginZone("Gravity and triggers");
     for(size_t i = 0; i < simManager->entities.size(); ++i)
     {
         Entity* ent = simManager->entities[i];
@@ -1577,34 +1686,42 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
             }
         }
     }
+    Profiler::EndZone();
     
     //Geometry-based forces
     bool recompute = simManager->fdCounter % simManager->fdPrescaler == 0;
     ++simManager->fdCounter;
+    SimulationApp* app = SimulationApp::getApp();
     
     //Aerodynamic forces
     if(simManager->atmosphere != nullptr)
     {
+        PROFILE_ZONE("Aerodynamics");
         btBroadphasePairArray& pairArray = simManager->atmosphere->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
         int numPairs = pairArray.size();
         
         if(numPairs > 0)
         {
-            #pragma omp parallel for schedule(dynamic)
-            for(int h=0; h<numPairs; ++h)
+            #pragma omp parallel
             {
-                const btBroadphasePair& pair = pairArray[h];
-                btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                if (!colPair)
-                    continue;
-                    
-                btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
+                app->MakeCurrent(); //Worker threads have to see the application owning this world
                 
-                if(co1 == simManager->atmosphere->getGhost())
-                    simManager->atmosphere->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
-                    simManager->atmosphere->ApplyFluidForces(world, co1, recompute);
+                #pragma omp for schedule(dynamic)
+                for(int h=0; h<numPairs; ++h)
+                {
+                    const btBroadphasePair& pair = pairArray[h];
+                    btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
+                    if (!colPair)
+                        continue;
+                        
+                    btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
+                    btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
+                    
+                    if(co1 == simManager->atmosphere->getGhost())
+                        simManager->atmosphere->ApplyFluidForces(world, co2, recompute);
+                    else if(co2 == simManager->ocean->getGhost())
+                        simManager->atmosphere->ApplyFluidForces(world, co1, recompute);
+                }
             }
         }
     }
@@ -1612,7 +1729,10 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
     //Hydrodynamic forces
     if(simManager->ocean != nullptr)
     {
-        if(recompute) SDL_LockMutex(simManager->simHydroMutex);
+        PROFILE_ZONE("Hydrodynamics");
+        bool lock = recompute || simManager->fdAdaptive; //Bodies with adaptive update may recompute in any step
+        if(lock)
+            SDL_LockMutex(simManager->simHydroMutex);
         simManager->perfMon.HydrodynamicsStarted();
         
         btBroadphasePairArray& pairArray = simManager->ocean->getGhost()->getOverlappingPairCache()->getOverlappingPairArray();
@@ -1620,35 +1740,43 @@ void SimulationManager::SimulationTickCallback(btDynamicsWorld* world, Scalar ti
         
         if(numPairs > 0)
         {
-            #pragma omp parallel for schedule(dynamic)
-            for(int h=0; h<numPairs; ++h)
+            #pragma omp parallel
             {
-                const btBroadphasePair& pair = pairArray[h];
-                btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
-                if (!colPair)
-                    continue;
+                app->MakeCurrent(); //Worker threads have to see the application owning this world
+
+                #pragma omp for schedule(dynamic)
+                for(int h=0; h<numPairs; ++h)
+                {
+                    const btBroadphasePair& pair = pairArray[h];
+                    btBroadphasePair* colPair = world->getPairCache()->findPair(pair.m_pProxy0, pair.m_pProxy1);
+                    if (!colPair)
+                        continue;
+                        
+                    btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
+                    btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
                     
-                btCollisionObject* co1 = (btCollisionObject*)colPair->m_pProxy0->m_clientObject;
-                btCollisionObject* co2 = (btCollisionObject*)colPair->m_pProxy1->m_clientObject;
-                
-                if(co1 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co2, recompute);
-                else if(co2 == simManager->ocean->getGhost())
-                    simManager->ocean->ApplyFluidForces(world, co1, recompute);
+                    if(co1 == simManager->ocean->getGhost())
+                        simManager->ocean->ApplyFluidForces(world, co2, recompute);
+                    else if(co2 == simManager->ocean->getGhost())
+                        simManager->ocean->ApplyFluidForces(world, co1, recompute);
+                }
             }
         }
         
         simManager->perfMon.HydrodynamicsFinished();
-        if(recompute) SDL_UnlockMutex(simManager->simHydroMutex);
+        if(lock)
+            SDL_UnlockMutex(simManager->simHydroMutex);
     }
 }
 
 //Used to measure body motions and calculate controls
 void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scalar timeStep)
 {
+    PROFILE_ZONE("Post-tick");
     SimulationManager* simManager = (SimulationManager*)world->getWorldUserInfo();
     
     //Update motion data
+    Profiler::BeginZone("Motion data");
     for(size_t i = 0; i < simManager->entities.size(); ++i)
     {
         Entity* ent = simManager->entities[i];
@@ -1674,22 +1802,41 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
     for(size_t i = 0; i < simManager->actuators.size(); ++i)
         if(simManager->actuators[i]->getType() == ActuatorType::SUCTION_CUP)
             ((SuctionCup*)simManager->actuators[i])->Engage(simManager);
+    Profiler::EndZone();
 
     //Loop through all sensors -> update measurements
+    Profiler::BeginZone("Sensors");
+    simManager->rayQueries.Clear();
+    simManager->dueSensors.clear();
     for(size_t i = 0; i < simManager->sensors.size(); ++i)
-        simManager->sensors[i]->Update(timeStep);
+        if(simManager->sensors[i]->PrepareUpdate(timeStep, &simManager->rayQueries))
+            simManager->dueSensors.push_back(simManager->sensors[i]);
+    
+    //Trace rays of all sensors in one batch
+    if(simManager->rayQueries.getSize() > 0)
+    {
+        PROFILE_ZONE("Ray queries");
+        simManager->rayQueries.Execute(simManager->dynamicsWorld);
+    }
+    
+    for(size_t i = 0; i < simManager->dueSensors.size(); ++i)
+        simManager->dueSensors[i]->FinishUpdate();
+    Profiler::EndZone();
         
     //Loop through all comms -> update state and measurements
+    Profiler::BeginZone("Comms");
     for(size_t i = 0; i < simManager->comms.size(); ++i)
         simManager->comms[i]->Update(timeStep);
     
     // Loop through all comms again to process messages (there can be a cross-influence between updates)
     for(size_t i = 0; i < simManager->comms.size(); ++i)
         simManager->comms[i]->ProcessMessages();
+    Profiler::EndZone();
     
     //Loop through contact manifolds -> update contacts
     if(simManager->getContact(0) != nullptr) // If at least one contact is defined
     {
+        PROFILE_ZONE("Contacts");
         int numManifolds = world->getDispatcher()->getNumManifolds();
         for(int i=0; i<numManifolds; ++i)
         {
@@ -1707,8 +1854,20 @@ void SimulationManager::SimulationPostTickCallback(btDynamicsWorld *world, Scala
     //Update simulation time
     simManager->simulationTime += timeStep;
     
+    //Publish new measurements to the shared memory
+    if(simManager->shmBridge != nullptr)
+    {
+        PROFILE_ZONE("Shared memory");
+        simManager->shmBridge->Publish(simManager->getSimulationTime(true));
+    }
+    
     //Optional method to update some post simulation data (like ROS messages...)
-    if (simManager->getCallSimulationStepCompleted())
+    if(simManager->batchStepsLeft > 0) //Batched steps are reported once, with the time simulated
+    {
+        if(--simManager->batchStepsLeft == 0)
+            simManager->SimulationStepCompleted(Scalar(simManager->batchSteps) * timeStep);
+    }
+    else if (simManager->getCallSimulationStepCompleted())
         simManager->SimulationStepCompleted(timeStep);
 }
 
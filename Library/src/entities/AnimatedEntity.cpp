@@ -320,6 +320,7 @@ std::vector<Renderable> AnimatedEntity::Render()
             item.vel = glVectorFromVector(getLinearVelocity());
             item.avel = glVectorFromVector(getAngularVelocity());
             item.materialName = mat.name;
+            item.materialId = mat.id;
             item.objectId = dm == DisplayMode::GRAPHICAL ? graObjectId : phyObjectId;
             item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
             items.push_back(item);
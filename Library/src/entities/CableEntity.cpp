@@ -395,6 +395,7 @@ std::vector<Renderable> CableEntity::Render()
         item.lookId = displayMode_ == DisplayMode::GRAPHICAL ? lookId_ : -1;
         item.objectId = objectId_;
         item.materialName = mat_.name;
+        item.materialId = mat_.id;
         item.model = glm::mat4(static_cast<GLfloat>(radius_));
         item.cor = glm::vec3(0.f);
         item.vel = glm::vec3(0.f);
@@ -53,7 +53,7 @@ MovingEntity::~MovingEntity()
         delete particles;
 }
 
-Material MovingEntity::getMaterial() const
+const Material& MovingEntity::getMaterial() const
 {
     return mat;
 }
@@ -30,6 +30,8 @@
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/MeshSoA.h"
+#include "utils/GeometryFileUtil.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include <iostream>
@@ -97,6 +99,17 @@ SolidEntity::SolidEntity(std::string uniqueName, PhysicsSettings phy, std::strin
     //Set pointers
     multibodyCollider = nullptr;
     phyMesh = nullptr;
+    hydroMesh = nullptr;
+    hydroMeshSoA = nullptr;
+    fdUpdated = false;
+    fdSkipped = 0;
+    fdLastPosition = BodyFluidPosition::OUTSIDE;
+    fdPosTol = Scalar(0.05);
+    fdRotTol = Scalar(0.01);
+    fdLinTol = Scalar(0.01);
+    fdAngTol = Scalar(0.01);
+    fdRelTol = Scalar(0.02);
+    fdMaxSkipped = 10;
     graObjectId = -1;
     phyObjectId = -1;
     dm = DisplayMode::GRAPHICAL;
@@ -107,8 +120,10 @@ SolidEntity::SolidEntity(std::string uniqueName, PhysicsSettings phy, std::strin
 
 SolidEntity::~SolidEntity()
 {
-    if(phyMesh != nullptr) 
-        delete phyMesh;
+    if(hydroMesh != nullptr)
+        delete hydroMesh;
+    if(hydroMeshSoA != nullptr)
+        delete hydroMeshSoA;
 }
 
 EntityType SolidEntity::getType() const
@@ -197,6 +212,36 @@ void SolidEntity::SetHydrodynamicCoefficients(const Vector3& Cd, const Vector3&
         fdCf = Cf;
 }
 
+void SolidEntity::SetHydrodynamicsMeshFaces(unsigned int maxFaces)
+{
+    if(hydroMesh != nullptr)
+    {
+        delete hydroMesh;
+        hydroMesh = nullptr;
+    }
+    if(hydroMeshSoA != nullptr)
+    {
+        delete hydroMeshSoA;
+        hydroMeshSoA = nullptr;
+    }
+    if(phyMesh == nullptr || maxFaces == 0 || phyMesh->faces.size() <= maxFaces)
+        return;
+    
+    hydroMesh = DecimateMesh(phyMesh.get(), maxFaces);
+    if(hydroMesh == nullptr)
+    {
+        cWarning("Failed to decimate the hydrodynamics mesh of '%s'! Using the physics mesh.", getName().c_str());
+        return;
+    }
+
+    //Report the error of buoyancy (displaced volume) and centre of buoyancy
+    MeshProperties full = ComputePhysicalProperties(phyMesh.get(), Scalar(-1), Scalar(1));
+    MeshProperties lod = ComputePhysicalProperties(hydroMesh, Scalar(-1), Scalar(1));
+    Scalar volErr = full.volume > Scalar(0) ? (lod.volume - full.volume)/full.volume * Scalar(100) : Scalar(0);
+    cInfo("Hydrodynamics mesh of '%s' decimated (%zu/%zu faces): buoyancy error %1.2lf%%, CB shift %1.4lf m.", 
+          getName().c_str(), hydroMesh->faces.size(), phyMesh->faces.size(), volErr, (lod.CG - full.CG).length());
+}
+
 void SolidEntity::SetAddedMass(const Vector3& addedMass, const Vector3& addedInertia)
 {
     aMass = addedMass;
@@ -246,6 +291,7 @@ std::vector<Renderable> SolidEntity::Render()
         Renderable item1;
         item1.type = RenderableType::SOLID;
         item1.materialName = mat.name;
+        item1.materialId = mat.id;
         
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         {
@@ -708,7 +754,19 @@ void SolidEntity::getGeometryApprox(GeometryApproxType& type, std::vector<Scalar
 
 const Mesh* SolidEntity::getPhysicsMesh()
 {
-    return phyMesh;
+    return phyMesh.get();
+}
+
+const Mesh* SolidEntity::getHydrodynamicsMesh()
+{
+    return hydroMesh != nullptr ? hydroMesh : phyMesh.get();
+}
+
+const MeshSoA* SolidEntity::getHydrodynamicsMeshSoA()
+{
+    if(hydroMeshSoA == nullptr && getHydrodynamicsMesh() != nullptr)
+        hydroMeshSoA = new MeshSoA(getHydrodynamicsMesh());
+    return hydroMeshSoA;
 }
 
 std::vector<Vector3>* SolidEntity::getMeshVertices() const
@@ -1114,7 +1172,7 @@ void SolidEntity::BuildGraphicalObject()
     if (graObjectId > -1) // Object already built
         return;
         
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh.get());
     phyObjectId = graObjectId;
 }
 
@@ -1151,6 +1209,7 @@ void SolidEntity::BuildRigidBody(btDynamicsWorld* world)
 
         rigidBody = new btRigidBody(rigidBodyCI);
         rigidBody->setUserPointer(this);
+        rigidBody->setUserIndex(getSolidType() == SolidType::COMPOUND ? -1 : mat.id); //Cached for the contact callback (compounds resolved per part)
         rigidBody->setFlags(rigidBody->getFlags() | BT_ENABLE_GYROSCOPIC_FORCE_IMPLICIT_BODY);
         rigidBody->setCollisionFlags(rigidBody->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
         //rigidBody->setContactProcessingThreshold(0.002);
@@ -1194,6 +1253,7 @@ void SolidEntity::BuildMultibodyLinkCollider(btMultiBody *mb, unsigned int child
         multibodyCollider = new btMultiBodyLinkCollider(mb, child - 1);
         multibodyCollider->setCollisionShape(colShape);
         multibodyCollider->setUserPointer(this); //HAS TO BE AFTER SETTING COLLISION SHAPE TO PROPAGATE TO ALL OF COMPOUND SUBSHAPES!!!!!
+        multibodyCollider->setUserIndex(getSolidType() == SolidType::COMPOUND ? -1 : mat.id); //Cached for the contact callback (compounds resolved per part)
         multibodyCollider->setFriction(Scalar(0));
         multibodyCollider->setRestitution(Scalar(0));
         multibodyCollider->setRollingFriction(Scalar(0));
@@ -1354,7 +1414,7 @@ void SolidEntity::CorrectHydrodynamicForces(Ocean* ocn, Vector3& _Fdq, Vector3&
     _Tdf = ocn->getLiquid().density * Tdfc * _Tdf; //rho*S*v from viscous drag equation
 }
 
-void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
+void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings& settings, const MeshSoA* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
                                             const Vector3& _v, const Vector3& _omega, Vector3& _Fb, Vector3& _Tb, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fdf, Vector3& _Tdf, 
                                             Scalar& _Swet, Scalar& _Vsub, Renderable& debug)
 {
@@ -1401,26 +1461,38 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     glm::vec3 p0 = p; //Point used as a center of mesh for volume calculation.
     p0.z = 0.f;       //When the robot is far from the world origin numerical erros would explode without translating the mesh data!
     
+    //Transform all vertices to the world frame and compute their depth (once per vertex, not per face)
+    thread_local std::vector<GLfloat> buffer;
+    size_t n = mesh->getPaddedSize();
+    buffer.resize(n * 4);
+    GLfloat* wx = buffer.data();
+    GLfloat* wy = wx + n;
+    GLfloat* wz = wy + n;
+    GLfloat* wd = wz + n;
+    mesh->Transform(TC, wx, wy, wz);
+    ocn->GetDepth(wx, wy, wz, wd, mesh->getNumOfVertices());
+    const GLuint* fv = mesh->faces.data();
+
     //Loop through all faces...
-    for(size_t i=0; i<mesh->faces.size(); ++i)
+    for(size_t i=0; i<mesh->getNumOfFaces(); ++i)
     {
-        //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
-        
         //Check if face underwater
+        GLuint v1 = fv[i*3];
+        GLuint v2 = fv[i*3+1];
+        GLuint v3 = fv[i*3+2];
         GLfloat depth[3];
-        depth[0] = ocn->GetDepth(p1);
-        depth[1] = ocn->GetDepth(p2);
-        depth[2] = ocn->GetDepth(p3);
+        depth[0] = wd[v1];
+        depth[1] = wd[v2];
+        depth[2] = wd[v3];
         
         if(depth[0] < 0.f && depth[1] < 0.f && depth[2] < 0.f)
             continue;
         
+        //Global coordinates
+        glm::vec3 p1(wx[v1], wy[v1], wz[v1]);
+        glm::vec3 p2(wx[v2], wy[v2], wz[v2]);
+        glm::vec3 p3(wx[v3], wy[v3], wz[v3]);
+        
         //Calculate face properties
         glm::vec3 fc;
         glm::vec3 fn;
@@ -1788,7 +1860,7 @@ void SolidEntity::ComputeHydrodynamicForcesSurface(const HydrodynamicsSettings&
     _Swet = Swet;
 }
 
-void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
+void SolidEntity::ComputeHydrodynamicForcesSubmerged(const MeshSoA* mesh, Ocean* ocn, const Transform& T_CG, const Transform& T_C,
                                               const Vector3& _v, const Vector3& _omega, Vector3& _Fdq, Vector3& _Tdq, Vector3& _Fdf, Vector3& _Tdf)
 {
     if(mesh == nullptr)
@@ -1800,63 +1872,51 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
         return;
     }
 
-    //Computation with floats (geometry has float precision)
-    glm::vec3 Fdq(0.f);
-    glm::vec3 Tdq(0.f);
-    glm::vec3 Fdf(0.f);
-    glm::vec3 Tdf(0.f);
-    glm::mat4 TCG = glMatrixFromTransform(T_CG);
+    //Computation with floats (geometry has float precision), in the mesh frame
     glm::mat4 TC = glMatrixFromTransform(T_C);
-    glm::vec3 v = glVectorFromVector(_v);
-    glm::vec3 omega = glVectorFromVector(_omega);
+    glm::mat3 R(TC);
+    glm::mat3 Rt = glm::transpose(R);
+    glm::vec3 t(TC[3]);
+    glm::vec3 p = glVectorFromVector(T_CG.getOrigin());
+    glm::vec3 d = Rt * (t - p); //Mesh origin with respect to CG
+    glm::vec3 omega = Rt * glVectorFromVector(_omega);
+    glm::vec3 u = -(Rt * glVectorFromVector(_v)) - glm::cross(omega, d); //Relative flow at mesh origin (without currents)
     
-    //Calculate fluid dynamics forces and torques
-    glm::vec3 p = glm::vec3(TCG[3]);
-
-    //Loop through all faces...
-    for(size_t i=0; i<mesh->faces.size(); ++i)
+    //Face data is precomputed in the mesh frame, only the flow has to be transformed
+    const GLfloat* ux = nullptr;
+    const GLfloat* uy = nullptr;
+    const GLfloat* uz = nullptr;
+    if(ocn->hasUniformCurrents())
+        u += Rt * ocn->GetFluidVelocity(t);
+    else
     {
-        //Global coordinates
-        glm::vec3 p1gl = mesh->getVertexPos(i, 0);
-        glm::vec3 p2gl = mesh->getVertexPos(i, 1);
-        glm::vec3 p3gl = mesh->getVertexPos(i, 2);
-        glm::vec3 p1 = glm::vec3(TC * glm::vec4(p1gl, 1.f));
-        glm::vec3 p2 = glm::vec3(TC * glm::vec4(p2gl, 1.f));
-        glm::vec3 p3 = glm::vec3(TC * glm::vec4(p3gl, 1.f));
-        
-        //Face properties
-        glm::vec3 fv1 = p2-p1; //One side of the face (triangle)
-        glm::vec3 fv2 = p3-p1; //Another side of the face (triangle)
-        glm::vec3 fn = glm::cross(fv1, fv2); //Normal of the face (length != 1)
-        GLfloat len = glm::length2(fn);
-        if(len < 1e-12f) continue;
-        len = glm::sqrt(len);
-        glm::vec3 fn1 = fn/len; //Normalised normal (length = 1)
-        GLfloat A = len/2.f; //Area of the face (triangle)
-        glm::vec3 fc = (p1+p2+p3)/3.f; //Face centroid
-     
-        //Forces
-        glm::vec3 vc = ocn->GetFluidVelocity(fc) - (v + glm::cross(omega, fc-p));
-        GLfloat vc_n = glm::dot(vc, fn1);
-        glm::vec3 vn = vc_n  * fn1; //Normal velocity
-        glm::vec3 vt = vc - vn; //Tangent velocity
-        
-        if(vc_n < -1e-12f) //If liquid is approaching the surface
+        thread_local std::vector<GLfloat> buffer;
+        size_t n = mesh->getPaddedFacesSize();
+        buffer.assign(n * 3, 0.f);
+        GLfloat* bx = buffer.data();
+        GLfloat* by = bx + n;
+        GLfloat* bz = by + n;
+        for(size_t i=0; i<mesh->getNumOfFaces(); ++i)
         {
-            GLfloat vmag2 = glm::length2(vc);
-            glm::vec3 quadratic = vc * sqrtf(vmag2) * -vc_n * A;
-            Fdq += quadratic;
-            Tdq += glm::cross(fc - p, quadratic);
-        }
-
-        GLfloat vmag2 = glm::length2(vt);
-        if(vmag2 > 1e-9f)
-        {
-            glm::vec3 skin = vt * A;
-            Fdf += skin;
-            Tdf += glm::cross(fc - p, skin);
+            glm::vec3 fc = R * glm::vec3(mesh->cx[i], mesh->cy[i], mesh->cz[i]) + t;
+            glm::vec3 fu = Rt * ocn->GetFluidVelocity(fc);
+            bx[i] = fu.x;
+            by[i] = fu.y;
+            bz[i] = fu.z;
         }
+        ux = bx;
+        uy = by;
+        uz = bz;
     }
+    
+    glm::vec3 Fq, Tq, Ff, Tf;
+    mesh->SubmergedDrag(u, omega, ux, uy, uz, Fq, Tq, Ff, Tf);
+    
+    //Back to the world frame, with torques about CG
+    glm::vec3 Fdq = R * Fq;
+    glm::vec3 Tdq = R * (Tq + glm::cross(d, Fq));
+    glm::vec3 Fdf = R * Ff;
+    glm::vec3 Tdf = R * (Tf + glm::cross(d, Ff));
 
     _Fdq = Vector3(Fdq.x, Fdq.y, Fdq.z);
     _Tdq = Vector3(Tdq.x, Tdq.y, Tdq.z);
@@ -1864,7 +1924,66 @@ void SolidEntity::ComputeHydrodynamicForcesSubmerged(const Mesh* mesh, Ocean* oc
     _Tdf = Vector3(Tdf.x, Tdf.y, Tdf.z);
 }
 
-void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn)
+void SolidEntity::setAdaptiveHydrodynamicsTolerances(Scalar position, Scalar rotation, Scalar velocity, Scalar angular, Scalar relative)
+{
+    fdPosTol = btMax(position, Scalar(0));
+    fdRotTol = btMax(rotation, Scalar(0));
+    fdLinTol = btMax(velocity, Scalar(0));
+    fdAngTol = btMax(angular, Scalar(0));
+    fdRelTol = btMax(relative, Scalar(0));
+}
+
+void SolidEntity::setAdaptiveHydrodynamicsMaxSkipped(unsigned int n)
+{
+    fdMaxSkipped = n;
+}
+
+bool SolidEntity::isHydrodynamicsAdaptive() const
+{
+    return phy.adaptiveHydrodynamics;
+}
+
+bool SolidEntity::CheckHydrodynamicsUpdate(Ocean* ocn, BodyFluidPosition bf, bool scheduled)
+{
+    if(!phy.adaptiveHydrodynamics)
+        return scheduled;
+
+    Transform T_CG = getCGTransform();
+    Vector3 p = T_CG.getOrigin();
+    Vector3 v = getLinearVelocity() - ocn->GetFluidVelocity(p); //Velocity relative to the fluid
+    Vector3 omega = getAngularVelocity();
+    Quaternion q = T_CG.getRotation();
+    
+    bool update = !fdUpdated 
+                  || bf != fdLastPosition
+                  || bf == BodyFluidPosition::CROSSING_SURFACE; //Surface piercing bodies are updated in every step
+    
+    if(!update && bf == BodyFluidPosition::INSIDE) //Outside the forces stay zero
+    {
+        update = (v - fdLastV).length() > fdLinTol + fdRelTol * fdLastV.length()
+                 || (omega - fdLastOmega).length() > fdAngTol + fdRelTol * fdLastOmega.length()
+                 || q.angleShortestPath(fdLastQ) > fdRotTol
+                 || (p - fdLastP).length() > fdPosTol
+                 || (scheduled && fdSkipped >= fdMaxSkipped);
+    }
+    
+    if(update)
+    {
+        fdUpdated = true;
+        fdSkipped = 0;
+        fdLastPosition = bf;
+        fdLastV = v;
+        fdLastOmega = omega;
+        fdLastQ = q;
+        fdLastP = p;
+    }
+    else if(scheduled)
+        ++fdSkipped;
+    
+    return update;
+}
+
+void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, BodyFluidPosition bf)
 {
     if(phy.mode != PhysicsMode::FLOATING && phy.mode != PhysicsMode::SUBMERGED) return;
     
@@ -1872,8 +1991,6 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
     if (points != nullptr)
         points->clear();
 
-    BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
-    
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
     {
@@ -1903,14 +2020,14 @@ void SolidEntity::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocea
         }
         
         if(settings.dampingForces)
-            ComputeHydrodynamicForcesSubmerged(getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fdq, Tdq, Fdf, Tdf);
+            ComputeHydrodynamicForcesSubmerged(getHydrodynamicsMeshSoA(), ocn, getCGTransform(), getCTransform(), v, omega, Fdq, Tdq, Fdf, Tdf);
 
         Swet = surface;
     }
     else //CROSSING_FLUID_SURFACE
     {
         if(!isBuoyant()) settings.reallisticBuoyancy = false;
-        ComputeHydrodynamicForcesSurface(settings, getPhysicsMesh(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdq, Tdq, Fdf, Tdf, Swet, Vsub, submerged);
+        ComputeHydrodynamicForcesSurface(settings, getHydrodynamicsMeshSoA(), ocn, getCGTransform(), getCTransform(), v, omega, Fb, Tb, Fdq, Tdq, Fdf, Tdf, Swet, Vsub, submerged);
     }
     
     if(settings.dampingForces)
@@ -57,7 +57,7 @@ EntityType StaticEntity::getType() const
     return EntityType::STATIC;
 }
 
-Material StaticEntity::getMaterial() const
+const Material& StaticEntity::getMaterial() const
 {
     return mat;
 }
@@ -111,6 +111,7 @@ std::vector<Renderable> StaticEntity::Render()
         Renderable item;
         item.type = RenderableType::SOLID;
         item.materialName = mat.name;
+        item.materialId = mat.id;
         item.objectId = phyObjectId;
         item.lookId = dm == DisplayMode::GRAPHICAL ? lookId : -1;
         item.model = glMatrixFromTransform(trans);
@@ -140,6 +141,7 @@ void StaticEntity::BuildRigidBody(btCollisionShape* shape)
     
     rigidBody = new btRigidBody(rigidBodyCI);
     rigidBody->setUserPointer(this);
+    rigidBody->setUserIndex(mat.id); //Cached for the contact callback
     rigidBody->setCollisionFlags(rigidBody->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
     
     BuildGraphicalObject();
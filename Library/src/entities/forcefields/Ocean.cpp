@@ -28,6 +28,7 @@
 #include <algorithm>
 #include "utils/SystemUtil.hpp"
 #include "entities/forcefields/VelocityField.h"
+#include "entities/forcefields/WaveField.h"
 #include "entities/SolidEntity.h"
 #include "entities/CableEntity.h"
 #include "graphics/OpenGLFlatOcean.h"
@@ -59,6 +60,9 @@ Ocean::Ocean(std::string uniqueName, Scalar waves, Fluid l) : ForcefieldEntity(u
     wavesDebug.data = std::make_shared<std::vector<glm::vec3>>();
     waterType = Scalar(0.0);
     glOcean = nullptr;
+    waveField = nullptr;
+    if(hasWaves())
+        waveField = new WaveField((GLfloat)oceanState);
 }
 
 Ocean::~Ocean()
@@ -72,6 +76,8 @@ Ocean::~Ocean()
     
     if(glOcean != nullptr)
         delete glOcean;
+    if(waveField != nullptr)
+        delete waveField;
 }
 
 bool Ocean::hasWaves() const
@@ -92,6 +98,41 @@ Scalar Ocean::getWaterType() const
     return waterType;
 }
         
+WaveField* Ocean::getWaveField()
+{
+    return waveField;
+}
+
+void Ocean::ConfigureWaves(unsigned int resolution, Scalar updateRate)
+{
+    if(!hasWaves())
+        return;
+
+    WaveField* oldWaveField = waveField;
+    waveField = new WaveField((GLfloat)oceanState, resolution, (GLfloat)updateRate);
+    
+    //Rendered waves have to use the same FFT grid as the hydrodynamics
+    if(glOcean != nullptr)
+    {
+        GLfloat temperature = glOcean->getWaterTemperature();
+        bool particles = glOcean->getParticlesEnabled();
+        delete glOcean;
+        glOcean = new OpenGLRealOcean(depth, oceanState, waveField);
+        glOcean->setWaterType((GLfloat)waterType);
+        glOcean->setWaterTemperature(temperature);
+        glOcean->setParticles(particles);
+    }
+    
+    if(oldWaveField != nullptr)
+        delete oldWaveField;
+}
+
+void Ocean::UpdateWaves(Scalar dt)
+{
+    if(waveField != nullptr)
+        waveField->Advance((GLfloat)dt);
+}
+
 OpenGLOcean* Ocean::getOpenGLOcean()
 {
     return glOcean;
@@ -150,7 +191,7 @@ float Ocean::GetDepth(const glm::vec3& point)
 {
     if(hasWaves()) //Geometric waves
     {
-        GLfloat waveHeight = glOcean->ComputeWaveHeight(point.x, point.y);
+        GLfloat waveHeight = waveField->ComputeWaveHeight(point.x, point.y);
         glm::vec3 wavePoint(point.x, point.y, waveHeight);
 #ifdef DEBUG_WAVES
         wavesDebug.getDataAsPoints()->push_back(wavePoint);
@@ -172,6 +213,17 @@ Scalar Ocean::GetDepth(const Vector3& point)
     return Scalar(GetDepth(glm::vec3((GLfloat)point.getX(), (GLfloat)point.getY(), (GLfloat)point.getZ())));
 }
 
+void Ocean::GetDepth(const GLfloat* x, const GLfloat* y, const GLfloat* z, GLfloat* depth, size_t n)
+{
+    if(hasWaves()) //Geometric waves
+    {
+        for(size_t i=0; i<n; ++i)
+            depth[i] = GetDepth(glm::vec3(x[i], y[i], z[i]));
+    }
+    else //Flat surface
+        std::copy(z, z + n, depth);
+}
+
 Scalar Ocean::GetPressure(const Vector3& point)
 {
     Scalar g = SimulationApp::getApp()->getSimulationManager()->getGravity().getZ();
@@ -200,6 +252,19 @@ glm::vec3 Ocean::GetFluidVelocity(const glm::vec3& point) const
     return glVectorFromVector(GetFluidVelocity(Vector3(point.x, point.y, point.z)));
 }
 
+bool Ocean::hasUniformCurrents() const
+{
+    if(currentsEnabled)
+    {
+        for(size_t i=0; i<currents.size(); ++i)
+        {
+            if(currents[i]->isEnabled() && currents[i]->getType() != VelocityFieldType::UNIFORM)
+                return false;
+        }
+    }
+    return true;
+}
+
 void Ocean::EnableCurrents()
 {
     currentsEnabled = true;
@@ -245,14 +310,19 @@ void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool
     
     if (ent->getType() == EntityType::SOLID)
     {
-        if(recompute)
+        SolidEntity* solid = (SolidEntity*)ent;
+        if(recompute || solid->isHydrodynamicsAdaptive())
         {
-            settings.dampingForces = true;
-            settings.reallisticBuoyancy = true;
-            ((SolidEntity*)ent)->ComputeHydrodynamicForces(settings, this);
+            BodyFluidPosition bf = solid->CheckBodyFluidPosition(this);
+            if(solid->CheckHydrodynamicsUpdate(this, bf, recompute))
+            {
+                settings.dampingForces = true;
+                settings.reallisticBuoyancy = true;
+                solid->ComputeHydrodynamicForces(settings, this, bf);
+            }
         }
         
-        ((SolidEntity*)ent)->ApplyHydrodynamicForces();
+        solid->ApplyHydrodynamicForces();
     }
     else if (ent->getType() == EntityType::CABLE)
     {
@@ -270,7 +340,7 @@ void Ocean::ApplyFluidForces(btDynamicsWorld* world, btCollisionObject* co, bool
 void Ocean::InitGraphics(SDL_mutex* hydrodynamics)
 {
     if(oceanState > 0.0)
-        glOcean = new OpenGLRealOcean(depth, oceanState, hydrodynamics);
+        glOcean = new OpenGLRealOcean(depth, oceanState, waveField);
     else
         glOcean = new OpenGLFlatOcean(depth);
     setWaterType(0.2);
@@ -0,0 +1,496 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  WaveField.cpp
+//  Stonefish
+//
+
+#include "entities/forcefields/WaveField.h"
+
+#include <algorithm>
+#include "utils/SystemUtil.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sf
+{
+
+WaveField::WaveField(GLfloat state, unsigned int resolution, GLfloat updateRate)
+{
+    //Spectrum parameters (the same as for rendering)
+    params.passes = 4;
+    while(params.passes < 10 && (2u << params.passes) <= resolution)
+        ++params.passes;
+    params.slopeVarianceSize = 4;
+    params.fftSize = 1 << params.passes;
+    params.propagate = true;
+    params.km = 370.f;
+    params.cm = 0.23f;
+    params.t = 0.f;
+    params.gridSizes = glm::vec4(893.f, 101.f, 21.f, 11.f);
+    params.spectrum12 = NULL;
+    params.spectrum34 = NULL;
+    SetSeaState(params, state);
+    GenerateSpectrum(params);
+
+    //FFT tables
+    const unsigned int N = params.fftSize;
+    twiddles.resize(N);
+    for(unsigned int k = 0; k < N/2; ++k)
+    {
+        twiddles[2*k] = cosf(2.f * M_PI * k / (float)N);
+        twiddles[2*k+1] = sinf(2.f * M_PI * k / (float)N);
+    }
+    bitReversed.resize(N);
+    for(unsigned int i = 0; i < N; ++i)
+    {
+        unsigned int r = 0;
+        for(unsigned int b = 0; b < params.passes; ++b)
+            r |= ((i >> b) & 1u) << (params.passes - 1 - b);
+        bitReversed[i] = r;
+    }
+    
+    //Buffers
+    for(unsigned int b = 0; b < 2; ++b)
+        for(unsigned int g = 0; g < 2; ++g)
+            heights[b][g].resize(N * N, 0.f);
+    transposed.resize(N * N);
+    front = 0;
+
+    //Initial field
+    period = updateRate > 0.f ? 1.f/updateRate : 0.f;
+    time = 0.f;
+    nextTime = period;
+    Evolve(time, heights[front][0].data(), heights[front][1].data());
+
+    //Background computation
+    requested = false;
+    ready = false;
+    quit = false;
+    workerMutex = SDL_CreateMutex();
+    workerCond = SDL_CreateCond();
+    worker = nullptr;
+    if(period > 0.f)
+    {
+        worker = SDL_CreateThread(WaveField::WorkerThread, "waveFieldThread", this);
+        RequestField(nextTime);
+    }
+}
+
+WaveField::~WaveField()
+{
+    if(worker != nullptr)
+    {
+        SDL_LockMutex(workerMutex);
+        quit = true;
+        SDL_CondBroadcast(workerCond);
+        SDL_UnlockMutex(workerMutex);
+        SDL_WaitThread(worker, NULL);
+    }
+    SDL_DestroyCond(workerCond);
+    SDL_DestroyMutex(workerMutex);
+    
+    if(params.spectrum12 != NULL) delete [] params.spectrum12;
+    if(params.spectrum34 != NULL) delete [] params.spectrum34;
+}
+
+unsigned int WaveField::getResolution() const
+{
+    return params.fftSize;
+}
+
+GLfloat WaveField::getUpdateRate() const
+{
+    return period > 0.f ? 1.f/period : 0.f;
+}
+
+void WaveField::Advance(GLfloat dt)
+{
+    time += dt;
+
+    if(worker == nullptr) //Synchronous update
+    {
+        Evolve(time, heights[front][0].data(), heights[front][1].data());
+        return;
+    }
+
+    if(time < nextTime)
+        return;
+
+    //The field for the current period was computed in the background
+    WaitForField();
+    front = 1 - front;
+    
+    //Start computing the next one
+    while(nextTime <= time)
+        nextTime += period;
+    RequestField(nextTime);
+}
+
+void WaveField::RequestField(GLfloat t)
+{
+    SDL_LockMutex(workerMutex);
+    requestedTime = t;
+    requested = true;
+    ready = false;
+    SDL_CondBroadcast(workerCond);
+    SDL_UnlockMutex(workerMutex);
+}
+
+void WaveField::WaitForField()
+{
+    SDL_LockMutex(workerMutex);
+    while(!ready)
+        SDL_CondWait(workerCond, workerMutex);
+    SDL_UnlockMutex(workerMutex);
+}
+
+int WaveField::WorkerThread(void* data)
+{
+    WaveField* wf = (WaveField*)data;
+    
+    while(true)
+    {
+        SDL_LockMutex(wf->workerMutex);
+        while(!wf->requested && !wf->quit)
+            SDL_CondWait(wf->workerCond, wf->workerMutex);
+        if(wf->quit)
+        {
+            SDL_UnlockMutex(wf->workerMutex);
+            break;
+        }
+        GLfloat t = wf->requestedTime;
+        unsigned int back = 1 - wf->front;
+        wf->requested = false;
+        SDL_UnlockMutex(wf->workerMutex);
+
+        wf->Evolve(t, wf->heights[back][0].data(), wf->heights[back][1].data());
+
+        SDL_LockMutex(wf->workerMutex);
+        wf->ready = true;
+        SDL_CondBroadcast(wf->workerCond);
+        SDL_UnlockMutex(wf->workerMutex);
+    }
+    return 0;
+}
+
+void WaveField::Evolve(GLfloat t, GLfloat* h1, GLfloat* h2)
+{
+    //Propagate the spectrum of the two largest grids to time t (same as the "init" shader)
+    //and pack them into a single complex field, h1 + i*h2
+    const int N = params.fftSize;
+    const float s2 = 1.414213562f;
+    const float dk1 = 2.f * M_PI / params.gridSizes[0];
+    const float dk2 = 2.f * M_PI / params.gridSizes[1];
+    
+    for(int y = 0; y < N; ++y)
+    {
+        int yc = (N - y) % N;
+        float ys = (float)(y >= N/2 ? y - N : y);
+        for(int x = 0; x < N; ++x)
+        {
+            int xc = (N - x) % N;
+            float xs = (float)(x >= N/2 ? x - N : x);
+            const float* s = params.spectrum12 + 4 * (x + y * N);
+            const float* sc = params.spectrum12 + 4 * (xc + yc * N);
+            float kl = sqrtf(xs * xs + ys * ys);
+
+            float w = Omega(params, kl * dk1) * t;
+            float c = cosf(w);
+            float sn = sinf(w);
+            float h1r = s2 * ((s[0] + sc[0]) * c - (s[1] + sc[1]) * sn);
+            float h1i = s2 * ((s[0] - sc[0]) * sn + (s[1] - sc[1]) * c);
+            
+            w = Omega(params, kl * dk2) * t;
+            c = cosf(w);
+            sn = sinf(w);
+            float h2r = s2 * ((s[2] + sc[2]) * c - (s[3] + sc[3]) * sn);
+            float h2i = s2 * ((s[2] - sc[2]) * sn + (s[3] - sc[3]) * c);
+            
+            h1[x + y * N] = h1r - h2i;
+            h2[x + y * N] = h1i + h2r;
+        }
+    }
+
+    //Both grids are real in the spatial domain, so they end up in the real and imaginary part
+    InverseFFT(h1, h2);
+}
+
+void WaveField::InverseFFT(GLfloat* re, GLfloat* im)
+{
+    InverseFFTColumns(re, im);
+    Transpose(re);
+    Transpose(im);
+    InverseFFTColumns(re, im);
+    Transpose(re);
+    Transpose(im);
+}
+
+void WaveField::InverseFFTColumns(GLfloat* re, GLfloat* im)
+{
+    //Radix-2 FFT performed on all columns at once, so that the butterflies operate on whole rows
+    const size_t N = params.fftSize;
+    
+    for(size_t r = 0; r < N; ++r)
+    {
+        size_t br = bitReversed[r];
+        if(br > r)
+        {
+            std::swap_ranges(re + r * N, re + (r + 1) * N, re + br * N);
+            std::swap_ranges(im + r * N, im + (r + 1) * N, im + br * N);
+        }
+    }
+
+    for(size_t half = 1; half < N; half <<= 1)
+    {
+        size_t step = N / (2 * half);
+        for(size_t start = 0; start < N; start += 2 * half)
+        {
+            for(size_t k = 0; k < half; ++k)
+            {
+                const GLfloat wr = twiddles[2 * k * step];
+                const GLfloat wi = twiddles[2 * k * step + 1];
+                GLfloat* ar = re + (start + k) * N;
+                GLfloat* ai = im + (start + k) * N;
+                GLfloat* br = re + (start + k + half) * N;
+                GLfloat* bi = im + (start + k + half) * N;
+                size_t i = 0;
+#if defined(__AVX__)
+                const __m256 vwr = _mm256_set1_ps(wr);
+                const __m256 vwi = _mm256_set1_ps(wi);
+                for(; i + 8 <= N; i += 8)
+                {
+                    __m256 vbr = _mm256_loadu_ps(br + i);
+                    __m256 vbi = _mm256_loadu_ps(bi + i);
+                    __m256 var = _mm256_loadu_ps(ar + i);
+                    __m256 vai = _mm256_loadu_ps(ai + i);
+                    __m256 tr = _mm256_sub_ps(_mm256_mul_ps(vwr, vbr), _mm256_mul_ps(vwi, vbi));
+                    __m256 ti = _mm256_add_ps(_mm256_mul_ps(vwr, vbi), _mm256_mul_ps(vwi, vbr));
+                    _mm256_storeu_ps(br + i, _mm256_sub_ps(var, tr));
+                    _mm256_storeu_ps(bi + i, _mm256_sub_ps(vai, ti));
+                    _mm256_storeu_ps(ar + i, _mm256_add_ps(var, tr));
+                    _mm256_storeu_ps(ai + i, _mm256_add_ps(vai, ti));
+                }
+#elif defined(__SSE2__)
+                const __m128 vwr = _mm_set1_ps(wr);
+                const __m128 vwi = _mm_set1_ps(wi);
+                for(; i + 4 <= N; i += 4)
+                {
+                    __m128 vbr = _mm_loadu_ps(br + i);
+                    __m128 vbi = _mm_loadu_ps(bi + i);
+                    __m128 var = _mm_loadu_ps(ar + i);
+                    __m128 vai = _mm_loadu_ps(ai + i);
+                    __m128 tr = _mm_sub_ps(_mm_mul_ps(vwr, vbr), _mm_mul_ps(vwi, vbi));
+                    __m128 ti = _mm_add_ps(_mm_mul_ps(vwr, vbi), _mm_mul_ps(vwi, vbr));
+                    _mm_storeu_ps(br + i, _mm_sub_ps(var, tr));
+                    _mm_storeu_ps(bi + i, _mm_sub_ps(vai, ti));
+                    _mm_storeu_ps(ar + i, _mm_add_ps(var, tr));
+                    _mm_storeu_ps(ai + i, _mm_add_ps(vai, ti));
+                }
+#endif
+                //Scalar fallback (and remainder)
+                for(; i < N; ++i)
+                {
+                    GLfloat tr = wr * br[i] - wi * bi[i];
+                    GLfloat ti = wr * bi[i] + wi * br[i];
+                    br[i] = ar[i] - tr;
+                    bi[i] = ai[i] - ti;
+                    ar[i] += tr;
+                    ai[i] += ti;
+                }
+            }
+        }
+    }
+}
+
+void WaveField::Transpose(GLfloat* data)
+{
+    const size_t N = params.fftSize;
+    const size_t B = 16; //Block size
+    
+    for(size_t r0 = 0; r0 < N; r0 += B)
+        for(size_t c0 = 0; c0 < N; c0 += B)
+            for(size_t r = r0; r < std::min(r0 + B, N); ++r)
+                for(size_t c = c0; c < std::min(c0 + B, N); ++c)
+                    transposed[c * N + r] = data[r * N + c];
+    
+    std::copy(transposed.begin(), transposed.end(), data);
+}
+
+GLfloat WaveField::Interpolate(const GLfloat* data, GLfloat x, GLfloat y) const
+{
+    //Bilinear interpolation with wrapping, matching the texture sampling of the rendered ocean
+    const float N = (float)params.fftSize;
+    float tmp;
+    
+    float i0f = modff(x - 0.5f/N, &tmp);
+    float j0f = modff(y - 0.5f/N, &tmp);
+    if(i0f < 0.f) i0f = 1.f - fabsf(i0f);
+    if(j0f < 0.f) j0f = 1.f - fabsf(j0f);
+    int i0 = (int)truncf(i0f * N) % params.fftSize;
+    int j0 = (int)truncf(j0f * N) % params.fftSize;
+    int i1 = (i0 + 1) % params.fftSize;
+    int j1 = (j0 + 1) % params.fftSize;
+    
+    float alpha = modff(i0f * N, &tmp);
+    float beta = modff(j0f * N, &tmp);
+    
+    return (1.f - alpha) * (1.f - beta) * data[j0 * params.fftSize + i0] 
+            + alpha * (1.f - beta) * data[j0 * params.fftSize + i1]
+            + (1.f - alpha) * beta * data[j1 * params.fftSize + i0] 
+            + alpha * beta * data[j1 * params.fftSize + i1];
+}
+
+GLfloat WaveField::ComputeWaveHeight(GLfloat x, GLfloat y) const
+{
+    //Z axis points down, hence the sign
+    GLfloat z = 0.f;
+    z -= Interpolate(heights[front][0].data(), x/params.gridSizes.x, y/params.gridSizes.x);
+    z -= Interpolate(heights[front][1].data(), x/params.gridSizes.y, y/params.gridSizes.y);
+    return z;
+}
+
+//Wave spectrum
+void WaveField::SetSeaState(OceanParams& params, GLfloat state)
+{
+    params.wind = state*5.f + 2.f;
+    params.A = 1.f;
+    params.omega = 5.f*expf(-state) + 0.2f;
+}
+
+float WaveField::Omega(const OceanParams& params, float k)
+{
+    return sqrtf(9.81f * k * (1.f + (k / params.km) * (k / params.km))); // Eq 24
+}
+
+// 1/kx and 1/ky in meters
+float WaveField::Spectrum(const OceanParams& params, float kx, float ky, bool omnispectrum)
+{
+    auto sqr = [](float x) { return x * x; };
+    float U10 = params.wind;
+    float Omega = params.omega;
+
+    // phase speed
+    float k = sqrt(kx * kx + ky * ky);
+    float c = WaveField::Omega(params, k) / k;
+
+    // spectral peak
+    float kp = 9.81 * sqr(Omega / U10); // after Eq 3
+    float cp = WaveField::Omega(params, kp) / kp;
+
+    // friction velocity
+    float z0 = 3.7e-5 * sqr(U10) / 9.81 * pow(U10 / cp, 0.9f); // Eq 66
+    float u_star = 0.41 * U10 / log(10.0 / z0); // Eq 60
+
+    float Lpm = exp(- 5.0 / 4.0 * sqr(kp / k)); // after Eq 3
+    float gamma = Omega < 1.0 ? 1.7 : 1.7 + 6.0 * log(Omega); // after Eq 3 // log10 or log??
+    float sigma = 0.08 * (1.0 + 4.0 / pow(Omega, 3.0f)); // after Eq 3
+    float Gamma = exp(-1.0 / (2.0 * sqr(sigma)) * sqr(sqrt(k / kp) - 1.0));
+    float Jp = pow(gamma, Gamma); // Eq 3
+    float Fp = Lpm * Jp * exp(- Omega / sqrt(10.0) * (sqrt(k / kp) - 1.0)); // Eq 32
+    float alphap = 0.006 * sqrt(Omega); // Eq 34
+    float Bl = 0.5 * alphap * cp / c * Fp; // Eq 31
+
+    float alpham = 0.01 * (u_star < params.cm ? 1.0 + log(u_star / params.cm) : 1.0 + 3.0 * log(u_star / params.cm)); // Eq 44
+    float Fm = exp(-0.25 * sqr(k / params.km - 1.0)); // Eq 41
+    float Bh = 0.5 * alpham * params.cm / c * Fm; // Eq 40
+
+    Bh *= Lpm; 
+
+    if (omnispectrum)
+    {
+        return params.A * (Bl + Bh) / (k * sqr(k)); // Eq 30
+    }
+
+    float a0 = log(2.0) / 4.0;
+    float ap = 4.0;
+    float am = 0.13 * u_star / params.cm; // Eq 59
+    float Delta = tanh(a0 + ap * pow(c / cp, 2.5f) + am * pow(params.cm / c, 2.5f)); // Eq 57
+
+    float phi = atan2(ky, kx);
+
+    if(params.propagate)
+    {
+        if (kx < 0.0)
+        {
+            return 0.0;
+        }
+        else
+        {
+            Bl *= 2.0;
+            Bh *= 2.0;
+        }
+    }
+
+    return params.A * (Bl + Bh) * (1.0 + Delta * cos(2.0 * phi)) / (2.0 * M_PI * sqr(sqr(k))); // Eq 67
+}
+
+void WaveField::GetSpectrumSample(const OceanParams& params, int i, int j, float lengthScale, float kMin, long* seed, float* result)
+{
+    float dk = 2.0 * M_PI / lengthScale;
+    float kx = i * dk;
+    float ky = j * dk;
+    if(fabsf(kx) < kMin && fabsf(ky) < kMin)
+    {
+        result[0] = 0.0;
+        result[1] = 0.0;
+    }
+    else
+    {
+        float S = Spectrum(params, kx, ky);
+        float h = sqrtf(S / 2.0) * dk;
+        float phi = frandom(seed) * 2.0 * M_PI;
+        result[0] = h * cos(phi);
+        result[1] = h * sin(phi);
+    }
+}
+
+// generates the waves spectrum
+void WaveField::GenerateSpectrum(OceanParams& params)
+{
+    if(params.spectrum12 != NULL)
+    {
+        delete[] params.spectrum12;
+        delete[] params.spectrum34;
+    }
+    params.spectrum12 = new float[params.fftSize * params.fftSize * 4];
+    params.spectrum34 = new float[params.fftSize * params.fftSize * 4];
+
+    //The same seed is used every time, so that all wave fields of the same state are identical
+    long seed = 1234;
+    
+    for (int y = 0; y < params.fftSize; ++y)
+    {
+        for (int x = 0; x < params.fftSize; ++x)
+        {
+            int offset = 4 * (x + y * params.fftSize);
+            int i = x >= params.fftSize / 2 ? x - params.fftSize : x;
+            int j = y >= params.fftSize / 2 ? y - params.fftSize : y;
+            GetSpectrumSample(params, i, j, params.gridSizes[0], M_PI / params.gridSizes[0], &seed, params.spectrum12 + offset);
+            GetSpectrumSample(params, i, j, params.gridSizes[1], M_PI * params.fftSize / params.gridSizes[0], &seed, params.spectrum12 + offset + 2);
+            GetSpectrumSample(params, i, j, params.gridSizes[2], M_PI * params.fftSize / params.gridSizes[1], &seed, params.spectrum34 + offset);
+            GetSpectrumSample(params, i, j, params.gridSizes[3], M_PI * params.fftSize / params.gridSizes[2], &seed, params.spectrum34 + offset + 2);
+        }
+    }
+}
+
+}
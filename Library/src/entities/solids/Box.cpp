@@ -69,7 +69,7 @@ Box::Box(std::string uniqueName, PhysicsSettings phy, const Vector3& dimensions,
     
     //Build geometry
 	glm::vec3 glHalfExtents(halfExtents.x(), halfExtents.y(), halfExtents.z());
-	phyMesh = OpenGLContent::BuildBox(glHalfExtents, 3, uvMode);
+	phyMesh.reset(OpenGLContent::BuildBox(glHalfExtents, 3, uvMode));
     
     //Compute hydrodynamic properties
     SetupHydrodynamics( GeometryApproxType::ELLIPSOID);
@@ -36,7 +36,7 @@ Compound::Compound(std::string uniqueName, PhysicsSettings phy, SolidEntity* fir
     : SolidEntity(uniqueName, phy, "", "", Scalar(-1))
 {
     //All transformations are zero -> transforming the origin of a compound body doesn't make sense...
-    phyMesh = NULL; // There is no single mesh
+    phyMesh = nullptr; // There is no single mesh
     volume = 0;
     mass = 0;
     Ipri = Vector3(0,0,0);
@@ -80,6 +80,14 @@ Material Compound::getMaterial(size_t partId) const
         return Material();
 }
 
+int Compound::getMaterialId(size_t partId) const
+{
+    if(partId < parts.size())
+        return parts[partId].solid->getMaterial().id;
+    else
+        return -1;
+}
+
 size_t Compound::getPartId(size_t collisionShapeId) const
 {
     if(collisionShapeId < collisionPartId.size())
@@ -289,7 +297,7 @@ btCollisionShape* Compound::BuildCollisionShape()
     return colShape;
 }
 
-void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn)
+void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean* ocn, BodyFluidPosition bf)
 {
     if(phy.mode != PhysicsMode::FLOATING && phy.mode != PhysicsMode::SUBMERGED) return;
     
@@ -297,8 +305,6 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
     if (points != nullptr)
         points->clear();
 
-    BodyFluidPosition bf = CheckBodyFluidPosition(ocn);
-     
     //If completely outside fluid just set all torques and forces to 0
     if(bf == BodyFluidPosition::OUTSIDE)
     {
@@ -348,7 +354,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                     Transform T_C_part = getOTransform() * parts[i].origin * parts[i].solid->getO2CTransform();
                     Transform T_O_part = getOTransform() * parts[i].origin;
 
-                    ComputeHydrodynamicForcesSubmerged(parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fdqp, Tdqp, Fdfp, Tdfp);
+                    ComputeHydrodynamicForcesSubmerged(parts[i].solid->getHydrodynamicsMeshSoA(), ocn, getCGTransform(), T_C_part, v, omega, Fdqp, Tdqp, Fdfp, Tdfp);
                     Vector3 Cd, Cf;
                     parts[i].solid->getHydrodynamicCoefficients(Cd, Cf);
                     CorrectHydrodynamicForces(ocn, Fdqp, Tdqp, Fdfp, Tdfp, Cd, Cf, T_O_part);
@@ -411,7 +417,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
 
                 if(parts[i].isExternal) //Compute buoyancy and drag
                 {
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdqp, Tdqp, Fdfp, Tdfp, Swetp, Vsubp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getHydrodynamicsMeshSoA(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdqp, Tdqp, Fdfp, Tdfp, Swetp, Vsubp, submerged);
                     Vector3 Cd, Cf;
                     parts[i].solid->getHydrodynamicCoefficients(Cd, Cf);
                     CorrectHydrodynamicForces(ocn, Fdqp, Tdqp, Fdfp, Tdfp, Cd, Cf, T_O_part);
@@ -427,7 +433,7 @@ void Compound::ComputeHydrodynamicForces(HydrodynamicsSettings settings, Ocean*
                 else if(pSettings.reallisticBuoyancy) //Compute only buoyancy
                 {
                     pSettings.dampingForces = false;
-                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getPhysicsMesh(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdqp, Tdqp, Fdfp, Tdfp, Swetp, Vsubp, submerged);
+                    ComputeHydrodynamicForcesSurface(pSettings, parts[i].solid->getHydrodynamicsMeshSoA(), ocn, getCGTransform(), T_C_part, v, omega, Fbp, Tbp, Fdqp, Tdqp, Fdfp, Tdfp, Swetp, Vsubp, submerged);
                     Fb += Fbp;
                     Tb += Tbp;
                     Vsub += Vsubp;
@@ -485,6 +491,7 @@ std::vector<Renderable> Compound::Render(size_t partId)
         {
             item1.type = RenderableType::SOLID;
             item1.materialName = parts.at(partId).solid->getMaterial().name;
+            item1.materialId = parts.at(partId).solid->getMaterial().id;
                 
             if(dm == DisplayMode::GRAPHICAL)
             {
@@ -67,7 +67,7 @@ Cylinder::Cylinder(std::string uniqueName, PhysicsSettings phy, Scalar radius, S
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildCylinder((GLfloat)r, (GLfloat)(halfHeight*2), (unsigned int)btMax(ceil(2.0*M_PI*r/0.1), 32.0)); //Max 0.1 m cylinder wall slice width
+    phyMesh.reset(OpenGLContent::BuildCylinder((GLfloat)r, (GLfloat)(halfHeight*2), (unsigned int)btMax(ceil(2.0*M_PI*r/0.1), 32.0))); //Max 0.1 m cylinder wall slice width
     
     //Compute hydrodynamic properties
     SetupHydrodynamics( GeometryApproxType::CYLINDER);
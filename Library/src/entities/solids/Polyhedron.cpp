@@ -29,6 +29,7 @@
 #include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
 
 namespace sf
 {
@@ -39,27 +40,36 @@ Polyhedron::Polyhedron(std::string uniqueName, PhysicsSettings phy,
                        std::string material, std::string look, Scalar thickness, GeometryApproxType approx)
                         : SolidEntity(uniqueName, phy, material, look, thickness)
 {
-    //1.Load geometry from file
-    graMesh = OpenGLContent::LoadMesh(graphicsFilename, graphicsScale, false);
+    //1.Load geometry from file (refined physics mesh shared through the cache, read-only)
+    hullMaxVertices = 0; //Exact hull unless simplification is requested
+    hullTolerance = Scalar(0);
     T_O2G = graphicsOrigin;
     
     if(physicsFilename != "")
     {
-        phyMesh = OpenGLContent::LoadMesh(physicsFilename, physicsScale, false);
+        graMesh = MeshCache::Get(graphicsFilename, graphicsScale);
+        phyMesh = MeshCache::Get(physicsFilename, physicsScale, false, 3.f);
+        if(phyMesh == nullptr)
+            abort();
         T_O2C = physicsOrigin;
     }
     else
     {
-        phyMesh = graMesh;
+        phyMesh = MeshCache::Get(graphicsFilename, graphicsScale, false, 3.f);
+        if(phyMesh == nullptr)
+            abort();
+        graMesh = phyMesh;
         T_O2C = T_O2G;
     }
     
-    OpenGLContent::Refine(phyMesh, 3.f);
-    
     //2. Compute physical properties
-    Vector3 CG;
-    Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    MeshProperties mp = MeshCache::GetPhysicalProperties(phyMesh, thickness, mat.density);
+    mass = mp.mass;
+    volume = mp.volume;
+    surface = mp.surface;
+    Ipri = mp.Ipri;
+    Vector3 CG = mp.CG;
+    Matrix3 Irot = mp.Irot;
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -79,8 +89,6 @@ Polyhedron::Polyhedron(std::string uniqueName, PhysicsSettings phy,
 
 Polyhedron::~Polyhedron()
 {
-    if(graMesh != nullptr && graMesh != phyMesh)
-        delete graMesh;
 }
     
 SolidType Polyhedron::getSolidType()
@@ -88,27 +96,30 @@ SolidType Polyhedron::getSolidType()
     return SolidType::POLYHEDRON;
 }
 
+void Polyhedron::setHullSimplification(unsigned int maxVertices, Scalar tolerance)
+{
+    hullMaxVertices = maxVertices;
+    hullTolerance = tolerance < Scalar(0) ? Scalar(0) : tolerance;
+}
+
 btCollisionShape* Polyhedron::BuildCollisionShape()
 {
+    std::vector<Vector3> hull = MeshCache::GetConvexHull(phyMesh, hullMaxVertices, hullTolerance);
     btConvexHullShape* convex = new btConvexHullShape();
-    for(size_t i=0; i<phyMesh->getNumOfVertices(); ++i)
-    {
-        glm::vec3 pos = phyMesh->getVertexPos(i);
-        Vector3 v(pos.x, pos.y, pos.z);
-        convex->addPoint(v);
-    }
-    //convex->optimizeConvexHull();
+    for(size_t i=0; i<hull.size(); ++i)
+        convex->addPoint(hull[i], false);
+    convex->recalcLocalAabb();
     convex->setMargin(0);
     return convex;
 }
 
 void Polyhedron::BuildGraphicalObject()
 {
-    if(graMesh == NULL || !SimulationApp::getApp()->hasGraphics())
+    if(graMesh == nullptr || !SimulationApp::getApp()->hasGraphics())
         return;
     
-    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh);
-    phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh);
+    graObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(graMesh.get());
+    phyObjectId = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent()->BuildObject(phyMesh.get());
 }
 
 }
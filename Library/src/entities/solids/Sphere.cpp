@@ -60,7 +60,7 @@ Sphere::Sphere(std::string uniqueName, PhysicsSettings phy, Scalar radius, const
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildSphere((GLfloat)r);
+    phyMesh.reset(OpenGLContent::BuildSphere((GLfloat)r));
     
     //Compute hydrodynamic properties
     SetupHydrodynamics( GeometryApproxType::SPHERE);
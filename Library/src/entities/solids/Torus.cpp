@@ -66,7 +66,7 @@ Torus::Torus(std::string uniqueName, PhysicsSettings phy, Scalar majorRadius, Sc
     }
     
     //Build geometry
-    phyMesh = OpenGLContent::BuildTorus(MR, mR);
+    phyMesh.reset(OpenGLContent::BuildTorus(MR, mR));
     
     //Compute hydrodynamic properties
     SetupHydrodynamics( GeometryApproxType::CYLINDER);
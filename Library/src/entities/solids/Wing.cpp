@@ -45,13 +45,13 @@ Wing::Wing(std::string uniqueName, PhysicsSettings phy, Scalar baseChordLength,
     wingLength = wingLength < Scalar(0) ? Scalar(0) : wingLength;
     
     //1. Build wing geometry
-    phyMesh = OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
-                                       (GLfloat)profileThickness, (GLfloat)wingLength);
+    phyMesh.reset(OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
+                                           (GLfloat)profileThickness, (GLfloat)wingLength));
     
     //2. Compute physical properties
     Vector3 CG;
     Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    ComputePhysicalProperties(phyMesh.get(), thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
@@ -96,14 +96,14 @@ Wing::Wing(std::string uniqueName, PhysicsSettings phy, Scalar baseChordLength,
     }
     
     //2. Build wing geometry
-    phyMesh = OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
-                                       (GLfloat)profileThickness, (GLfloat)wingLength);
+    phyMesh.reset(OpenGLContent::BuildWing((GLfloat)baseChordLength, (GLfloat)tipChordLength, (GLfloat)maxCamber, (GLfloat)maxCamberPos,
+                                           (GLfloat)profileThickness, (GLfloat)wingLength));
     
     
     //3. Compute physical properties
     Vector3 CG;
     Matrix3 Irot;
-    ComputePhysicalProperties(phyMesh, thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
+    ComputePhysicalProperties(phyMesh.get(), thickness, mat.density, mass, CG, volume, surface, Ipri, Irot);
     T_CG2C.setOrigin(-CG); //Set CG position
     T_CG2C = Transform(Irot, Vector3(0,0,0)).inverse() * T_CG2C; //Align CG frame to principal axes of inertia
     T_CG2O = T_CG2C * T_O2C.inverse();
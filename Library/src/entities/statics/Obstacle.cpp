@@ -185,6 +185,7 @@ std::vector<Renderable> Obstacle::Render()
         Renderable item;
         item.type = RenderableType::SOLID;
         item.materialName = mat.name;
+        item.materialId = mat.id;
         
         if(dm == DisplayMode::GRAPHICAL && graObjectId >= 0)
         { 
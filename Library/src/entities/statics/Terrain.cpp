@@ -26,6 +26,7 @@
 #include "entities/statics/Terrain.h"
 
 #include "stb_image.h"
+#include "utils/ImageCache.h"
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLContent.h"
@@ -42,7 +43,9 @@ Terrain::Terrain(std::string uniqueName, std::string pathToHeightmap, Scalar sca
 
     if(stbi_is_16_bit(pathToHeightmap.c_str())) //16 bit image
     {
-        stbi_us* data = stbi_load_16(pathToHeightmap.c_str(), &w, &h, &ch, 1);
+        stbi_us* data = (stbi_us*)ImageCache::Take(pathToHeightmap, 1, true, w, h, ch);
+        if(data == NULL)
+            data = stbi_load_16(pathToHeightmap.c_str(), &w, &h, &ch, 1);
         if(data == NULL) cCritical("Failed to load heightmap from file '%s'!", pathToHeightmap.c_str());
         heightmap = new GLfloat[w*h];
         for(int i=0; i<h; ++i)
@@ -52,7 +55,9 @@ Terrain::Terrain(std::string uniqueName, std::string pathToHeightmap, Scalar sca
     }
     else //8 bit image
     {
-        stbi_uc* data = stbi_load(pathToHeightmap.c_str(), &w, &h, &ch, 1);
+        stbi_uc* data = (stbi_uc*)ImageCache::Take(pathToHeightmap, 1, false, w, h, ch);
+        if(data == NULL)
+            data = stbi_load(pathToHeightmap.c_str(), &w, &h, &ch, 1);
         if(data == NULL) cCritical("Failed to load heightmap from file '%s'!", pathToHeightmap.c_str());
         heightmap = new GLfloat[w*h];
         for(int i=0; i<h; ++i)
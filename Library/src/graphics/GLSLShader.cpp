@@ -125,7 +125,7 @@ void GLSLShader::Use()
 #endif
 }
 
-bool GLSLShader::AddAttribute(std::string name, ParameterType type)
+bool GLSLShader::AddAttribute(const std::string& name, ParameterType type)
 {
     GLSLAttribute att;
     att.name = name;
@@ -142,7 +142,7 @@ bool GLSLShader::AddAttribute(std::string name, ParameterType type)
     return true;
 }
 
-bool GLSLShader::AddUniform(std::string name, ParameterType type)
+bool GLSLShader::AddUniform(const std::string& name, ParameterType type)
 {
     GLSLUniform uni;
     uni.name = name;
@@ -164,7 +164,7 @@ bool GLSLShader::AddUniform(std::string name, ParameterType type)
     return true;
 }
 
-bool GLSLShader::SetAttribute(std::string name, GLfloat x)
+bool GLSLShader::SetAttribute(const std::string& name, GLfloat x)
 {
     GLint index = 0;
     bool success = GetAttribute(name, FLOAT, index);
@@ -175,7 +175,7 @@ bool GLSLShader::SetAttribute(std::string name, GLfloat x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, bool x)
+bool GLSLShader::SetUniform(const std::string& name, bool x)
 {
     GLint location = 0;
     bool success = GetUniform(name, BOOLEAN, location);
@@ -186,7 +186,7 @@ bool GLSLShader::SetUniform(std::string name, bool x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLfloat x)
+bool GLSLShader::SetUniform(const std::string& name, GLfloat x)
 {
     GLint location = 0;
     bool success = GetUniform(name, FLOAT, location);
@@ -197,7 +197,7 @@ bool GLSLShader::SetUniform(std::string name, GLfloat x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC2, location);
@@ -208,7 +208,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC3, location);
@@ -219,7 +219,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::vec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::vec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, VEC4, location);
@@ -230,7 +230,7 @@ bool GLSLShader::SetUniform(std::string name, glm::vec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLuint x)
+bool GLSLShader::SetUniform(const std::string& name, GLuint x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UINT, location);
@@ -241,7 +241,7 @@ bool GLSLShader::SetUniform(std::string name, GLuint x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, GLint x)
+bool GLSLShader::SetUniform(const std::string& name, GLint x)
 {
     GLint location = 0;
     bool success = GetUniform(name, INT, location);
@@ -252,7 +252,7 @@ bool GLSLShader::SetUniform(std::string name, GLint x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC2, location);
@@ -263,7 +263,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC3, location);
@@ -274,7 +274,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::ivec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::ivec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, IVEC4, location);
@@ -285,7 +285,7 @@ bool GLSLShader::SetUniform(std::string name, glm::ivec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec2 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec2 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC2, location);
@@ -296,7 +296,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec2 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC3, location);
@@ -307,7 +307,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::uvec4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::uvec4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, UVEC4, location);
@@ -318,7 +318,7 @@ bool GLSLShader::SetUniform(std::string name, glm::uvec4 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::mat3 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::mat3 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, MAT3, location);
@@ -329,7 +329,7 @@ bool GLSLShader::SetUniform(std::string name, glm::mat3 x)
     return success;
 }
 
-bool GLSLShader::SetUniform(std::string name, glm::mat4 x)
+bool GLSLShader::SetUniform(const std::string& name, glm::mat4 x)
 {
     GLint location = 0;
     bool success = GetUniform(name, MAT4, location);
@@ -340,7 +340,82 @@ bool GLSLShader::SetUniform(std::string name, glm::mat4 x)
     return success;
 }
 
-bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& location)
+void GLSLShader::SetUniform(const GLSLUniformHandle<bool>& h, bool x)
+{
+    glUniform1i(h.location, (GLint)x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<GLuint>& h, GLuint x)
+{
+    glUniform1ui(h.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<GLint>& h, GLint x)
+{
+    glUniform1i(h.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<GLfloat>& h, GLfloat x)
+{
+    glUniform1f(h.location, x);
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::vec2>& h, glm::vec2 x)
+{
+    glUniform2fv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::vec3>& h, glm::vec3 x)
+{
+    glUniform3fv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::vec4>& h, glm::vec4 x)
+{
+    glUniform4fv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::ivec2>& h, glm::ivec2 x)
+{
+    glUniform2iv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::ivec3>& h, glm::ivec3 x)
+{
+    glUniform3iv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::ivec4>& h, glm::ivec4 x)
+{
+    glUniform4iv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::uvec2>& h, glm::uvec2 x)
+{
+    glUniform2uiv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::uvec3>& h, glm::uvec3 x)
+{
+    glUniform3uiv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::uvec4>& h, glm::uvec4 x)
+{
+    glUniform4uiv(h.location, 1, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::mat3>& h, const glm::mat3& x)
+{
+    glUniformMatrix3fv(h.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+void GLSLShader::SetUniform(const GLSLUniformHandle<glm::mat4>& h, const glm::mat4& x)
+{
+    glUniformMatrix4fv(h.location, 1, GL_FALSE, glm::value_ptr(x));
+}
+
+bool GLSLShader::GetUniform(const std::string& name, ParameterType type, GLint& location) const
 {
     for(unsigned int i = 0; i < uniforms.size(); i++)
         if(uniforms[i].name == name)
@@ -363,7 +438,7 @@ bool GLSLShader::GetUniform(std::string name, ParameterType type, GLint& locatio
     return false;
 }
 
-bool GLSLShader::GetAttribute(std::string name, ParameterType type, GLint& index)
+bool GLSLShader::GetAttribute(const std::string& name, ParameterType type, GLint& index)
 {
     for(unsigned int i = 0; i < attributes.size(); i++)
         if(attributes[i].name == name)
@@ -380,7 +455,7 @@ bool GLSLShader::GetAttribute(std::string name, ParameterType type, GLint& index
     return false;
 }
 
-bool GLSLShader::BindUniformBlock(std::string name, GLuint bindingPoint)
+bool GLSLShader::BindUniformBlock(const std::string& name, GLuint bindingPoint)
 {
     GLuint blockIndex = glGetUniformBlockIndex(program, name.c_str());
     if(blockIndex != GL_INVALID_INDEX)
@@ -397,7 +472,7 @@ bool GLSLShader::BindUniformBlock(std::string name, GLuint bindingPoint)
     }
 }
 
-bool GLSLShader::BindShaderStorageBlock(std::string name, GLuint bindingPoint)
+bool GLSLShader::BindShaderStorageBlock(const std::string& name, GLuint bindingPoint)
 {
     GLuint blockIndex = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, name.c_str());
     if(blockIndex != GL_INVALID_INDEX)
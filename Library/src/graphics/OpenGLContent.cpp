@@ -28,6 +28,7 @@
 #include <map>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include "core/SimulationApp.h"
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLState.h"
@@ -40,6 +41,8 @@
 #include "entities/forcefields/Atmosphere.h"
 #include "utils/SystemUtil.hpp"
 #include "utils/GeometryFileUtil.h"
+#include "utils/MeshCache.h"
+#include "utils/ImageCache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -59,6 +62,7 @@ OpenGLContent::OpenGLContent()
     baseVertexArray = 0;
     cubeBuf = 0;
     lightsUBO = 0;
+    instanceVBO = 0;
     csBuf[0] = 0;
     csBuf[1] = 0;
     cylinder.vao = 0;
@@ -68,12 +72,17 @@ OpenGLContent::OpenGLContent()
     viewDir = glm::vec3(1.f,0,0);
     viewProjection = glm::mat4();
     view = glm::mat4();
+    viewNormal = glm::mat3(1.f);
     projection = glm::mat4();
     FC = 0.f;
     viewportSize = glm::vec2(800.f,600.f);
     mode = DrawingMode::FULL;
     currentLookName = "";
     currentShaderMode = "plain";
+    currentShader = nullptr;
+    currentUniforms = nullptr;
+    shadowShader = nullptr;
+    flatShader = nullptr;
 
     //Get OpenGL capabilities
     maxAnisotropy = 0.0f;
@@ -199,6 +208,9 @@ OpenGLContent::OpenGLContent()
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
     glBindBufferRange(GL_UNIFORM_BUFFER, UBO_VIEW, viewUBO, 0, sizeof(ViewUBO));
     glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ViewUBO), &viewZero);
+
+    //Generate instance data VBO (attached to object VAOs)
+    glGenBuffers(1, &instanceVBO);
     
     //Load shaders
     //-----BASIC-----
@@ -234,7 +246,14 @@ OpenGLContent::OpenGLContent()
     basicShaders["flat"]->AddUniform("FC", ParameterType::FLOAT);
 
     basicShaders["shadow"] = new GLSLShader("shadow.frag", "shadow.vert");
-    basicShaders["shadow"]->AddUniform("MVP", ParameterType::MAT4);
+    basicShaders["shadow"]->AddUniform("VP", ParameterType::MAT4);
+
+    //Resolve uniforms used for every draw
+    flatShader = basicShaders["flat"];
+    flatMVP = flatShader->getUniformHandle<glm::mat4>("MVP");
+    flatFC = flatShader->getUniformHandle<GLfloat>("FC");
+    shadowShader = basicShaders["shadow"];
+    shadowVP = shadowShader->getUniformHandle<glm::mat4>("VP");
     
     //-----MATERIALS-----
     std::vector<std::string> shadingAlgorithms;
@@ -392,6 +411,8 @@ OpenGLContent::OpenGLContent()
             shader->AddUniform("M", ParameterType::MAT4);
             shader->AddUniform("N", ParameterType::MAT3);
             shader->AddUniform("MV", ParameterType::MAT3);
+            shader->AddUniform("VP", ParameterType::MAT4);
+            shader->AddUniform("VN", ParameterType::MAT3);
             shader->AddUniform("FC", ParameterType::FLOAT);
             shader->AddUniform("eyePos", ParameterType::VEC3);
             shader->AddUniform("viewDir", ParameterType::VEC3);
@@ -459,6 +480,23 @@ OpenGLContent::OpenGLContent()
         shader->AddUniform("reflectivity", ParameterType::FLOAT);
     }
 
+    //Resolve uniforms used for every draw
+    for(size_t i=0; i<materialShaders.size(); ++i)
+        for(auto& [key, shader] : materialShaders[i].shaders)
+        {
+            MaterialUniforms& mu = materialUniforms[shader];
+            mu.MVP = shader->getUniformHandle<glm::mat4>("MVP");
+            mu.M = shader->getUniformHandle<glm::mat4>("M");
+            mu.N = shader->getUniformHandle<glm::mat3>("N");
+            mu.MV = shader->getUniformHandle<glm::mat3>("MV");
+            mu.VP = shader->getUniformHandle<glm::mat4>("VP");
+            mu.VN = shader->getUniformHandle<glm::mat3>("VN");
+            mu.FC = shader->getUniformHandle<GLfloat>("FC");
+            mu.eyePos = shader->getUniformHandle<glm::vec3>("eyePos");
+            mu.viewDir = shader->getUniformHandle<glm::vec3>("viewDir");
+            mu.cableRadius = shader->getUniformHandle<GLfloat>("cableRadius");
+        }
+
     glDeleteShader(materialVertex);
     glDeleteShader(materialUvVertex);
     glDeleteShader(materialFragment);
@@ -499,10 +537,8 @@ OpenGLContent::OpenGLContent()
     //Add common uniforms
     for(size_t i=0; i<2; ++i)
     {
-        lightSourceShader[i]->AddUniform("MVP", ParameterType::MAT4);
-        lightSourceShader[i]->AddUniform("M", ParameterType::MAT4);
-        lightSourceShader[i]->AddUniform("N", ParameterType::MAT3);
-        lightSourceShader[i]->AddUniform("MV", ParameterType::MAT3);
+        lightSourceShader[i]->AddUniform("VP", ParameterType::MAT4);
+        lightSourceShader[i]->AddUniform("VN", ParameterType::MAT3);
         lightSourceShader[i]->AddUniform("FC", ParameterType::FLOAT);
         lightSourceShader[i]->AddUniform("eyePos", ParameterType::VEC3);
         lightSourceShader[i]->AddUniform("viewDir", ParameterType::VEC3);
@@ -547,6 +583,7 @@ OpenGLContent::~OpenGLContent()
     if(csBuf[0] != 0) glDeleteBuffers(2, csBuf);
     if(lightsUBO != 0) glDeleteBuffers(1, &lightsUBO);
     if(viewUBO != 0) glDeleteBuffers(1, &viewUBO);
+    if(instanceVBO != 0) glDeleteBuffers(1, &instanceVBO);
     delete basicShaders["helper"];
     delete basicShaders["tex_saq"];
     delete basicShaders["tex_quad"];
@@ -592,14 +629,19 @@ void OpenGLContent::DestroyContent()
     looks.clear();
     lookNameManager.ClearNames();
     currentLookName = "";
+    currentShader = nullptr;
+    currentUniforms = nullptr;
             
     for(size_t i=0; i<objects.size(); ++i)
     {
+        if(objects[i].geometryId != (int)i) //Shared geometry
+            continue;
         glDeleteBuffers(1, &objects[i].vboVertex);
         glDeleteBuffers(1, &objects[i].vboIndex);
         glDeleteVertexArrays(1, &objects[i].vao);
     }	
     objects.clear();
+    geometryLookup.clear();
 
     for(size_t i=0; i<views.size(); ++i)
 		delete views[i];
@@ -625,6 +667,7 @@ void OpenGLContent::SetProjectionMatrix(glm::mat4 P)
 void OpenGLContent::SetViewMatrix(glm::mat4 V)
 {
     view = V;
+    viewNormal = glm::mat3(glm::transpose(glm::inverse(view)));
     viewProjection = projection * view;
 }
 
@@ -638,6 +681,7 @@ void OpenGLContent::SetCurrentView(OpenGLView* v)
 	eyePos = v->GetEyePosition();
     viewDir = v->GetLookingDirection();
     view = v->GetViewMatrix();
+    viewNormal = glm::mat3(glm::transpose(glm::inverse(view)));
     projection = v->GetProjectionMatrix();
     viewProjection = projection * view;
     FC = v->GetLogDepthConstant();
@@ -860,16 +904,17 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
     {
         case DrawingMode::SHADOW:
         {
-            basicShaders["shadow"]->Use();
-            basicShaders["shadow"]->SetUniform("MVP", viewProjection*M);
+            shadowShader->Use();
+            shadowShader->SetUniform(shadowVP, viewProjection);
+            SetInstanceAttributes(M);
         }
         break;
         
         case DrawingMode::FLAT:
         {
-            basicShaders["flat"]->Use();
-            basicShaders["flat"]->SetUniform("MVP", viewProjection*M);
-            basicShaders["flat"]->SetUniform("FC", FC);
+            flatShader->Use();
+            flatShader->SetUniform(flatMVP, viewProjection*M);
+            flatShader->SetUniform(flatFC, FC);
         }
         break;
 
@@ -878,9 +923,10 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
         case DrawingMode::TEMPERATURE:
         {
             if(lookId < 0)
-                UseLook(getLook(looks.size()-1), false, M); // Use default look
+                UseLook(getLook(looks.size()-1), false); // Use default look
             else
-                UseLook(getLook(lookId), objects[objectId].texturable, M); // Use user defined look
+                UseLook(getLook(lookId), objects[objectId].texturable); // Use user defined look
+            SetInstanceAttributes(M);
         }
         break;
 
@@ -889,10 +935,123 @@ void OpenGLContent::DrawObject(int objectId, int lookId, const glm::mat4& M)
     }
 
     OpenGLState::BindVertexArray(objects[objectId].vao);
-    glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, 3 * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
+    OpenGLState::BindVertexArray(0);
+}
+
+void OpenGLContent::DrawObjectInstanced(int objectId, int lookId, const std::vector<glm::mat4>& M)
+{
+    if(objectId < 0 || objectId >= (int)objects.size() || M.empty())
+        return;
+
+    switch(mode)
+    {
+        case DrawingMode::SHADOW:
+        {
+            shadowShader->Use();
+            shadowShader->SetUniform(shadowVP, viewProjection);
+        }
+        break;
+
+        case DrawingMode::FULL:
+        case DrawingMode::UNDERWATER:
+        case DrawingMode::TEMPERATURE:
+        {
+            if(lookId < 0)
+                UseLook(getLook(looks.size()-1), false); // Use default look
+            else
+                UseLook(getLook(lookId), objects[objectId].texturable); // Use user defined look
+        }
+        break;
+
+        case DrawingMode::FLAT:
+        case DrawingMode::RAW: //Shaders without per-instance attributes
+        {
+            for(size_t i=0; i<M.size(); ++i)
+                DrawObject(objectId, lookId, M[i]);
+        }
+        return;
+    }
+
+    //Upload per-instance data (orphaning the previous buffer)
+    instanceData.resize(M.size());
+    for(size_t i=0; i<M.size(); ++i)
+    {
+        instanceData[i].M = M[i];
+        instanceData[i].N = glm::mat3(glm::transpose(glm::inverse(M[i])));
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * instanceData.size(), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(InstanceData) * instanceData.size(), instanceData.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    //Attribute pointers are stored in the VAO, only enabling them is needed
+    OpenGLState::BindVertexArray(objects[objectId].vao);
+    for(GLuint i=0; i<7; ++i)
+        glEnableVertexAttribArray(ATTRIB_INSTANCE_M + i);
+    glDrawElementsInstanced(GL_TRIANGLES, 3 * objects[objectId].faceCount, GL_UNSIGNED_INT, 0, (GLsizei)M.size());
+    for(GLuint i=0; i<7; ++i)
+        glDisableVertexAttribArray(ATTRIB_INSTANCE_M + i);
     OpenGLState::BindVertexArray(0);
 }
 
+void OpenGLContent::DrawObjectGroups(const std::vector<Renderable>& renderables, const std::vector<size_t>& indices)
+{
+    //Looks do not matter when rendering depth only
+    bool useLooks = mode == DrawingMode::FULL || mode == DrawingMode::UNDERWATER || mode == DrawingMode::TEMPERATURE;
+
+    instanceOrder.clear();
+    for(size_t i=0; i<indices.size(); ++i)
+        if(renderables[indices[i]].type == RenderableType::SOLID)
+            instanceOrder.push_back(indices[i]);
+
+    //Sort by look and geometry, keeping the original order within groups
+    std::stable_sort(instanceOrder.begin(), instanceOrder.end(), [&](size_t a, size_t b)
+    {
+        int lookA = useLooks ? renderables[a].lookId : -1;
+        int lookB = useLooks ? renderables[b].lookId : -1;
+        if(lookA != lookB)
+            return lookA < lookB;
+        return getGeometryId(renderables[a].objectId) < getGeometryId(renderables[b].objectId);
+    });
+
+    //Draw groups
+    size_t i = 0;
+    while(i < instanceOrder.size())
+    {
+        const Renderable& r = renderables[instanceOrder[i]];
+        int lookId = useLooks ? r.lookId : -1;
+        int geometryId = getGeometryId(r.objectId);
+        
+        size_t j = i + 1;
+        while(j < instanceOrder.size()
+              && (useLooks ? renderables[instanceOrder[j]].lookId : -1) == lookId
+              && getGeometryId(renderables[instanceOrder[j]].objectId) == geometryId)
+            ++j;
+
+        if(j - i == 1)
+            DrawObject(r.objectId, r.lookId, r.model);
+        else
+        {
+            instanceMatrices.clear();
+            for(size_t k=i; k<j; ++k)
+                instanceMatrices.push_back(renderables[instanceOrder[k]].model);
+            DrawObjectInstanced(r.objectId, r.lookId, instanceMatrices);
+        }
+        i = j;
+    }
+}
+
+void OpenGLContent::SetInstanceAttributes(const glm::mat4& M)
+{
+    //Constant attribute values are used when the instance arrays are disabled
+    glm::mat3 N = glm::mat3(glm::transpose(glm::inverse(M)));
+    for(GLuint i=0; i<4; ++i)
+        glVertexAttrib4fv(ATTRIB_INSTANCE_M + i, &M[i][0]);
+    for(GLuint i=0; i<3; ++i)
+        glVertexAttrib3fv(ATTRIB_INSTANCE_N + i, &N[i][0]);
+}
+
 void OpenGLContent::DrawLightSource(unsigned int lightId)
 {
     if(lightId >= lights.size())
@@ -912,10 +1071,8 @@ void OpenGLContent::DrawLightSource(unsigned int lightId)
 
         GLSLShader* shader = mode == DrawingMode::FULL ? lightSourceShader[0] : lightSourceShader[1];
         shader->Use();
-        shader->SetUniform("MVP", viewProjection * M);
-        shader->SetUniform("M", M);
-        shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-        shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
+        shader->SetUniform("VP", viewProjection);
+        shader->SetUniform("VN", viewNormal);
         shader->SetUniform("FC", FC);
         shader->SetUniform("eyePos", eyePos);
         shader->SetUniform("viewDir", viewDir);
@@ -929,8 +1086,9 @@ void OpenGLContent::DrawLightSource(unsigned int lightId)
             shader->SetUniform("bWater", ocean->getOpenGLOcean()->getLightScattering());
         }
 
+        SetInstanceAttributes(M);
         OpenGLState::BindVertexArray(objects[objectId].vao);
-        glDrawElements(GL_TRIANGLES, sizeof(Face) * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, 3 * objects[objectId].faceCount, GL_UNSIGNED_INT, 0);
         OpenGLState::BindVertexArray(0);
     }
     else
@@ -1007,7 +1165,7 @@ void OpenGLContent::SetupLights()
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
-void OpenGLContent::UseLook(const Look& look, bool texturable, const glm::mat4& M)
+void OpenGLContent::UseLook(const Look& look, bool texturable)
 {	
     bool waves = false;
     Ocean* ocean = SimulationApp::getApp()->getSimulationManager()->getOcean();
@@ -1054,20 +1212,23 @@ void OpenGLContent::UseLook(const Look& look, bool texturable, const glm::mat4&
             break;
     }
     
-    bool updateMaterial = (look.name != currentLookName) || (currentShaderMode != shaderMode);
-    currentLookName = look.name;
-    currentShaderMode = shaderMode;
+    bool updateMaterial = (look.name != currentLookName) || (currentShaderMode != shaderMode) || (currentShader == nullptr);
+    if(updateMaterial)
+    {
+        currentLookName = look.name;
+        currentShaderMode = shaderMode;
+        currentShader = materialShaders[look.type == LookType::SIMPLE ? 0 : 1].shaders[currentShaderMode];
+        currentUniforms = &materialUniforms[currentShader];
+    }
     
-    GLSLShader* shader = materialShaders[look.type == LookType::SIMPLE ? 0 : 1].shaders[currentShaderMode];
-
+    GLSLShader* shader = currentShader;
+    const MaterialUniforms& mu = *currentUniforms;
     shader->Use();
-    shader->SetUniform("MVP", viewProjection*M);
-    shader->SetUniform("M", M);
-    shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view*M))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    shader->SetUniform(mu.VP, viewProjection);
+    shader->SetUniform(mu.VN, viewNormal);
+    shader->SetUniform(mu.FC, FC);
+    shader->SetUniform(mu.eyePos, eyePos);
+    shader->SetUniform(mu.viewDir, viewDir);
 
     if(updateMaterial)
     {
@@ -1182,21 +1343,26 @@ void OpenGLContent::UseCableLook(const Look& look, GLfloat radius)
             break;
     }
     
-    bool updateMaterial = (look.name != currentLookName) || (currentShaderMode != shaderMode);
-    currentLookName = look.name;
-    currentShaderMode = shaderMode;
+    bool updateMaterial = (look.name != currentLookName) || (currentShaderMode != shaderMode) || (currentShader == nullptr);
+    if(updateMaterial)
+    {
+        currentLookName = look.name;
+        currentShaderMode = shaderMode;
+        currentShader = materialShaders[look.type == LookType::SIMPLE ? 0 : 1].shaders[currentShaderMode];
+        currentUniforms = &materialUniforms[currentShader];
+    }
     
-    GLSLShader* shader = materialShaders[look.type == LookType::SIMPLE ? 0 : 1].shaders[currentShaderMode];
-
+    GLSLShader* shader = currentShader;
+    const MaterialUniforms& mu = *currentUniforms;
     shader->Use();
-    shader->SetUniform("MVP", viewProjection);
-    shader->SetUniform("M", glm::mat4(1.f));
-    shader->SetUniform("N", glm::mat3(1.f));
-    shader->SetUniform("MV", glm::mat3(glm::transpose(glm::inverse(view))));
-    shader->SetUniform("FC", FC);
-    shader->SetUniform("cableRadius", radius);
-    shader->SetUniform("eyePos", eyePos);
-    shader->SetUniform("viewDir", viewDir);
+    shader->SetUniform(mu.MVP, viewProjection);
+    shader->SetUniform(mu.M, glm::mat4(1.f));
+    shader->SetUniform(mu.N, glm::mat3(1.f));
+    shader->SetUniform(mu.MV, glm::mat3(glm::transpose(glm::inverse(view))));
+    shader->SetUniform(mu.FC, FC);
+    shader->SetUniform(mu.cableRadius, radius);
+    shader->SetUniform(mu.eyePos, eyePos);
+    shader->SetUniform(mu.viewDir, viewDir);
 
     if(updateMaterial)
     {
@@ -1279,15 +1445,79 @@ void OpenGLContent::UseCableLook(const Look& look, GLfloat radius)
     }
 }
 
-unsigned int OpenGLContent::BuildObject(Mesh* mesh)
+unsigned int OpenGLContent::BuildObject(const Mesh* mesh)
 {
     Object obj;
     
+    obj.faceCount = (GLsizei)mesh->faces.size();
+    obj.texturable = false;
+    obj.bsCenter = glm::vec3(0.f);
+    obj.bsRadius = 0.f;
+    if(mesh->getNumOfVertices() > 0)
+        AABS(mesh, obj.bsRadius, obj.bsCenter); //Used for view culling
+
+    //Share buffers between objects built from identical meshes (enables instancing)
+    GLsizeiptr vertexBytes = (GLsizeiptr)mesh->getVertexSize() * mesh->getNumOfVertices();
+    GLsizeiptr indexBytes = (GLsizeiptr)(sizeof(Face) * mesh->faces.size());
+    const uint8_t* vertexData = (const uint8_t*)mesh->getVertexDataPointer();
+    const uint8_t* indexData = mesh->faces.empty() ? nullptr : (const uint8_t*)&mesh->faces[0].vertexID[0];
+    
+    uint64_t hash = 14695981039346656037ULL; //FNV-1a
+    auto hashBytes = [&hash](const uint8_t* data, GLsizeiptr size)
+    {
+        for(GLsizeiptr i=0; i<size; ++i)
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+    };
+    GLsizeiptr layout[3] = {(GLsizeiptr)mesh->getVertexSize(), vertexBytes, indexBytes};
+    hashBytes((const uint8_t*)layout, sizeof(layout));
+    hashBytes(vertexData, vertexBytes);
+    hashBytes(indexData, indexBytes);
+
+    auto it = geometryLookup.find(hash);
+    if(it != geometryLookup.end() && obj.faceCount > 0)
+    {
+        //Verify that the data is identical (hash collisions)
+        const Object& owner = objects[it->second];
+        GLint ownerVertexBytes = 0;
+        GLint ownerIndexBytes = 0;
+        glBindBuffer(GL_ARRAY_BUFFER, owner.vboVertex);
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &ownerVertexBytes);
+        glBindBuffer(GL_ARRAY_BUFFER, owner.vboIndex);
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &ownerIndexBytes);
+        
+        bool identical = owner.faceCount == obj.faceCount && owner.texturable == mesh->isTexturable()
+                         && ownerVertexBytes == vertexBytes && ownerIndexBytes == indexBytes;
+        if(identical)
+        {
+            std::vector<uint8_t> ownerData(std::max(vertexBytes, indexBytes));
+            glBindBuffer(GL_ARRAY_BUFFER, owner.vboVertex);
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, ownerData.data());
+            identical = memcmp(ownerData.data(), vertexData, vertexBytes) == 0;
+            if(identical)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, owner.vboIndex);
+                glGetBufferSubData(GL_ARRAY_BUFFER, 0, indexBytes, ownerData.data());
+                identical = memcmp(ownerData.data(), indexData, indexBytes) == 0;
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if(identical)
+        {
+            obj.vao = owner.vao;
+            obj.vboVertex = owner.vboVertex;
+            obj.vboIndex = owner.vboIndex;
+            obj.texturable = owner.texturable;
+            obj.geometryId = (int)it->second;
+            objects.push_back(obj);
+            return (unsigned int)objects.size()-1;
+        }
+    }
+    
     glGenVertexArrays(1, &obj.vao);
     glGenBuffers(1, &obj.vboVertex);
     glGenBuffers(1, &obj.vboIndex);
-    obj.faceCount = (GLsizei)mesh->faces.size();
-    obj.texturable = false;
+    obj.geometryId = (int)objects.size();
     
     OpenGLState::BindVertexArray(obj.vao);	
     glEnableVertexAttribArray(0); //Position
@@ -1308,12 +1538,26 @@ unsigned int OpenGLContent::BuildObject(Mesh* mesh)
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, mesh->getVertexSize(), (void*)(sizeof(glm::vec3)*2));
         glVertexAttribPointer(3, 3, GL_FLOAT, GL_TRUE,  mesh->getVertexSize(), (void*)(sizeof(glm::vec3)*2 + sizeof(glm::vec2)));
     }
+
+    //Per-instance attributes (disabled unless drawing instanced)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for(GLuint i=0; i<4; ++i)
+    {
+        glVertexAttribPointer(ATTRIB_INSTANCE_M + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(sizeof(glm::vec4)*i));
+        glVertexAttribDivisor(ATTRIB_INSTANCE_M + i, 1);
+    }
+    for(GLuint i=0; i<3; ++i)
+    {
+        glVertexAttribPointer(ATTRIB_INSTANCE_N + i, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(sizeof(glm::mat4) + sizeof(glm::vec3)*i));
+        glVertexAttribDivisor(ATTRIB_INSTANCE_N + i, 1);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj.vboIndex);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Face) * mesh->faces.size(), &mesh->faces[0].vertexID[0], GL_STATIC_DRAW);
     OpenGLState::BindVertexArray(0);
     
+    geometryLookup[hash] = (unsigned int)objects.size();
     objects.push_back(obj);
     return (unsigned int)objects.size()-1;
 }
@@ -1431,6 +1675,13 @@ const Object& OpenGLContent::getObject(size_t id)
     return objects[id];
 }
 
+int OpenGLContent::getGeometryId(int objectId) const
+{
+    if(objectId < 0 || objectId >= (int)objects.size())
+        return objectId;
+    return objects[objectId].geometryId;
+}
+
 const Look& OpenGLContent::getLook(size_t id)
 {
     if(id >= looks.size())
@@ -1446,19 +1697,20 @@ GLuint OpenGLContent::LoadTexture(const std::string& filename, bool srgb, bool a
     int reqChannels = alpha ? 4 : 3;
     GLuint texture;
     
-    // Allocate image; fail out on error
+    // Allocate image (or take over a prefetched one); fail out on error
     stbi_set_flip_vertically_on_load(true);
+    unsigned char* dataBuffer = internal ? nullptr : (unsigned char*)ImageCache::Take(filename, reqChannels, false, width, height, channels);
 #ifdef EMBEDDED_RESOURCES
-    unsigned char* dataBuffer;
     if(internal)
     {
         ResourceHandle rh(filename);
         dataBuffer = stbi_load_from_memory(rh.data(), rh.size(), &width, &height, &channels, reqChannels);
     }
-    else
+    else if(dataBuffer == nullptr)
         dataBuffer = stbi_load(filename.c_str(), &width, &height, &channels, reqChannels);
 #else
-    unsigned char* dataBuffer = stbi_load(filename.c_str(), &width, &height, &channels, reqChannels);
+    if(dataBuffer == nullptr)
+        dataBuffer = stbi_load(filename.c_str(), &width, &height, &channels, reqChannels);
 #endif
     if(dataBuffer == NULL)
     {
@@ -2562,16 +2814,10 @@ Mesh* OpenGLContent::BuildTerrain(GLfloat* heightfield, int sizeX, int sizeY, GL
 
 Mesh* OpenGLContent::LoadMesh(const std::string& filename, GLfloat scale, bool smooth)
 {
-    Mesh* mesh = LoadGeometryFromFile(filename, scale);
-    CheckAndRepairFaceVertexOrder(mesh);
-
+    std::shared_ptr<const Mesh> mesh = MeshCache::Get(filename, scale, smooth);
     if(mesh == nullptr)
         abort();
-    if(smooth)
-        SmoothNormals(mesh);
-    if(mesh->isTexturable())
-        ComputeTangents((TexturableMesh*)mesh);
-    return mesh;
+    return MeshCache::Copy(mesh.get());
 }
 
 void OpenGLContent::TransformMesh(Mesh* mesh, const Transform& T)
@@ -2933,7 +3179,7 @@ void OpenGLContent::AABB(Mesh* mesh, glm::vec3& min, glm::vec3& max)
     max = glm::vec3(maxX, maxY, maxZ);
 }
 
-void OpenGLContent::AABS(Mesh* mesh, GLfloat& bsRadius, glm::vec3& bsCenterOffset)
+void OpenGLContent::AABS(const Mesh* mesh, GLfloat& bsRadius, glm::vec3& bsCenterOffset)
 {
     glm::vec3 tempCenter(0,0,0);
     
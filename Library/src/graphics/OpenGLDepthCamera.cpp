@@ -30,6 +30,7 @@
 #include "sensors/vision/Camera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -54,7 +55,7 @@ OpenGLDepthCamera::OpenGLDepthCamera(glm::vec3 eyePosition, glm::vec3 direction,
     range.x = minDepth;
     range.y = maxDepth;
     usesRanges = useRanges;
-    linearDepthPBO = 0;
+    linearDepthReadback = nullptr;
     
     SetupCamera(eyePosition, direction, cameraUp);
     UpdateTransform();
@@ -123,10 +124,8 @@ OpenGLDepthCamera::~OpenGLDepthCamera()
     glDeleteTextures(1, &linearDepthTex);
     glDeleteFramebuffers(1, &linearDepthFBO);
 
-    if(camera != nullptr)
-    {
-        glDeleteBuffers(1, &linearDepthPBO);
-    }
+    if(linearDepthReadback != nullptr)
+        delete linearDepthReadback;
 }
 
 void OpenGLDepthCamera::SetupCamera(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -146,15 +145,16 @@ void OpenGLDepthCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
-        GLfloat* src = (GLfloat*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(linearDepthReadback->AcquireLatest())
         {
-            camera->NewDataReady(src, idx);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            GLfloat* src = (GLfloat*)linearDepthReadback->Map();
+            if(src)
+            {
+                camera->NewDataReady(src, idx);
+                linearDepthReadback->Unmap();
+            }
         }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = linearDepthReadback->isPending();
     }
 }
 
@@ -229,10 +229,8 @@ void OpenGLDepthCamera::setCamera(Camera* cam, unsigned int index)
     camera = cam;
     idx = index;
 
-    glGenBuffers(1, &linearDepthPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * sizeof(GLfloat), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(linearDepthReadback == nullptr)
+        linearDepthReadback = new OpenGLReadbackBuffer(viewportWidth * viewportHeight * sizeof(GLfloat));
 }
 
 void OpenGLDepthCamera::setNoise(GLfloat depthStdDev)
@@ -254,12 +252,8 @@ void OpenGLDepthCamera::ComputeOutput(std::vector<Renderable>& objects)
     OpenGLState::Viewport(0, 0, viewportWidth, viewportHeight);
     glClear(GL_DEPTH_BUFFER_BIT);
     glDisable(GL_DEPTH_CLAMP);
-    for(size_t h=0; h<objects.size(); ++h)
-    {
-        if(objects[h].type != RenderableType::SOLID)
-            continue;
-        content->DrawObject(objects[h].objectId, -1, objects[h].model);
-    }
+    CullObjects(objects, GetProjectionMatrix() * GetViewMatrix(), true, visibleObjects);
+    content->DrawObjectGroups(objects, visibleObjects);
     glEnable(GL_DEPTH_CLAMP);
     OpenGLState::BindFramebuffer(0);
 }
@@ -345,9 +339,10 @@ void OpenGLDepthCamera::DrawLDR(GLuint destinationFBO, bool updated)
         }
                 
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, linearDepthTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, linearDepthPBO);
+        linearDepthReadback->BeginWrite();
+        linearDepthReadback->BindForWriting();
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        linearDepthReadback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
@@ -29,6 +29,7 @@
 #include "sensors/vision/EventBasedCamera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -49,6 +50,7 @@ OpenGLEventBasedCamera::OpenGLEventBasedCamera(glm::vec3 eyePosition, glm::vec3
     lastSimTime = -1.f;
     continuous = continuousUpdate;
     camera = nullptr;
+    outputReadback = nullptr;
     C_ = C;
     Tr_ = Tr;
     sigmaC_ = glm::vec2(0.f);
@@ -114,8 +116,8 @@ OpenGLEventBasedCamera::~OpenGLEventBasedCamera()
     glDeleteFramebuffers(1, &displayFBO);
     glDeleteTextures(1, &displayTex);
 
-    if(camera != nullptr)
-        glDeleteBuffers(1, &outputPBO);    
+    if(outputReadback != nullptr)
+        delete outputReadback;
 }
 
 ViewType OpenGLEventBasedCamera::getType() const
@@ -142,11 +144,9 @@ bool OpenGLEventBasedCamera::needsUpdate()
 void OpenGLEventBasedCamera::setCamera(EventBasedCamera* cam)
 {
     //Connect with camera sensor
-    camera = cam;    
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, maxNumEvents * 2 * sizeof(GLint), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    camera = cam;
+    if(outputReadback == nullptr)
+        outputReadback = new OpenGLReadbackBuffer({(GLsizeiptr)(maxNumEvents * 2 * sizeof(GLint)), (GLsizeiptr)sizeof(GLuint)});
 }
 
 void OpenGLEventBasedCamera::setNoise(glm::vec2 sigmaC)
@@ -190,21 +190,25 @@ void OpenGLEventBasedCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, renderEventCounter);
-        GLuint* pEventCounter = (GLuint*)glMapBuffer(GL_ATOMIC_COUNTER_BUFFER, GL_READ_ONLY);
-        GLuint lastEventCount = *pEventCounter;
-        glUnmapBuffer(GL_ATOMIC_COUNTER_BUFFER);
-        glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        GLint* src = (GLint*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(outputReadback->AcquireLatest())
         {
-            camera->NewDataReady(src, lastEventCount);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            //The event count is copied together with the events, so that it matches the frame
+            GLuint lastEventCount = 0;
+            GLuint* pEventCounter = (GLuint*)outputReadback->Map(1);
+            if(pEventCounter)
+            {
+                lastEventCount = *pEventCounter;
+                outputReadback->Unmap();
+            }
+
+            GLint* src = (GLint*)outputReadback->Map(0);
+            if(src)
+            {
+                camera->NewDataReady(src, lastEventCount);
+                outputReadback->Unmap();
+            }
         }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = outputReadback->isPending();
     }
 }
 
@@ -325,9 +329,16 @@ void OpenGLEventBasedCamera::DrawLDR(GLuint destinationFBO, bool updated)
     if(camera != nullptr && updated)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, renderEventTex[0]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
+        outputReadback->BeginWrite();
+        outputReadback->BindForWriting(0);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RG_INTEGER, GL_INT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_COPY_READ_BUFFER, renderEventCounter);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, outputReadback->getWriteBuffer(1));
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(GLuint));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        outputReadback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
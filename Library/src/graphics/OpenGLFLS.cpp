@@ -32,6 +32,7 @@
 #include "sensors/vision/FLS.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -297,23 +298,23 @@ void OpenGLFLS::UpdateTransform()
     //Inform sonar to run callback
     if(newData_)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO_);
-        void* src = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(readback_->AcquireLatest())
         {
-            sonar_->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            void* src = readback_->Map(1);
+            if(src)
+            {
+                sonar_->NewDataReady(src, 0);
+                readback_->Unmap();
+            }
+            
+            src = readback_->Map(0);
+            if(src)
+            {
+                sonar_->NewDataReady(src, 1);
+                readback_->Unmap();
+            }
         }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO_);
-        src = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            sonar_->NewDataReady(src, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData_ = false;
+        newData_ = readback_->isPending();
     }
 }
 
@@ -326,32 +327,7 @@ void OpenGLFLS::setSonar(FLS* s)
 {
     sonar_ = s;
 
-    glGenBuffers(1, &outputPBO_);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO_);
-    switch (outputFormat_)
-    {
-        case SonarOutputFormat::U8:
-            glBufferData(GL_PIXEL_PACK_BUFFER, nBeams_ * nBins_ * sizeof(GLubyte), 0, GL_STREAM_READ);
-            break;
-        case SonarOutputFormat::U16:
-            glBufferData(GL_PIXEL_PACK_BUFFER, nBeams_ * nBins_ * sizeof(GLushort), 0, GL_STREAM_READ);
-            break;
-        case SonarOutputFormat::U32:
-            glBufferData(GL_PIXEL_PACK_BUFFER, nBeams_ * nBins_ * sizeof(GLuint), 0, GL_STREAM_READ);
-            break;
-        case SonarOutputFormat::F32:
-            glBufferData(GL_PIXEL_PACK_BUFFER, nBeams_ * nBins_ * sizeof(GLfloat), 0, GL_STREAM_READ);
-            break;
-    }
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glBufferData(GL_PIXEL_PACK_BUFFER, nBeams_ * nBins_ , 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO_);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO_);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    AllocateReadback(nBeams_ * nBins_);
 }
 
 void OpenGLFLS::ComputeOutput(std::vector<Renderable>& objects)
@@ -367,7 +343,6 @@ void OpenGLFLS::ComputeOutput(std::vector<Renderable>& objects)
     sonarInputShader_[1]->SetUniform("eyePos", GetEyePosition());
     sonarInputShader_[0]->Use();
     sonarInputShader_[0]->SetUniform("eyePos", GetEyePosition());
-    GLSLShader* shader;
     for(size_t i=0; i<views_.size(); ++i) //For each of the sonar views
     {
         //Clear color and depth for particular framebuffer layer
@@ -375,25 +350,26 @@ void OpenGLFLS::ComputeOutput(std::vector<Renderable>& objects)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         //Calculate view transform
         glm::mat4 VP = GetProjectionMatrix() * views_[i].view * GetViewMatrix();
-        //Draw objects
-        for(size_t h=0; h<objects.size(); ++h)
+        //Draw objects (only the ones inside of the view)
+        sonarInputShader_[1]->Use();
+        sonarInputShader_[1]->SetUniform(sonarInputVP_[1], VP);
+        sonarInputShader_[0]->Use();
+        sonarInputShader_[0]->SetUniform(sonarInputVP_[0], VP);
+        CullObjects(objects, VP, true, visibleObjects);
+        for(size_t h=0; h<visibleObjects.size(); ++h)
         {
-            if(objects[h].type != RenderableType::SOLID)
+            const Renderable& r = objects[visibleObjects[h]];
+            if(r.type != RenderableType::SOLID)
                 continue;
-            const Object& obj = content->getObject(objects[h].objectId);
-            const Look& look = content->getLook(objects[h].lookId);
-            glm::mat4 M = objects[h].model;
-            Material mat = SimulationApp::getApp()->getSimulationManager()->getMaterialManager()->getMaterial(objects[h].materialName);
+            const Object& obj = content->getObject(r.objectId);
+            const Look& look = content->getLook(r.lookId);
             bool normalMapping = obj.texturable && (look.normalMap > 0);
-            shader = normalMapping ? sonarInputShader_[1] : sonarInputShader_[0];
-            shader->Use();
-            shader->SetUniform("MVP", VP * M);
-            shader->SetUniform("M", M);
-            shader->SetUniform("N", glm::mat3(glm::transpose(glm::inverse(M))));
-            shader->SetUniform("restitution", (GLfloat)mat.restitution);
+            size_t s = normalMapping ? 1 : 0;
+            sonarInputShader_[s]->Use();
+            sonarInputShader_[s]->SetUniform(sonarInputObjectIndex_[s], (GLuint)visibleObjects[h]);
             if(normalMapping)
                 OpenGLState::BindTexture(TEX_MAT_NORMAL, GL_TEXTURE_2D, look.normalMap);
-            content->DrawObject(objects[h].objectId, objects[h].lookId, objects[h].model);
+            content->DrawObject(r.objectId, r.lookId, r.model);
         }
     }
     glEnable(GL_DEPTH_CLAMP);
@@ -481,7 +457,8 @@ void OpenGLFLS::DrawLDR(GLuint destinationFBO, bool updated)
     if(sonar_ != nullptr && updated)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, outputTex_[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO_);
+        readback_->BeginWrite();
+        readback_->BindForWriting(0);
         switch (outputFormat_)
         {
             case SonarOutputFormat::U8:
@@ -497,12 +474,11 @@ void OpenGLFLS::DrawLDR(GLuint destinationFBO, bool updated)
                 glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, NULL);
                 break;
         }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex_);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO_);
+        readback_->BindForWriting(1);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback_->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData_ = true;
     }
@@ -24,8 +24,10 @@
 
 #include "graphics/OpenGLFisheyeCamera.h"
 
+#include <numeric>
 #include "core/GraphicalSimulationApp.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLContent.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLState.h"
@@ -59,7 +61,7 @@ OpenGLFisheyeCamera::OpenGLFisheyeCamera(glm::vec3 eyePosition, glm::vec3 direct
     displayTex = 0;
     outputFBO = 0;
     displayFBO = 0;
-    outputPBO = 0;
+    outputReadback = nullptr;
     currentView = glm::mat4(1.f);
     currentProj = glm::mat4(1.f);
     continuous = continuousUpdate;
@@ -112,10 +114,7 @@ OpenGLFisheyeCamera::OpenGLFisheyeCamera(glm::vec3 eyePosition, glm::vec3 direct
     fboTextures.push_back(FBOTexture(GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, displayTex));
     displayFBO = OpenGLContent::GenerateFramebuffer(fboTextures);
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    outputReadback = new OpenGLReadbackBuffer(viewportWidth * viewportHeight * 3);
 }
 
 OpenGLFisheyeCamera::~OpenGLFisheyeCamera()
@@ -127,7 +126,8 @@ OpenGLFisheyeCamera::~OpenGLFisheyeCamera()
     glDeleteTextures(1, &displayTex);
     glDeleteFramebuffers(1, &outputFBO);
     glDeleteFramebuffers(1, &displayFBO);
-    glDeleteBuffers(1, &outputPBO);
+    if(outputReadback != nullptr)
+        delete outputReadback;
 }
 
 void OpenGLFisheyeCamera::Init()
@@ -223,15 +223,16 @@ void OpenGLFisheyeCamera::UpdateTransform()
 
     if(newData && camera != nullptr)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(outputReadback->AcquireLatest())
         {
-            camera->NewDataReady(src);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            GLubyte* src = (GLubyte*)outputReadback->Map();
+            if(src)
+            {
+                camera->NewDataReady(src);
+                outputReadback->Unmap();
+            }
         }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = outputReadback->isPending();
     }
 }
 
@@ -366,18 +367,19 @@ void OpenGLFisheyeCamera::RenderFace(int faceIndex, std::vector<Renderable>& obj
     bool oceanEnabled = (ocean != nullptr) && ocean->isRenderable() && (rSettings.ocean > RenderQuality::DISABLED);
     bool underwater = oceanEnabled && (ocean->GetDepth(eye) > 0.f);
 
+    visibleObjects.resize(objects.size());
+    std::iota(visibleObjects.begin(), visibleObjects.end(), 0);
     auto drawObjects = [&]()
     {
         for(size_t i=0; i<objects.size(); ++i)
         {
-            if(objects[i].type == RenderableType::SOLID)
-                content->DrawObject(objects[i].objectId, objects[i].lookId, objects[i].model);
-            else if(objects[i].type == RenderableType::CABLE)
+            if(objects[i].type == RenderableType::CABLE)
             {
                 auto nodes = objects[i].getDataAsCableNodes();
                 content->DrawCable(objects[i].objectId, objects[i].model[0][0], *nodes, objects[i].lookId);
             }
         }
+        content->DrawObjectGroups(objects, visibleObjects);
     };
 
     // Render scene with (optional) ocean/atmosphere effects, following the main pipeline structure.
@@ -498,9 +500,10 @@ void OpenGLFisheyeCamera::ComputeOutput(std::vector<Renderable>& objects, Ocean*
     if(camera != nullptr)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
+        outputReadback->BeginWrite();
+        outputReadback->BindForWriting();
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        outputReadback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
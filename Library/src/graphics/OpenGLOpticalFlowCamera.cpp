@@ -30,6 +30,7 @@
 #include "sensors/vision/Camera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -49,6 +50,7 @@ OpenGLOpticalFlowCamera::OpenGLOpticalFlowCamera(glm::vec3 eyePosition, glm::vec
     continuous = continuousUpdate;
     newData = false;
     camera = nullptr;
+    readback = nullptr;
     noiseVel = glm::vec2(0.f);
     maxVel = width/2.f;
     this->range = range;
@@ -121,11 +123,8 @@ OpenGLOpticalFlowCamera::~OpenGLOpticalFlowCamera()
     glDeleteVertexArrays(1, &displayVAO);
     glDeleteBuffers(1, &displayVBO);
 
-    if(camera != nullptr)
-    {
-        glDeleteBuffers(1, &outputPBO);
-        glDeleteBuffers(1, &displayPBO);
-    }
+    if(readback != nullptr)
+        delete readback;
 }
 
 void OpenGLOpticalFlowCamera::SetupCamera(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -145,23 +144,23 @@ void OpenGLOpticalFlowCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(readback->AcquireLatest())
         {
-            camera->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            GLubyte* src = (GLubyte*)readback->Map(1);
+            if(src)
+            {
+                camera->NewDataReady(src, 0);
+                readback->Unmap();
+            }
+            
+            GLfloat* src2 = (GLfloat*)readback->Map(0);
+            if(src2)
+            {
+                camera->NewDataReady(src2, 1);
+                readback->Unmap();
+            }
         }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        GLfloat* src2 = (GLfloat*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src2)
-        {
-            camera->NewDataReady(src2, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = readback->isPending();
     }
 }
 
@@ -235,15 +234,9 @@ void OpenGLOpticalFlowCamera::setCamera(Camera* cam, unsigned int index)
 {
     camera = cam;
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 2 * sizeof(GLfloat), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3 * sizeof(GLubyte), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(readback == nullptr)
+        readback = new OpenGLReadbackBuffer({(GLsizeiptr)(viewportWidth * viewportHeight * 2 * sizeof(GLfloat)),
+                                             (GLsizeiptr)(viewportWidth * viewportHeight * 3 * sizeof(GLubyte))});
 }
 
 void OpenGLOpticalFlowCamera::setNoise(glm::vec2 velStdDev)
@@ -295,16 +288,18 @@ void OpenGLOpticalFlowCamera::ComputeOutput(std::vector<Renderable>& objects)
         opticalFlowCameraOutputShader->SetUniform("w_c", glm::vec3(0.f));
     }
 
-    for(size_t i=0; i<objects.size(); ++i)
+    CullObjects(objects, VP, false, visibleObjects);
+    for(size_t i=0; i<visibleObjects.size(); ++i)
     {
-        if(objects[i].type != RenderableType::SOLID)
+        const Renderable& r = objects[visibleObjects[i]];
+        if(r.type != RenderableType::SOLID)
             continue;
-        opticalFlowCameraOutputShader->SetUniform("MVP", VP * objects[i].model);
-        opticalFlowCameraOutputShader->SetUniform("M", objects[i].model);
-        opticalFlowCameraOutputShader->SetUniform("P_b", objects[i].cor);
-        opticalFlowCameraOutputShader->SetUniform("v_b", objects[i].vel);
-        opticalFlowCameraOutputShader->SetUniform("w_b", objects[i].avel);
-        content->DrawObject(objects[i].objectId, -1, objects[i].model);
+        opticalFlowCameraOutputShader->SetUniform("MVP", VP * r.model);
+        opticalFlowCameraOutputShader->SetUniform("M", r.model);
+        opticalFlowCameraOutputShader->SetUniform("P_b", r.cor);
+        opticalFlowCameraOutputShader->SetUniform("v_b", r.vel);
+        opticalFlowCameraOutputShader->SetUniform("w_b", r.avel);
+        content->DrawObject(r.objectId, -1, r.model);
     }
 
     //Flip image
@@ -359,13 +354,13 @@ void OpenGLOpticalFlowCamera::DrawLDR(GLuint destinationFBO, bool updated)
     if(camera != nullptr && updated)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, renderFlowTex[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
+        readback->BeginWrite();
+        readback->BindForWriting(0);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RG, GL_FLOAT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayFlowTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
+        readback->BindForWriting(1);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
@@ -26,6 +26,7 @@
 #include "graphics/OpenGLPipeline.h"
 
 #include <algorithm>
+#include <numeric>
 #include "core/SimulationManager.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
@@ -45,6 +46,7 @@
 #include "graphics/OpenGLLight.h"
 #include "graphics/OpenGLOceanParticles.h"
 #include "utils/SystemUtil.hpp"
+#include "utils/Profiler.h"
 #include "entities/forcefields/Ocean.h"
 #include "entities/forcefields/Atmosphere.h"
 #include "core/GraphicalSimulationApp.h"
@@ -197,6 +199,8 @@ void OpenGLPipeline::PerformDrawingQueueCopy(SimulationManager* sim)
 
     //Sort objects by material to reduce uniform/texture switching
     std::sort(drawingQueueCopy.begin(), drawingQueueCopy.end(), Renderable::SortByMaterial);
+    queueIndices.resize(drawingQueueCopy.size());
+    std::iota(queueIndices.begin(), queueIndices.end(), 0);
 }
 
 void OpenGLPipeline::DrawDisplay()
@@ -208,18 +212,44 @@ void OpenGLPipeline::DrawDisplay()
 
 void OpenGLPipeline::DrawObjects()
 {
-    for(size_t i=0; i<drawingQueueCopy.size(); ++i)
+    DrawObjects(queueIndices);
+}
+
+void OpenGLPipeline::DrawObjects(const std::vector<size_t>& indices)
+{
+    //Consecutive solids sharing geometry and look are drawn with instancing,
+    //other renderables keep their place in the queue
+    solidRun.clear();
+    for(size_t i=0; i<indices.size(); ++i)
     {
-		if (drawingQueueCopy[i].type == RenderableType::SOLID)
-        {
-			content->DrawObject(drawingQueueCopy[i].objectId, drawingQueueCopy[i].lookId, drawingQueueCopy[i].model);
-        }
-        else if(drawingQueueCopy[i].type == RenderableType::CABLE)
+        const Renderable& r = drawingQueueCopy[indices[i]];
+        if(r.type == RenderableType::SOLID)
+            solidRun.push_back(indices[i]);
+        else
         {
-            auto nodes = drawingQueueCopy[i].getDataAsCableNodes();
-            content->DrawCable(drawingQueueCopy[i].objectId, drawingQueueCopy[i].model[0][0], *nodes, drawingQueueCopy[i].lookId);
+            if(solidRun.size() > 0)
+            {
+                content->DrawObjectGroups(drawingQueueCopy, solidRun);
+                solidRun.clear();
+            }
+            DrawRenderable(r);
         }
     }
+    if(solidRun.size() > 0)
+        content->DrawObjectGroups(drawingQueueCopy, solidRun);
+}
+
+void OpenGLPipeline::DrawRenderable(const Renderable& r)
+{
+    if(r.type == RenderableType::SOLID)
+    {
+        content->DrawObject(r.objectId, r.lookId, r.model);
+    }
+    else if(r.type == RenderableType::CABLE)
+    {
+        auto nodes = r.getDataAsCableNodes();
+        content->DrawCable(r.objectId, r.model[0][0], *nodes, r.lookId);
+    }
 }
 
 void OpenGLPipeline::DrawLights()
@@ -353,6 +383,8 @@ void OpenGLPipeline::DrawHelpers()
 
 void OpenGLPipeline::Render(SimulationManager* sim)
 {	
+    PROFILE_ZONE("Render");
+
     //Update time step for animation purposes
     Scalar now = sim->getSimulationTime();
     Scalar dt = now-lastSimTime;
@@ -377,6 +409,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
     content->SetupLights();
     if(rSettings.shadows > RenderQuality::DISABLED)
     {
+        PROFILE_ZONE("Shadow maps");
         glCullFace(GL_FRONT);
         glDisable(GL_DEPTH_CLAMP);
         content->SetDrawingMode(DrawingMode::SHADOW);
@@ -443,6 +476,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
     }
 
     //Loop through all views -> trackballs, cameras, depth cameras...
+    bool sonarDataUpdated = false; //Object data shared by all sonars
     for(unsigned int i=0; i<updateCount; ++i)
     {  
         OpenGLState::EnableDepthTest();
@@ -454,6 +488,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
         { 
             case ViewType::DEPTH_CAMERA:
             {
+                PROFILE_ZONE("Depth camera");
                 OpenGLDepthCamera* camera = static_cast<OpenGLDepthCamera*>(view);
                 //Draw objects and compute depth data
                 camera->ComputeOutput(drawingQueueCopy);
@@ -464,6 +499,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
 
             case ViewType::THERMAL_CAMERA:
             {
+                PROFILE_ZONE("Thermal camera");
                 OpenGLThermalCamera* camera = static_cast<OpenGLThermalCamera*>(view);
                 glm::vec3 eye = camera->GetEyePosition();
 
@@ -497,13 +533,14 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                     
                     camera->SetViewport();
                     content->SetCurrentView(camera);
+                    camera->CullObjects(drawingQueueCopy, camera->GetProjectionMatrix() * camera->GetViewMatrix(), false, visibleQueue);
                     
                     //Draw scene
                     if(renderMode == 0) //NO OCEAN
                     {
                         //Render all objects
                         content->SetDrawingMode(DrawingMode::TEMPERATURE);
-                        DrawObjects();
+                        DrawObjects(visibleQueue);
                     
                         //Render sky (at the end to take profit of early bailing)
                         atm->getOpenGLAtmosphere()->DrawSkyAndSunTemperature(camera);
@@ -522,7 +559,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                         //Draw all objects as above surface 
                         //(depth testing will secure drawing only what is above water)
                         content->SetDrawingMode(DrawingMode::TEMPERATURE);
-                        DrawObjects();
+                        DrawObjects(visibleQueue);
                         
                         //Render sky (left for the end to only fill empty spaces)
                         atm->getOpenGLAtmosphere()->DrawSkyAndSunTemperature(camera);
@@ -538,6 +575,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
 
             case ViewType::OPTICAL_FLOW_CAMERA:
             {
+                PROFILE_ZONE("Optical flow camera");
                 OpenGLOpticalFlowCamera* camera = static_cast<OpenGLOpticalFlowCamera*>(view);
                 //Draw objects and compute camera data
                 camera->ComputeOutput(drawingQueueCopy);
@@ -548,6 +586,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
 
             case ViewType::SEGMENTATION_CAMERA:
             {
+                PROFILE_ZONE("Segmentation camera");
                 OpenGLSegmentationCamera* camera = static_cast<OpenGLSegmentationCamera*>(view);
                 //Draw objects and compute camera data
                 camera->ComputeOutput(drawingQueueCopy, ocean);
@@ -558,7 +597,13 @@ void OpenGLPipeline::Render(SimulationManager* sim)
             
             case ViewType::SONAR:
             {
+                PROFILE_ZONE("Sonar");
                 OpenGLSonar* sonar = static_cast<OpenGLSonar*>(view);
+                if(!sonarDataUpdated)
+                {
+                    OpenGLSonar::UpdateObjectData(drawingQueueCopy);
+                    sonarDataUpdated = true;
+                }
                 //Draw objects and compute sonar data
                 sonar->ComputeOutput(drawingQueueCopy);
                 //Draw sonar output
@@ -568,6 +613,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
 
             case ViewType::FISHEYE_CAMERA:
             {
+                PROFILE_ZONE("Fisheye camera");
                 OpenGLFisheyeCamera* camera = static_cast<OpenGLFisheyeCamera*>(view);
                 camera->ComputeOutput(drawingQueueCopy, ocean);
                 camera->DrawLDR(screenFBO, true);
@@ -578,6 +624,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
             case ViewType::TRACKBALL:
             case ViewType::EVENT_BASED_CAMERA:
             {
+                PROFILE_ZONE("Camera");
                 //Apply view properties
                 OpenGLCamera* camera = static_cast<OpenGLCamera*>(view);
                 OpenGLLight::SetCamera(camera);
@@ -599,13 +646,14 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                 
                 camera->SetViewport();
                 content->SetCurrentView(camera);
+                camera->CullObjects(drawingQueueCopy, camera->GetProjectionMatrix() * camera->GetViewMatrix(), false, visibleQueue);
                 
                 //Draw scene
                 if(renderMode == 0) //NO OCEAN
                 {
                     //Render all objects
                     content->SetDrawingMode(DrawingMode::FULL);
-                    DrawObjects();
+                    DrawObjects(visibleQueue);
                     DrawLights();
 
                     //Ambient occlusion
@@ -629,7 +677,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                     if(ocean->GetDepth(eye) > 0.0) //Underwater
                     {  
                         content->SetDrawingMode(DrawingMode::UNDERWATER);
-                        DrawObjects();
+                        DrawObjects(visibleQueue);
                         glOcean->DrawBackground(camera);
                         glOcean->DrawBacksurface(camera);
                         //camera->GenerateBloom();
@@ -646,7 +694,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                             glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
                             glCullFace(GL_FRONT);
                             content->SetDrawingMode(DrawingMode::FLAT);
-                            DrawObjects();
+                            DrawObjects(visibleQueue);
                             glCullFace(GL_BACK);
                             glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
                             camera->GenerateLinearDepth(false);
@@ -667,7 +715,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                     else //Above water
                     {
                         content->SetDrawingMode(DrawingMode::UNDERWATER);
-                        DrawObjects();
+                        DrawObjects(visibleQueue);
                         DrawLights();
                         glOcean->DrawBackground(camera);
 
@@ -689,7 +737,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                         //(depth testing will secure drawing only what is above water)
                         camera->SetRenderBuffers(0, true, false); //Color + Normal
                         content->SetDrawingMode(DrawingMode::FULL);
-                        DrawObjects();
+                        DrawObjects(visibleQueue);
                         DrawLights();
                     
                         //Render sky (left for the end to only fill empty spaces)
@@ -707,7 +755,7 @@ void OpenGLPipeline::Render(SimulationManager* sim)
                             glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
                             glCullFace(GL_FRONT);
                             content->SetDrawingMode(DrawingMode::FLAT);
-                            DrawObjects();
+                            DrawObjects(visibleQueue);
                             glCullFace(GL_BACK);
                             glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
                             camera->GenerateLinearDepth(false);
@@ -776,11 +824,13 @@ void OpenGLPipeline::Render(SimulationManager* sim)
         }
     }
     //Draw views that are displayed but not updated
+    Profiler::BeginZone("Views not updated");
     for(size_t i=0; i<viewsNoUpdate.size(); ++i)
     {
         OpenGLView* view = content->getView(viewsNoUpdate[i]);
         view->DrawLDR(screenFBO, false);
     }
+    Profiler::EndZone();
     //Remove views drawn in this frame
     viewsQueue.erase(viewsQueue.begin(), viewsQueue.begin() + updateCount);
 }
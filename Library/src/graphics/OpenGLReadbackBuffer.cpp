@@ -0,0 +1,162 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  OpenGLReadbackBuffer.cpp
+//  Stonefish
+//
+
+#include "graphics/OpenGLReadbackBuffer.h"
+
+namespace sf
+{
+
+OpenGLReadbackBuffer::OpenGLReadbackBuffer(GLsizeiptr size, unsigned int depth)
+{
+    Allocate(std::vector<GLsizeiptr>(1, size), depth);
+}
+
+OpenGLReadbackBuffer::OpenGLReadbackBuffer(const std::vector<GLsizeiptr>& sizes, unsigned int depth)
+{
+    Allocate(sizes, depth);
+}
+
+OpenGLReadbackBuffer::~OpenGLReadbackBuffer()
+{
+    for(size_t i=0; i<frames.size(); ++i)
+    {
+        if(frames[i].fence != 0)
+            glDeleteSync(frames[i].fence);
+        glDeleteBuffers((GLsizei)frames[i].pbos.size(), frames[i].pbos.data());
+    }
+}
+
+void OpenGLReadbackBuffer::Allocate(const std::vector<GLsizeiptr>& sizes, unsigned int depth)
+{
+    bufferSizes = sizes;
+    frames.resize(depth < 2 ? 2 : depth);
+    first = 0;
+    count = 0;
+    writing = 0;
+    reading = 0;
+    mapped = false;
+
+    for(size_t i=0; i<frames.size(); ++i)
+    {
+        frames[i].fence = 0;
+        frames[i].pbos.resize(bufferSizes.size());
+        glGenBuffers((GLsizei)bufferSizes.size(), frames[i].pbos.data());
+        for(size_t h=0; h<bufferSizes.size(); ++h)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, frames[i].pbos[h]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, bufferSizes[h], 0, GL_STREAM_READ);
+        }
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OpenGLReadbackBuffer::DropOldest()
+{
+    if(count == 0)
+        return;
+    glDeleteSync(frames[first].fence);
+    frames[first].fence = 0;
+    first = (first + 1) % frames.size();
+    --count;
+}
+
+void OpenGLReadbackBuffer::BeginWrite()
+{
+    //Make space for the new frame --> the data is never older than the ring depth
+    if(count == frames.size())
+        DropOldest();
+    writing = (first + count) % frames.size();
+}
+
+void OpenGLReadbackBuffer::BindForWriting(unsigned int buffer)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, frames[writing].pbos[buffer]);
+}
+
+void OpenGLReadbackBuffer::EndWrite()
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    frames[writing].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++count;
+}
+
+bool OpenGLReadbackBuffer::AcquireLatest()
+{
+    //Find the newest frame that was already transferred (frames complete in order)
+    unsigned int completed = 0;
+    for(unsigned int i=0; i<count; ++i)
+    {
+        const Frame& f = frames[(first + i) % frames.size()];
+        GLenum status = glClientWaitSync(f.fence, i == 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        completed = i + 1;
+    }
+    if(completed == 0)
+        return false;
+
+    //Skip the outdated frames
+    for(unsigned int i=0; i<completed-1; ++i)
+        DropOldest();
+    reading = first;
+    DropOldest();
+    return true;
+}
+
+void* OpenGLReadbackBuffer::Map(unsigned int buffer)
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, frames[reading].pbos[buffer]);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bufferSizes[buffer], GL_MAP_READ_BIT);
+    if(data == nullptr)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return nullptr;
+    }
+    mapped = true;
+    return data;
+}
+
+void OpenGLReadbackBuffer::Unmap()
+{
+    if(!mapped)
+        return;
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    mapped = false;
+}
+
+GLuint OpenGLReadbackBuffer::getWriteBuffer(unsigned int buffer) const
+{
+    return frames[writing].pbos[buffer];
+}
+
+bool OpenGLReadbackBuffer::isPending() const
+{
+    return count > 0;
+}
+
+unsigned int OpenGLReadbackBuffer::getDepth() const
+{
+    return (unsigned int)frames.size();
+}
+
+}
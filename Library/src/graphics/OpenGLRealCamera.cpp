@@ -29,6 +29,7 @@
 #include "sensors/vision/ColorCamera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -45,6 +46,7 @@ OpenGLRealCamera::OpenGLRealCamera(glm::vec3 eyePosition, glm::vec3 direction, g
     continuous = continuousUpdate;
     camera = NULL;
     cameraFBO = 0;
+    cameraReadback = nullptr;
     
     //Setup view
     SetupCamera(eyePosition, direction, cameraUp);
@@ -61,7 +63,7 @@ OpenGLRealCamera::~OpenGLRealCamera()
     if(camera != NULL)
     {
         glDeleteFramebuffers(1, &cameraFBO);
-        glDeleteBuffers(1, &cameraPBO);
+        delete cameraReadback;
         glDeleteTextures(2, cameraColorTex);
     }
 }
@@ -102,10 +104,7 @@ void OpenGLRealCamera::setCamera(ColorCamera* cam)
     textures.push_back(FBOTexture(GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, cameraColorTex[1]));
     cameraFBO = OpenGLContent::GenerateFramebuffer(textures);
     
-    glGenBuffers(1, &cameraPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3, 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    cameraReadback = new OpenGLReadbackBuffer(viewportWidth * viewportHeight * 3);
 }
 
 glm::vec3 OpenGLRealCamera::GetEyePosition() const
@@ -144,15 +143,16 @@ void OpenGLRealCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(cameraReadback->AcquireLatest())
         {
-            camera->NewDataReady(src);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            GLubyte* src = (GLubyte*)cameraReadback->Map();
+            if(src)
+            {
+                camera->NewDataReady(src);
+                cameraReadback->Unmap();
+            }
         }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = cameraReadback->isPending();
     }
 }
 
@@ -183,9 +183,10 @@ void OpenGLRealCamera::DrawLDR(GLuint destinationFBO, bool updated)
         OpenGLState::BindFramebuffer(0);
 
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, cameraColorTex[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, cameraPBO);
+        cameraReadback->BeginWrite();
+        cameraReadback->BindForWriting();
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        cameraReadback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
@@ -33,17 +33,15 @@
 #include "graphics/OpenGLAtmosphere.h"
 #include "graphics/OpenGLConsole.h"
 #include "utils/SystemUtil.hpp"
+#include "entities/forcefields/WaveField.h"
 
 namespace sf
 {
 
-OpenGLRealOcean::OpenGLRealOcean(GLfloat size, GLfloat state, SDL_mutex* hydrodynamics) : OpenGLOcean(size)
+OpenGLRealOcean::OpenGLRealOcean(GLfloat size, GLfloat state, const WaveField* waves) : OpenGLOcean(size, waves->getResolution())
 {
-    hydroMutex = hydrodynamics;
-    params.wind = state*5.f + 2.f;
-    params.A = 1.f;
-    params.omega = 5.f*expf(-state) + 0.2f;
-    GLint layers = 4;    
+    waveField = waves;
+    WaveField::SetSeaState(params, state);
     qtGridTessFactor = 8; // Patch tessellation [2, 256]
     qtGPUTessFactor = 0;  // GPU tessellation factor [0,5]
     qtPatchIndexCount = 0;
@@ -190,16 +188,6 @@ OpenGLRealOcean::OpenGLRealOcean(GLfloat size, GLfloat state, SDL_mutex* hydrody
     oceanShaders["mask"]->AddUniform("u_gpu_tess_factor", ParameterType::FLOAT);
     oceanShaders["mask"]->BindShaderStorageBlock("QTreeCull", SSBO_QTREE_CULL);
 
-    //FFT data transfer
-    size_t fftDataSize = params.fftSize * params.fftSize * 4 * layers;
-    fftData = new GLfloat[fftDataSize];
-    memset(fftData, 0, sizeof(GLfloat) * fftDataSize);
-    
-    glGenBuffers(1, &fftPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, fftPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, params.fftSize * params.fftSize * 4 * layers * sizeof(GLfloat), fftData, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
     //Quad tree buffers
     glGenBuffers(2, oceanBuffers);
 	//Grid vertex data (ARRAY) x2
@@ -257,7 +245,6 @@ OpenGLRealOcean::OpenGLRealOcean(GLfloat size, GLfloat state, SDL_mutex* hydrody
 OpenGLRealOcean::~OpenGLRealOcean()
 {
     glDeleteBuffers(2, oceanBuffers);
-    glDeleteBuffers(1, &fftPBO);
 	glDeleteVertexArrays(1, &vao);
     for(std::map<OpenGLView*, OceanQT>::iterator it=oceanTrees.begin(); it!=oceanTrees.end(); ++it)
     {
@@ -267,7 +254,6 @@ OpenGLRealOcean::~OpenGLRealOcean()
         glDeleteBuffers(1, &it->second.patchAC);
     }
     oceanTrees.clear();
-    delete fftData;
 }
 
 void OpenGLRealOcean::setWireframe(bool enabled)
@@ -280,82 +266,15 @@ void OpenGLRealOcean::InitializeSimulation()
     OpenGLOcean::InitializeSimulation();
 }
 
-GLfloat OpenGLRealOcean::ComputeInterpolatedWaveData(GLfloat x, GLfloat y, GLuint channel)
-{
-    //BILINEAR INTERPOLATION ACCORDING TO OPENGL SPECIFICATION (4.5)
-    //Calculate pixel cooridnates
-    //x and y are already divided by the phyiscal dimensions of the texture (represented area in [m])
-    //so they are directly texture coordinates
-    float tmp;
-    
-    //First coordinate pair
-    float i0f = modff(x - 0.5f/(float)params.fftSize, &tmp);
-    float j0f = modff(y - 0.5f/(float)params.fftSize, &tmp);
-    if(i0f < 0.f) i0f = 1.f - fabsf(i0f);
-    if(j0f < 0.f) j0f = 1.f - fabsf(j0f);
-    int i0 = (int)truncf(i0f * (float)params.fftSize);
-    int j0 = (int)truncf(j0f * (float)params.fftSize);
-    
-    //Second coordinate pair
-    float i1f = modff(x + 0.5f/(float)params.fftSize, &tmp);
-    float j1f = modff(y + 0.5f/(float)params.fftSize, &tmp);
-    if(i1f < 0.f) i1f = 1.f - fabsf(i1f);
-    if(j1f < 0.f) j1f = 1.f - fabsf(j1f);
-    int i1 = (int)truncf(i1f * (float)params.fftSize);
-    int j1 = (int)truncf(j1f * (float)params.fftSize);
-    
-    //Calculate weigths
-    float alpha = modff(i0f * (float)params.fftSize, &tmp);
-    float beta = modff(j0f * (float)params.fftSize, &tmp);
-    
-    //Get texel values
-    float t[4];
-    t[0] = fftData[(j0 * params.fftSize + i0) * 4 + channel];
-    t[1] = fftData[(j0 * params.fftSize + i1) * 4 + channel];
-    t[2] = fftData[(j1 * params.fftSize + i0) * 4 + channel];
-    t[3] = fftData[(j1 * params.fftSize + i1) * 4 + channel];
-    
-    //Interpolate
-    float h = (1.f - alpha)*(1.f - beta)*t[0] + alpha*(1.f - beta)*t[1] + (1.f - alpha)*beta*t[2] + alpha*beta*t[3];
-    
-    return h;
-}
-    
 GLfloat OpenGLRealOcean::ComputeWaveHeight(GLfloat x, GLfloat y)
 {
-    //Z,X are reversed because the coordinate system used to draw ocean has Z axis pointing up!
-    GLfloat z = 0.f;
-    z -= ComputeInterpolatedWaveData(x/params.gridSizes.x, y/params.gridSizes.x, 0);
-    z -= ComputeInterpolatedWaveData(x/params.gridSizes.y, y/params.gridSizes.y, 1);
-    //The components below have low importance and were excluded to lower the computational cost
-    //z -= ComputeInterpolatedWaveData(x/params.gridSizes.z, y/params.gridSizes.z, 2);
-    //z -= ComputeInterpolatedWaveData(x/params.gridSizes.w, y/params.gridSizes.w, 3);
-    return z;
+    return waveField->ComputeWaveHeight(x, y);
 }
 
 void OpenGLRealOcean::Simulate(GLfloat dt)
 {
-    if(SDL_TryLockMutex(hydroMutex) == 0)
-    {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, fftPBO);
-        GLfloat* src = (GLfloat*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
-        {
-            memcpy(fftData, src, params.fftSize * params.fftSize * 4 * 4 * sizeof(GLfloat));
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        SDL_UnlockMutex(hydroMutex);
-    }
-
+    //Hydrodynamics use the CPU wave field, no readback of the wave textures needed
     OpenGLOcean::Simulate(dt);
-
-    //Copy wave data to RAM for hydrodynamic computations
-    OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D_ARRAY, oceanTextures[3]);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, fftPBO);
-    glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_FLOAT, NULL);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-    OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
 }
 
 void OpenGLRealOcean::ResetSurface(OpenGLView* view)
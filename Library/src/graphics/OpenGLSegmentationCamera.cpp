@@ -30,6 +30,7 @@
 #include "sensors/vision/Camera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 #include "entities/forcefields/Ocean.h"
@@ -50,6 +51,7 @@ OpenGLSegmentationCamera::OpenGLSegmentationCamera(glm::vec3 eyePosition, glm::v
     continuous = continuousUpdate;
     newData = false;
     camera = nullptr;
+    readback = nullptr;
     this->range = range;
     
     SetupCamera(eyePosition, direction, cameraUp);
@@ -120,11 +122,8 @@ OpenGLSegmentationCamera::~OpenGLSegmentationCamera()
     glDeleteVertexArrays(1, &displayVAO);
     glDeleteBuffers(1, &displayVBO);
 
-    if(camera != nullptr)
-    {
-        glDeleteBuffers(1, &outputPBO);
-        glDeleteBuffers(1, &displayPBO);
-    }
+    if(readback != nullptr)
+        delete readback;
 }
 
 void OpenGLSegmentationCamera::SetupCamera(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -144,23 +143,23 @@ void OpenGLSegmentationCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(readback->AcquireLatest())
         {
-            camera->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            GLubyte* src = (GLubyte*)readback->Map(1);
+            if(src)
+            {
+                camera->NewDataReady(src, 0);
+                readback->Unmap();
+            }
+            
+            GLushort* src2 = (GLushort*)readback->Map(0);
+            if(src2)
+            {
+                camera->NewDataReady(src2, 1);
+                readback->Unmap();
+            }
         }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        GLushort* src2 = (GLushort*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src2)
-        {
-            camera->NewDataReady(src2, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = readback->isPending();
     }
 }
 
@@ -234,15 +233,9 @@ void OpenGLSegmentationCamera::setCamera(Camera* cam, unsigned int index)
 {
     camera = cam;
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * sizeof(GLushort), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3 * sizeof(GLubyte), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(readback == nullptr)
+        readback = new OpenGLReadbackBuffer({(GLsizeiptr)(viewportWidth * viewportHeight * sizeof(GLushort)),
+                                             (GLsizeiptr)(viewportWidth * viewportHeight * 3 * sizeof(GLubyte))});
 }
 
 ViewType OpenGLSegmentationCamera::getType() const
@@ -266,14 +259,16 @@ void OpenGLSegmentationCamera::ComputeOutput(std::vector<Renderable>& objects, O
     segmentationCameraOutputShader->Use();
     segmentationCameraOutputShader->SetUniform("FC", GetLogDepthConstant());
     
-    for(size_t i=0; i<objects.size(); ++i)
+    CullObjects(objects, VP, false, visibleObjects);
+    for(size_t i=0; i<visibleObjects.size(); ++i)
     {
-        if(objects[i].type != RenderableType::SOLID && objects[i].objectId >= 0)
+        const Renderable& r = objects[visibleObjects[i]];
+        if(r.type != RenderableType::SOLID && r.objectId >= 0)
             continue;
-        segmentationCameraOutputShader->SetUniform("MVP", VP * objects[i].model);
-        segmentationCameraOutputShader->SetUniform("M", objects[i].model);
-        segmentationCameraOutputShader->SetUniform("objectId", (GLuint)objects[i].objectId+1);
-        content->DrawObject(objects[i].objectId, -1, objects[i].model);
+        segmentationCameraOutputShader->SetUniform("MVP", VP * r.model);
+        segmentationCameraOutputShader->SetUniform("M", r.model);
+        segmentationCameraOutputShader->SetUniform("objectId", (GLuint)r.objectId+1);
+        content->DrawObject(r.objectId, -1, r.model);
     }
 
     if(ocean != nullptr && ocean->GetDepth(eye) > 0.f)
@@ -333,13 +328,13 @@ void OpenGLSegmentationCamera::DrawLDR(GLuint destinationFBO, bool updated)
     if(camera != nullptr && updated)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, renderSegTex[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
+        readback->BeginWrite();
+        readback->BindForWriting(0);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displaySegTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
+        readback->BindForWriting(1);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
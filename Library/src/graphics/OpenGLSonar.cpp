@@ -31,6 +31,7 @@
 #include "core/MaterialManager.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -38,7 +39,12 @@ namespace sf
 {
 
 GLSLShader* OpenGLSonar::sonarInputShader_[2] = {nullptr, nullptr};
+GLSLUniformHandle<glm::mat4> OpenGLSonar::sonarInputVP_[2];
+GLSLUniformHandle<GLuint> OpenGLSonar::sonarInputObjectIndex_[2];
 GLSLShader* OpenGLSonar::sonarVisualizeShader_[2] = {nullptr, nullptr};
+GLuint OpenGLSonar::objectDataSSBO_ = 0;
+size_t OpenGLSonar::objectDataCapacity_ = 0;
+std::vector<SonarObjectData> OpenGLSonar::objectData_;
 
 OpenGLSonar::OpenGLSonar(glm::vec3 eyePosition, glm::vec3 direction, glm::vec3 sonarUp, glm::uvec2 displayResolution, glm::vec2 range, SonarOutputFormat outputFormat)
     : OpenGLView(0, 0, displayResolution.x, displayResolution.y), randDist_(0.f, 1.f)
@@ -49,8 +55,7 @@ OpenGLSonar::OpenGLSonar(glm::vec3 eyePosition, glm::vec3 direction, glm::vec3 s
     range_ = range;
     gain_ = 1.f;
     settingsUpdated_ = true;
-    outputPBO_ = 0;
-    displayPBO_ = 0;
+    readback_ = nullptr;
     fov_ = glm::vec2(1.0);
     cMap_ = ColorMap::GREEN_BLUE;
     outputFormat_ = outputFormat;
@@ -66,8 +71,31 @@ OpenGLSonar::~OpenGLSonar()
     glDeleteFramebuffers(1, &displayFBO_);
     glDeleteVertexArrays(1, &displayVAO_);
     glDeleteBuffers(1, &displayVBO_);
-    if(outputPBO_ != 0) glDeleteBuffers(1, &outputPBO_);
-    if(displayPBO_ != 0) glDeleteBuffers(1, &displayPBO_);
+    if(readback_ != nullptr) delete readback_;
+}
+
+size_t OpenGLSonar::getSampleSize(SonarOutputFormat format)
+{
+    switch(format)
+    {
+        case SonarOutputFormat::U16:
+            return sizeof(GLushort);
+        case SonarOutputFormat::U32:
+            return sizeof(GLuint);
+        case SonarOutputFormat::F32:
+            return sizeof(GLfloat);
+        case SonarOutputFormat::U8:
+        default:
+            return sizeof(GLubyte);
+    }
+}
+
+void OpenGLSonar::AllocateReadback(GLuint nSamples)
+{
+    GLsizeiptr sampleSize = (GLsizeiptr)getSampleSize(outputFormat_);
+    if(readback_ != nullptr)
+        delete readback_;
+    readback_ = new OpenGLReadbackBuffer({(GLsizeiptr)nSamples * sampleSize, (GLsizeiptr)(viewportWidth * viewportHeight * 3)});
 }
 
 void OpenGLSonar::SetupSonar(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -170,19 +198,22 @@ ViewType OpenGLSonar::getType() const
 void OpenGLSonar::Init()
 {
     sonarInputShader_[0] = new GLSLShader("sonarInput.frag", "sonarInput.vert");
-    sonarInputShader_[0]->AddUniform("MVP", ParameterType::MAT4);
-    sonarInputShader_[0]->AddUniform("M", ParameterType::MAT4);
-    sonarInputShader_[0]->AddUniform("N", ParameterType::MAT3);
+    sonarInputShader_[0]->AddUniform("VP", ParameterType::MAT4);
+    sonarInputShader_[0]->AddUniform("objectIndex", ParameterType::UINT);
     sonarInputShader_[0]->AddUniform("eyePos", ParameterType::VEC3);
-    sonarInputShader_[0]->AddUniform("restitution", ParameterType::FLOAT);
+    sonarInputShader_[0]->BindShaderStorageBlock("SonarObjects", SSBO_SONAR_OBJECTS);
     
     sonarInputShader_[1] = new GLSLShader("sonarInputUv.frag", "sonarInputUv.vert");
-    sonarInputShader_[1]->AddUniform("MVP", ParameterType::MAT4);
-    sonarInputShader_[1]->AddUniform("M", ParameterType::MAT4);
-    sonarInputShader_[1]->AddUniform("N", ParameterType::MAT3);
+    sonarInputShader_[1]->AddUniform("VP", ParameterType::MAT4);
+    sonarInputShader_[1]->AddUniform("objectIndex", ParameterType::UINT);
     sonarInputShader_[1]->AddUniform("eyePos", ParameterType::VEC3);
-    sonarInputShader_[1]->AddUniform("restitution", ParameterType::FLOAT);
     sonarInputShader_[1]->AddUniform("texNormal", ParameterType::INT);
+    sonarInputShader_[1]->BindShaderStorageBlock("SonarObjects", SSBO_SONAR_OBJECTS);
+    for(size_t i=0; i<2; ++i)
+    {
+        sonarInputVP_[i] = sonarInputShader_[i]->getUniformHandle<glm::mat4>("VP");
+        sonarInputObjectIndex_[i] = sonarInputShader_[i]->getUniformHandle<GLuint>("objectIndex");
+    }
     sonarInputShader_[1]->Use();
     sonarInputShader_[1]->SetUniform("texNormal", TEX_MAT_NORMAL);
     OpenGLState::UseProgram(0);
@@ -202,6 +233,42 @@ void OpenGLSonar::Destroy()
     if(sonarInputShader_[1] != nullptr) delete sonarInputShader_[1];
     if(sonarVisualizeShader_[0] != nullptr) delete sonarVisualizeShader_[0];
     if(sonarVisualizeShader_[1] != nullptr) delete sonarVisualizeShader_[1];
+    if(objectDataSSBO_ != 0) glDeleteBuffers(1, &objectDataSSBO_);
+    objectDataSSBO_ = 0;
+    objectDataCapacity_ = 0;
+}
+
+void OpenGLSonar::UpdateObjectData(const std::vector<Renderable>& objects)
+{
+    if(objects.size() == 0)
+        return;
+
+    MaterialManager* mm = SimulationApp::getApp()->getSimulationManager()->getMaterialManager();
+    objectData_.resize(objects.size());
+    for(size_t i=0; i<objects.size(); ++i)
+    {
+        SonarObjectData& data = objectData_[i];
+        if(objects[i].type != RenderableType::SOLID) //Not drawn by sonars
+            continue;
+        data.M = objects[i].model;
+        glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(objects[i].model)));
+        data.N[0] = glm::vec4(N[0], 0.f);
+        data.N[1] = glm::vec4(N[1], 0.f);
+        data.N[2] = glm::vec4(N[2], 0.f);
+        data.restitution = (GLfloat)mm->getMaterial(objects[i].materialId).restitution;
+    }
+
+    if(objectDataSSBO_ == 0)
+        glGenBuffers(1, &objectDataSSBO_);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectDataSSBO_);
+    if(objects.size() > objectDataCapacity_) //Grow buffer
+    {
+        objectDataCapacity_ = objects.size() * 2;
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(SonarObjectData) * objectDataCapacity_, NULL, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(SonarObjectData) * objects.size(), &objectData_[0]);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SSBO_SONAR_OBJECTS, objectDataSSBO_);
 }
 
 }
@@ -30,6 +30,7 @@
 #include "sensors/vision/Camera.h"
 #include "graphics/OpenGLState.h"
 #include "graphics/GLSLShader.h"
+#include "graphics/OpenGLReadbackBuffer.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
 
@@ -45,6 +46,7 @@ OpenGLThermalCamera::OpenGLThermalCamera(glm::vec3 eyePosition, glm::vec3 direct
  : OpenGLView(originX, originY, width, height), camera(nullptr), _needsUpdate(false), newData(false), temperatureNoise(0.f), randDist(0.f, 1.f)
 {
     continuous = continuousUpdate;
+    readback = nullptr;
     this->depthRange = depthRange;
     temperatureRange = displayRange = tempRange;
     colorMap = ColorMap::JET;
@@ -116,11 +118,8 @@ OpenGLThermalCamera::~OpenGLThermalCamera()
     glDeleteVertexArrays(1, &displayVAO);
     glDeleteBuffers(1, &displayVBO);
 
-    if(camera != nullptr)
-    {
-        glDeleteBuffers(1, &outputPBO);
-        glDeleteBuffers(1, &displayPBO);
-    }
+    if(readback != nullptr)
+        delete readback;
 }
 
 void OpenGLThermalCamera::SetupCamera(glm::vec3 _eye, glm::vec3 _dir, glm::vec3 _up)
@@ -140,23 +139,23 @@ void OpenGLThermalCamera::UpdateTransform()
     //Inform camera to run callback
     if(newData)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-        GLubyte* src = (GLubyte*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src)
+        if(readback->AcquireLatest())
         {
-            camera->NewDataReady(src, 0);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
+            GLubyte* src = (GLubyte*)readback->Map(1);
+            if(src)
+            {
+                camera->NewDataReady(src, 0);
+                readback->Unmap();
+            }
+            
+            GLfloat* src2 = (GLfloat*)readback->Map(0);
+            if(src2)
+            {
+                camera->NewDataReady(src2, 1);
+                readback->Unmap();
+            }
         }
-        
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-        GLfloat* src2 = (GLfloat*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(src2)
-        {
-            camera->NewDataReady(src2, 1);
-            glUnmapBuffer(GL_PIXEL_PACK_BUFFER); //Release pointer to the mapped buffer
-        }
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        newData = false;
+        newData = readback->isPending();
     }
 }
 
@@ -230,15 +229,9 @@ void OpenGLThermalCamera::setCamera(Camera* cam, unsigned int index)
 {
     camera = cam;
 
-    glGenBuffers(1, &outputPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * sizeof(GLfloat), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-    glGenBuffers(1, &displayPBO);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
-    glBufferData(GL_PIXEL_PACK_BUFFER, viewportWidth * viewportHeight * 3 * sizeof(GLubyte), 0, GL_STREAM_READ);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(readback == nullptr)
+        readback = new OpenGLReadbackBuffer({(GLsizeiptr)(viewportWidth * viewportHeight * sizeof(GLfloat)),
+                                             (GLsizeiptr)(viewportWidth * viewportHeight * 3 * sizeof(GLubyte))});
 }
 
 void OpenGLThermalCamera::setNoise(GLfloat temperatureStdDev)
@@ -320,13 +313,13 @@ void OpenGLThermalCamera::DrawLDR(GLuint destinationFBO, bool updated)
     if(camera != nullptr && updated)
     {
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, renderTex[1]);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, outputPBO);
+        readback->BeginWrite();
+        readback->BindForWriting(0);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
         OpenGLState::BindTexture(TEX_POSTPROCESS1, GL_TEXTURE_2D, displayTex);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, displayPBO);
+        readback->BindForWriting(1);
         glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->EndWrite();
         OpenGLState::UnbindTexture(TEX_POSTPROCESS1);
         newData = true;
     }
@@ -25,7 +25,10 @@
 
 #include "graphics/OpenGLView.h"
 
+#include "core/GraphicalSimulationApp.h"
 #include "graphics/OpenGLState.h"
+#include "graphics/OpenGLPipeline.h"
+#include "graphics/OpenGLContent.h"
 
 namespace sf
 {
@@ -137,4 +140,37 @@ void OpenGLView::ExtractFrustumFromVP(glm::vec4 frustum[6], const glm::mat4& VP)
 	frustum[5] = glm::normalize(frustum[5]);
 }
 
+void OpenGLView::CullObjects(const std::vector<Renderable>& objects, const glm::mat4& VP, bool depthPlanes, std::vector<size_t>& visible) const
+{
+    OpenGLContent* content = ((GraphicalSimulationApp*)SimulationApp::getApp())->getGLPipeline()->getContent();
+    
+    //Planes with unit normals, to compare distances with radii
+    glm::vec4 planes[6];
+    ExtractFrustumFromVP(planes, VP);
+    for(size_t i=0; i<6; ++i)
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+    size_t nPlanes = depthPlanes ? 6 : 4;
+    
+    visible.clear();
+    for(size_t i=0; i<objects.size(); ++i)
+    {
+        if(objects[i].type == RenderableType::SOLID && objects[i].objectId >= 0)
+        {
+            const Object& obj = content->getObject(objects[i].objectId);
+            const glm::mat4& M = objects[i].model;
+            glm::vec3 center = glm::vec3(M * glm::vec4(obj.bsCenter, 1.f));
+            GLfloat scale = glm::max(glm::length(glm::vec3(M[0])), glm::max(glm::length(glm::vec3(M[1])), glm::length(glm::vec3(M[2]))));
+            GLfloat radius = obj.bsRadius * scale;
+            
+            size_t h = 0;
+            for(; h<nPlanes; ++h)
+                if(glm::dot(glm::vec3(planes[h]), center) + planes[h].w < -radius)
+                    break;
+            if(h < nPlanes) //Completely outside of one of the planes
+                continue;
+        }
+        visible.push_back(i);
+    }
+}
+
 }
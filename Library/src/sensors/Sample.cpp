@@ -40,6 +40,11 @@ Sample::Sample(const std::vector<Scalar>& data, bool invalid, uint64_t index)
         timestamp = SimulationApp::getApp()->getSimulationManager()->getSimulationTime(true);
 }
 
+Sample::Sample(Scalar timestamp, const std::vector<Scalar>& data, uint64_t index)
+    : timestamp{timestamp}, data{data}, id{index}
+{
+}
+
 Sample::Sample(const Sample& other, uint64_t index)
 {
     timestamp = other.timestamp;
@@ -62,6 +67,11 @@ Scalar* Sample::getDataPointer()
     return data.data();
 }
 
+const Scalar* Sample::getDataPointer() const
+{
+    return data.data();
+}
+
 Scalar Sample::getValue(size_t dimension) const
 {
     if(dimension < data.size())
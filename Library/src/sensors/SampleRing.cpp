@@ -0,0 +1,172 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SampleRing.cpp
+//  Stonefish
+//
+
+#include "sensors/SampleRing.h"
+
+#include <algorithm>
+
+namespace sf
+{
+
+SampleRing::Storage::Storage(size_t capacity, size_t stride) : capacity(capacity), data(capacity * stride, Scalar(0)), seq(capacity)
+{
+}
+
+SampleRing::SampleRing(int historyLength) : nChannels(0), storage(nullptr), head(0), tail(0)
+{
+    limit = historyLength < 0 ? 1 : (size_t)historyLength;
+}
+
+SampleRing::~SampleRing()
+{
+    delete storage.load();
+    for(size_t i=0; i<retired.size(); ++i)
+        delete retired[i];
+}
+
+Scalar* SampleRing::BeginWrite(unsigned short channels)
+{
+    Storage* s = storage.load(std::memory_order_relaxed);
+    uint64_t h = head.load(std::memory_order_relaxed);
+    
+    if(s == nullptr) //First sample
+    {
+        s = new Storage(limit == 0 ? 1024 : limit + std::max(limit/4, (size_t)4), channels + 1); //Margin for the readers
+        nChannels.store(channels, std::memory_order_relaxed);
+        storage.store(s, std::memory_order_release);
+    }
+    else if(limit == 0 && h - tail.load(std::memory_order_relaxed) >= s->capacity)
+    {
+        Grow();
+        s = storage.load(std::memory_order_relaxed);
+    }
+    
+    //Mark the slot as being written, before any of its data changes
+    s->seq[h % s->capacity].store(2 * h + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return &s->data[(h % s->capacity) * (nChannels.load(std::memory_order_relaxed) + 1) + 1];
+}
+
+void SampleRing::EndWrite(Scalar timestamp)
+{
+    Storage* s = storage.load(std::memory_order_relaxed);
+    uint64_t h = head.load(std::memory_order_relaxed);
+    s->data[(h % s->capacity) * (nChannels.load(std::memory_order_relaxed) + 1)] = timestamp;
+    s->seq[h % s->capacity].store(2 * h + 2, std::memory_order_release);
+    head.store(h + 1, std::memory_order_release);
+    
+    if(limit > 0 && h + 1 - tail.load(std::memory_order_relaxed) > limit)
+        tail.store(h + 1 - limit, std::memory_order_release);
+}
+
+void SampleRing::Grow()
+{
+    Storage* s = storage.load(std::memory_order_relaxed);
+    size_t stride = nChannels.load(std::memory_order_relaxed) + 1;
+    Storage* g = new Storage(s->capacity * 2, stride);
+    
+    uint64_t h = head.load(std::memory_order_relaxed);
+    for(uint64_t n = tail.load(std::memory_order_relaxed); n < h; ++n)
+    {
+        std::copy_n(&s->data[(n % s->capacity) * stride], stride, &g->data[(n % g->capacity) * stride]);
+        g->seq[n % g->capacity].store(2 * n + 2, std::memory_order_relaxed); //Published with the storage
+    }
+    
+    storage.store(g, std::memory_order_release);
+    retired.push_back(s); //Readers may still use it
+}
+
+void SampleRing::Clear()
+{
+    tail.store(head.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+bool SampleRing::ReadAbsolute(uint64_t n, Scalar* values, Scalar& timestamp) const
+{
+    const uint64_t complete = 2 * n + 2; //Sequence of the slot holding the complete sample
+    while(true)
+    {
+        Storage* s = storage.load(std::memory_order_acquire);
+        if(s == nullptr)
+            return false;
+        size_t stride = nChannels.load(std::memory_order_relaxed) + 1;
+        const std::atomic<uint64_t>& seq = s->seq[n % s->capacity];
+        
+        uint64_t seq0 = seq.load(std::memory_order_acquire);
+        if(seq0 == complete)
+        {
+            const Scalar* slot = &s->data[(n % s->capacity) * stride];
+            timestamp = slot[0];
+            std::copy_n(slot + 1, stride - 1, values);
+            
+            //Check if the slot was not reused during the copy
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(seq.load(std::memory_order_relaxed) == complete)
+                return true;
+        }
+        
+        if(storage.load(std::memory_order_acquire) != s) //Storage grown in the meantime
+            continue;
+        if(seq.load(std::memory_order_relaxed) > complete) //Overwritten by a newer sample
+            return false;
+    }
+}
+
+bool SampleRing::Read(size_t index, Scalar* values, Scalar& timestamp, uint64_t& id) const
+{
+    uint64_t t = tail.load(std::memory_order_acquire);
+    uint64_t h = head.load(std::memory_order_acquire);
+    uint64_t size = limit > 0 ? std::min(h - t, (uint64_t)limit) : h - t;
+    if(index >= size)
+        return false;
+    id = h - size + index;
+    return ReadAbsolute(id, values, timestamp);
+}
+
+bool SampleRing::ReadLast(Scalar* values, Scalar& timestamp, uint64_t& id) const
+{
+    uint64_t t = tail.load(std::memory_order_acquire);
+    uint64_t h = head.load(std::memory_order_acquire);
+    if(h == t)
+        return false;
+    id = h - 1;
+    return ReadAbsolute(id, values, timestamp);
+}
+
+size_t SampleRing::getSize() const
+{
+    uint64_t t = tail.load(std::memory_order_acquire);
+    uint64_t h = head.load(std::memory_order_acquire);
+    return (size_t)(limit > 0 ? std::min(h - t, (uint64_t)limit) : h - t);
+}
+
+uint64_t SampleRing::getCount() const
+{
+    return head.load(std::memory_order_acquire);
+}
+
+unsigned short SampleRing::getNumOfChannels() const
+{
+    return nChannels.load(std::memory_order_relaxed);
+}
+
+}
@@ -33,36 +33,38 @@
 namespace sf
 {
 
-ScalarSensor::ScalarSensor(std::string uniqueName, Scalar frequency, int historyLength) : Sensor(uniqueName, frequency)
+ScalarSensor::ScalarSensor(std::string uniqueName, Scalar frequency, int historyLength) : Sensor(uniqueName, frequency), history(historyLength)
 {
-    historyLen = historyLength;
-    history = std::deque<Sample*>(0);
-    sampleCount = 0;
 }
 
 ScalarSensor::~ScalarSensor()
 {
-    ClearHistory();
     channels.clear();
 }
 
 Sample ScalarSensor::getLastSample() const
 {
-    if(history.size() > 0)
-        return Sample(*history.back());
+    std::vector<Scalar> data(getNumOfChannels(), Scalar(0));
+    Scalar timestamp;
+    uint64_t id;
+    if(data.size() > 0 && history.ReadLast(data.data(), timestamp, id))
+        return Sample(timestamp, data, id);
     else
-        return Sample(std::vector<Scalar>(getNumOfChannels(), Scalar(0)), true);
+        return Sample(data, true);
 }
 
 const std::vector<Sample>* ScalarSensor::getHistory()
 {
-    SDL_LockMutex(updateMutex);
-    
     std::vector<Sample>* historyCopy = new std::vector<Sample>();
-    for(size_t i=0; i<history.size(); ++i)
-        (*historyCopy).push_back(*(history[i]));
+    std::vector<Scalar> data(getNumOfChannels());
+    Scalar timestamp;
+    uint64_t id;
+    size_t n = history.getSize();
+    historyCopy->reserve(n);
     
-    SDL_UnlockMutex(updateMutex);
+    for(size_t i=0; i<n; ++i)
+        if(history.Read(i, data.data(), timestamp, id))
+            historyCopy->push_back(Sample(timestamp, data, id));
     
     return historyCopy;
 }
@@ -74,11 +76,14 @@ unsigned short ScalarSensor::getNumOfChannels() const
 
 Scalar ScalarSensor::getValue(unsigned long int index, unsigned int channel) const
 {
-    if(index < history.size() && channel < channels.size())
+    if(channel < channels.size())
     {
-        Sample* s = history[index];
-        Scalar v = s->getValue(channel);
-        return v;
+        thread_local std::vector<Scalar> data;
+        data.resize(channels.size());
+        Scalar timestamp;
+        uint64_t id;
+        if(history.Read(index, data.data(), timestamp, id))
+            return data[channel];
     }
     
     return Scalar(0);
@@ -86,7 +91,7 @@ Scalar ScalarSensor::getValue(unsigned long int index, unsigned int channel) con
 
 Scalar ScalarSensor::getLastValue(unsigned int channel) const
 {
-    return getValue(history.size() - 1, channel);
+    return getValue(history.getSize() - 1, channel);
 }
 
 SensorChannel ScalarSensor::getSensorChannelDescription(unsigned int channel) const
@@ -105,24 +110,23 @@ void ScalarSensor::Reset()
 
 void ScalarSensor::AddSampleToHistory(const Sample& s)
 {
-    if(historyLen < 0 && history.size() > 0) //No history
-    {
-        delete history[0];
-        history.pop_front();
-    }
-    else if(historyLen > 0 && (int)history.size() == historyLen) //Specified history length
-    {
-        delete history[0];
-        history.pop_front();
-    }
-    //else == 0 --> unlimited history
-    
-    Sample* sample = new Sample(s, sampleCount);
-    ++sampleCount;
+    //Keep the timestamp of the sample (negative for invalid samples)
+    WriteSampleToHistory(s.getDataPointer(), s.getNumOfDimensions(), s.getTimestamp());
+}
+
+void ScalarSensor::AddSampleToHistory(const Scalar* values, size_t n)
+{
+    WriteSampleToHistory(values, n, SimulationApp::getApp()->getSimulationManager()->getSimulationTime(true));
+}
+
+void ScalarSensor::WriteSampleToHistory(const Scalar* values, size_t n, Scalar timestamp)
+{
+    //Write directly to the preallocated history
+    Scalar* data = history.BeginWrite(channels.size());
     
-    for(unsigned int i=0; i<sample->getNumOfDimensions(); ++i)
+    for(unsigned int i=0; i<channels.size(); ++i)
     {
-        Scalar* data = sample->getDataPointer();
+        data[i] = i < n ? values[i] : Scalar(0);
         
         //Add noise
         if(channels[i].stdDev > Scalar(0) && data[i] < channels[i].rangeMax && data[i] > channels[i].rangeMin)
@@ -135,21 +139,23 @@ void ScalarSensor::AddSampleToHistory(const Sample& s)
             data[i] = channels[i].rangeMin;
     }
     
-    //Add to history
-    history.push_back(sample);
+    history.EndWrite(timestamp);
+    
+    //Publish a view of the sample, if requested
+    if(latestData.isActive())
+        latestData.Publish(data, channels.size() * sizeof(Scalar), timestamp, history.getCount()-1);
 }
 
 void ScalarSensor::ClearHistory()
 {
-    for(unsigned int i = 0; i < history.size(); i++)
-        delete history[i];
-    
-    history.clear();
+    history.Clear();
+    latestData.Clear();
 }
 
 void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool includeTime, unsigned int fixedPrecision)
 {
-    if(history.size() == 0)
+    std::unique_ptr<const std::vector<Sample>> samples(getHistory());
+    if(samples->size() == 0)
         return;
     
     cInfo("Saving %s measurements to: %s", getName().c_str(), path.c_str());
@@ -164,7 +170,7 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
     //Write header
     fprintf(fp, "#Measurements from %s\n", getName().c_str());
     fprintf(fp, "#Number of channels: %ld\n", channels.size());
-    fprintf(fp, "#Number of samples: %ld\n", history.size());
+    fprintf(fp, "#Number of samples: %ld\n", samples->size());
     if(freq <= Scalar(0.))
         fprintf(fp, "#Frequency: %1.3lf Hz\n", SimulationApp::getApp()->getSimulationManager()->getStepsPerSecond());
     else
@@ -190,9 +196,9 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
     //Write data
     std::string format = "%1." + std::to_string(fixedPrecision) + "lf";
     
-    for(unsigned int i = 0; i < history.size(); i++)
+    for(unsigned int i = 0; i < samples->size(); i++)
     {
-        Sample* s = history[i];
+        const Sample* s = &(*samples)[i];
         
         if(includeTime)
         {
@@ -218,7 +224,8 @@ void ScalarSensor::SaveMeasurementsToTextFile(const std::string& path, bool incl
 
 void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool includeTime, bool separateChannels)
 {
-    if(history.size() == 0)
+    std::unique_ptr<const std::vector<Sample>> samples(getHistory());
+    if(samples->size() == 0)
         return;
     
     //build data structure
@@ -232,12 +239,12 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
             it->name = "Time";
             it->type = DATA_VECTOR;
             
-            btVectorXu* vector = new btVectorXu((unsigned int)history.size());
+            btVectorXu* vector = new btVectorXu((unsigned int)samples->size());
             it->value = vector;
             
-            for(unsigned int i = 0; i < history.size(); ++i)
+            for(unsigned int i = 0; i < samples->size(); ++i)
             {
-                Sample* s = history[i];
+                const Sample* s = &(*samples)[i];
                 (*vector)[i] = s->getTimestamp();
             }
             
@@ -251,12 +258,12 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
             it->name = channels[i].name;
             it->type = DATA_VECTOR;
             
-            btVectorXu* vector = new btVectorXu((unsigned int)history.size());
+            btVectorXu* vector = new btVectorXu((unsigned int)samples->size());
             it->value = vector;
             
-            for(unsigned int h = 0; h < history.size(); ++h)
+            for(unsigned int h = 0; h < samples->size(); ++h)
             {
-                Sample* s = history[h];
+                const Sample* s = &(*samples)[h];
                 Scalar v = s->getValue(i);
                 (*vector)[h] = v;
             }
@@ -270,12 +277,12 @@ void ScalarSensor::SaveMeasurementsToOctaveFile(const std::string& path, bool in
         it->name = getName();
         it->type = DATA_MATRIX;
         
-        btMatrixXu* matrix = new btMatrixXu((unsigned int)history.size(), (unsigned int)channels.size() + (includeTime ? 1 : 0));
+        btMatrixXu* matrix = new btMatrixXu((unsigned int)samples->size(), (unsigned int)channels.size() + (includeTime ? 1 : 0));
         it->value = matrix;
         
-        for(unsigned int i = 0; i < history.size(); ++i)
+        for(unsigned int i = 0; i < samples->size(); ++i)
         {
-            Sample* s = history[i];
+            const Sample* s = &(*samples)[i];
             
             if(includeTime)
                 matrix->setElem(i, 0, s->getTimestamp());
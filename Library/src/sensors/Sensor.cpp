@@ -30,6 +30,7 @@
 #include "core/Console.h"
 #include "graphics/OpenGLPipeline.h"
 #include "graphics/OpenGLContent.h"
+#include "utils/RayQueryBatch.h"
 
 namespace sf
 {
@@ -42,6 +43,8 @@ Sensor::Sensor(std::string uniqueName, Scalar frequency)
     name = SimulationApp::getApp()->getSimulationManager()->getNameManager()->AddName(uniqueName);
     setUpdateFrequency(frequency);
     eleapsedTime = Scalar(0);
+    pendingDt = Scalar(0);
+    rayBatch = nullptr;
     enabled = true;
     renderable = true;
     newDataAvailable = false;
@@ -72,6 +75,11 @@ bool Sensor::isNewDataAvailable() const
     return newDataAvailable;
 }
 
+std::shared_ptr<const SensorData> Sensor::getLatestData() const
+{
+    return latestData.getLatest();
+}
+
 bool Sensor::isRenderable() const
 {
     return renderable;
@@ -123,16 +131,23 @@ void Sensor::Reset()
 }
 
 void Sensor::Update(Scalar dt)
+{
+    if(PrepareUpdate(dt, nullptr))
+        FinishUpdate();
+}
+
+bool Sensor::PrepareUpdate(Scalar dt, RayQueryBatch* rays)
 {
     if(!enabled)
-        return;
+        return false;
         
     SDL_LockMutex(updateMutex);
     
+    bool due = false;
     if(freq <= Scalar(0)) // Every simulation tick
     {
-        InternalUpdate(dt);
-        newDataAvailable = true;
+        pendingDt = dt;
+        due = true;
     }
     else //Fixed rate
     {
@@ -141,15 +156,46 @@ void Sensor::Update(Scalar dt)
         
         if(eleapsedTime >= invFreq)
         {
-            InternalUpdate(invFreq);
+            pendingDt = invFreq;
             eleapsedTime -= invFreq;
-            newDataAvailable = true;
+            due = true;
         }
     }
     
+    if(due && rays != nullptr)
+    {
+        QueueRays(*rays);
+        rayBatch = rays;
+    }
+    
+    SDL_UnlockMutex(updateMutex);
+    return due;
+}
+
+void Sensor::FinishUpdate()
+{
+    SDL_LockMutex(updateMutex);
+    InternalUpdate(pendingDt);
+    rayBatch = nullptr;
+    newDataAvailable = true;
     SDL_UnlockMutex(updateMutex);
 }
 
+void Sensor::QueueRays(RayQueryBatch& batch)
+{
+}
+
+const RayQueryBatch* Sensor::getRayResults(RayQueryBatch& local)
+{
+    if(rayBatch != nullptr)
+        return rayBatch;
+    
+    local.Clear();
+    QueueRays(local);
+    local.Execute(SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld());
+    return &local;
+}
+
 std::vector<Renderable> Sensor::Render()
 {
     std::vector<Renderable> items(0);
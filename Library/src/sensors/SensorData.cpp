@@ -0,0 +1,110 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  SensorData.cpp
+//  Stonefish
+//
+
+#include "sensors/SensorData.h"
+
+#include <cstring>
+
+namespace sf
+{
+
+SensorDataBuffer::SensorDataBuffer() : active(false), lock(0)
+{
+}
+
+void* SensorDataBuffer::BeginWrite(size_t size)
+{
+    if(!active.load(std::memory_order_relaxed))
+        return nullptr;
+    
+    //Find a block which is not referenced by the latest pointer or any reader
+    std::shared_ptr<Block> block;
+    for(size_t i=0; i<pool.size(); ++i)
+        if(pool[i].use_count() == 1)
+        {
+            block = pool[i];
+            break;
+        }
+    
+    if(block == nullptr) //All blocks pinned -> grow the pool
+    {
+        block = std::make_shared<Block>();
+        pool.push_back(block);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire); //Readers done with the block
+    
+    if(block->bytes.size() < size)
+        block->bytes.resize(size);
+    block->view.data = block->bytes.data();
+    block->view.size = size;
+    writing = block;
+    return block->bytes.data();
+}
+
+void SensorDataBuffer::EndWrite(Scalar timestamp, uint64_t sequence)
+{
+    if(writing == nullptr)
+        return;
+    
+    writing->view.timestamp = timestamp;
+    writing->view.sequence = sequence;
+    
+    SDL_AtomicLock(&lock);
+    latest.swap(writing);
+    SDL_AtomicUnlock(&lock);
+    writing.reset(); //Release the previous measurement outside of the lock
+}
+
+void SensorDataBuffer::Publish(const void* data, size_t size, Scalar timestamp, uint64_t sequence)
+{
+    void* dst = BeginWrite(size);
+    if(dst == nullptr)
+        return;
+    memcpy(dst, data, size);
+    EndWrite(timestamp, sequence);
+}
+
+void SensorDataBuffer::Clear()
+{
+    std::shared_ptr<Block> block;
+    SDL_AtomicLock(&lock);
+    latest.swap(block);
+    SDL_AtomicUnlock(&lock);
+}
+
+std::shared_ptr<const SensorData> SensorDataBuffer::getLatest() const
+{
+    active.store(true, std::memory_order_relaxed);
+    SDL_AtomicLock(&lock);
+    std::shared_ptr<Block> block = latest;
+    SDL_AtomicUnlock(&lock);
+    if(block == nullptr)
+        return nullptr;
+    return std::shared_ptr<const SensorData>(block, &block->view); //Aliasing keeps the block pinned
+}
+
+bool SensorDataBuffer::isActive() const
+{
+    return active.load(std::memory_order_relaxed);
+}
+
+}
@@ -40,12 +40,21 @@ VisionSensor::VisionSensor(std::string uniqueName, Scalar frequency) : Sensor(un
     
     attach = nullptr;
     o2s = Transform::getIdentity();
+    frameCount = 0;
 }
 
 VisionSensor::~VisionSensor()
 {
 }
 
+void VisionSensor::PublishData(const void* data, size_t size)
+{
+    //Copy the mapped frame once into a pinned buffer, if anybody requested the views
+    if(latestData.isActive())
+        latestData.Publish(data, size, SimulationApp::getApp()->getSimulationManager()->getSimulationTime(true), frameCount);
+    ++frameCount;
+}
+
 void VisionSensor::setRelativeSensorFrame(const Transform& origin)
 {
     o2s = origin;
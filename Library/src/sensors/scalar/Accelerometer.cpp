@@ -55,7 +55,7 @@ void Accelerometer::InternalUpdate(Scalar dt)
                                                 );
     
     // Record sample
-    Sample s{std::vector<Scalar>({la.x(), la.y(), la.z()})};
+    Scalar s[] = {la.x(), la.y(), la.z()};
     AddSampleToHistory(s);
 }
 
@@ -42,7 +42,7 @@ void Compass::InternalUpdate(Scalar dt)
     getSensorFrame().getBasis().getEulerYPR(yaw, pitch, roll);
     
     //record sample
-    Sample s{std::vector<Scalar>({yaw})};
+    Scalar s[] = {yaw};
     AddSampleToHistory(s);
 }
 
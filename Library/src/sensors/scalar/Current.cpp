@@ -62,7 +62,7 @@ void Current::InternalUpdate(Scalar dt)
         current = motor->getCurrent();
     
     //record sample
-    Sample s{std::vector<Scalar>({current})};
+    Scalar s[] = {current};
     AddSampleToHistory(s);
 }
 
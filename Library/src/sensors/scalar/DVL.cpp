@@ -31,6 +31,7 @@
 #include "entities/MovingEntity.h"
 #include "sensors/Sample.h"
 #include "graphics/OpenGLPipeline.h"
+#include "utils/RayQueryBatch.h"
 
 namespace sf
 {
@@ -38,6 +39,7 @@ namespace sf
 DVL::DVL(std::string uniqueName, Scalar beamAngleDeg, bool beamPositiveZ, Scalar frequency, int historyLength) : LinkSensor(uniqueName, frequency, historyLength)
 {
     range[0] = range[1] = range[2] = range[3] = Scalar(0.);
+    firstRay = 0;
     beamAngle = btRadians(beamAngleDeg);
     beamPosZ = beamPositiveZ;
     channels.push_back(SensorChannel("Velocity X", QuantityType::VELOCITY));
@@ -62,6 +64,28 @@ void DVL::setWaterLayer(Scalar minSize, Scalar nearBoundary, Scalar farBoundary)
     waterLayer.setZ(btClamped(farBoundary, waterLayer.getX() + waterLayer.getY(), channels[3].rangeMax));
 }
     
+Vector3 DVL::getBeamDirection(const Transform& dvlTrans, unsigned int beam) const
+{
+    //Simulate 4 beam DVL (typical design)
+    Scalar alpha = M_PI_4 + beam * M_PI_2;
+    Vector3 dir = dvlTrans.getBasis().getColumn(2) * btCos(beamAngle) 
+                  + (dvlTrans.getBasis().getColumn(0) * btCos(alpha) + dvlTrans.getBasis().getColumn(1) * btSin(alpha)) * btSin(beamAngle);
+    return beamPosZ ? dir : -dir;
+}
+
+void DVL::QueueRays(RayQueryBatch& batch)
+{
+    //Full-length beams, from the minimum to the maximum range
+    Transform dvlTrans = getSensorFrame();
+    for(unsigned int i=0; i<4; ++i)
+    {
+        Vector3 dir = getBeamDirection(dvlTrans, i);
+        size_t id = batch.Add(dvlTrans.getOrigin() + dir * channels[3].rangeMin, dvlTrans.getOrigin() + dir * channels[3].rangeMax);
+        if(i == 0)
+            firstRay = id;
+    }
+}
+
 void DVL::InternalUpdate(Scalar dt)
 {
     /*
@@ -75,46 +99,16 @@ void DVL::InternalUpdate(Scalar dt)
     unsigned short status = 0;
     Transform dvlTrans = getSensorFrame();
     
-    //Simulate 4 beam DVL (typical design)
-    Vector3 dir[4];
-    Vector3 from[4];
-    Vector3 to[4];
-    for(unsigned int i=0; i<4; ++i)
-    {
-        Scalar alpha = M_PI_4 + i * M_PI_2;
-        dir[i] = dvlTrans.getBasis().getColumn(2) * btCos(beamAngle) 
-                 + (dvlTrans.getBasis().getColumn(0) * btCos(alpha) + dvlTrans.getBasis().getColumn(1) * btSin(alpha)) * btSin(beamAngle);
-    }
-    
-    Scalar dirFactor = beamPosZ ? Scalar(1) : Scalar(-1);
-
-    unsigned int divs = ceil(channels[3].rangeMax - channels[3].rangeMin);
+    //Bottom ping (beams traced in the ray batch of the simulation tick)
+    RayQueryBatch local;
+    const RayQueryBatch* rays = getRayResults(local);
     Scalar minRange(-1);
 
     for(unsigned int i=0; i<4; ++i)
     {
-        from[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMin;
-        to[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMax;
-
-        Vector3 step = (to[i]-from[i])/Scalar(divs);
         range[i] = Scalar(-1);
-
-        for(unsigned int h=0; h<divs; ++h)
-        {
-            Vector3 from_ = from[i] + step*Scalar(h);
-            Vector3 to_ = from[i] + step*Scalar(h+1);
-            btCollisionWorld::ClosestRayResultCallback closest(from_, to_);
-            closest.m_collisionFilterGroup = MASK_DYNAMIC;
-            closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-            SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from_, to_, closest);
-            
-            if(closest.hasHit())
-            {
-                Vector3 p = from_.lerp(to_, closest.m_closestHitFraction);
-                range[i] = (p - dvlTrans.getOrigin()).length();
-                break;
-            }
-        }
+        if(rays->getResult(firstRay + i).hasHit())
+            range[i] = (rays->getHitPoint(firstRay + i) - dvlTrans.getOrigin()).length();
 
         if(range[i] > Scalar(0) && (range[i] < minRange || minRange < Scalar(0)))
                 minRange = range[i];
@@ -132,16 +126,14 @@ void DVL::InternalUpdate(Scalar dt)
         for(unsigned int i=0; i<4; ++i)
         {
             range[i] = Scalar(-1);
-            from[i] = dvlTrans.getOrigin() + dirFactor * dir[i] * channels[3].rangeMin;
-            to[i] = dvlTrans.getOrigin();
-            btCollisionWorld::ClosestRayResultCallback closest(from[i], to[i]);
-            closest.m_collisionFilterGroup = MASK_DYNAMIC;
-            closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-            SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from[i], to[i], closest);
+            Vector3 dir = getBeamDirection(dvlTrans, i);
+            Vector3 from = dvlTrans.getOrigin() + dir * channels[3].rangeMin;
+            Vector3 to = dvlTrans.getOrigin();
+            RayHit hit = RayQueryBatch::Cast(SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld(), from, to);
             
-            if(closest.hasHit() && btDot(closest.m_hitNormalWorld, dirFactor * dir[i]) > Scalar(0))
+            if(hit.hasHit() && btDot(hit.normal, dir) > Scalar(0))
             {
-                Vector3 p = from[i].lerp(to[i], closest.m_closestHitFraction);
+                Vector3 p = from.lerp(to, hit.fraction);
                 range[i] = (p - dvlTrans.getOrigin()).length();
                 if(range[i] < minRange || minRange < Scalar(0)) minRange = range[i];
             }
@@ -199,7 +191,7 @@ void DVL::InternalUpdate(Scalar dt)
     channels[6].setStdDev(mulNoiseFactor[1] * wv.z() + addNoiseStdDev[1]);
     
     //Save data
-    Sample s{std::vector<Scalar>({v.x(), v.y(), v.z(), altitude, wv.x(), wv.y(), wv.z(), Scalar(status)})};
+    Scalar s[] = {v.x(), v.y(), v.z(), altitude, wv.x(), wv.y(), wv.z(), Scalar(status)};
     AddSampleToHistory(s);
 }
 
@@ -75,7 +75,7 @@ void ForceTorque::InternalUpdate(Scalar dt)
         force = toSensor * force;
         torque = toSensor * torque;
 	
-        Sample s{std::vector<Scalar>({force.getX(), force.getY(), force.getZ(), torque.getX(), torque.getY(), torque.getZ()})};
+        Scalar s[] = {force.getX(), force.getY(), force.getZ(), torque.getX(), torque.getY(), torque.getZ()};
         AddSampleToHistory(s);
     }
     else
@@ -88,7 +88,7 @@ void ForceTorque::InternalUpdate(Scalar dt)
         torque = toSensor * torque;
         lastFrame = fe->getLink(childId).solid->getCGTransform() * lastFrame; //From local to global
         
-        Sample s{std::vector<Scalar>({force.getX(), force.getY(), force.getZ(), torque.getX(), torque.getY(), torque.getZ()})};
+        Scalar s[] = {force.getX(), force.getY(), force.getZ(), torque.getX(), torque.getY(), torque.getZ()};
         AddSampleToHistory(s);
     }
 }
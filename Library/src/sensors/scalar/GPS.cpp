@@ -52,7 +52,7 @@ void GPS::InternalUpdate(Scalar dt)
     Ocean* liq = SimulationApp::getApp()->getSimulationManager()->getOcean();
     if(liq != nullptr && liq->IsInsideFluid(gpsTrans.getOrigin()))
     {
-        Sample s{std::vector<Scalar>({BT_LARGE_FLOAT, BT_LARGE_FLOAT, Scalar(0), Scalar(0)})};
+        Scalar s[] = {BT_LARGE_FLOAT, BT_LARGE_FLOAT, Scalar(0), Scalar(0)};
         AddSampleToHistory(s);
     }
     else
@@ -73,7 +73,7 @@ void GPS::InternalUpdate(Scalar dt)
         SimulationApp::getApp()->getSimulationManager()->getNED()->Ned2Geodetic(gpsPos.x(), gpsPos.y(), 0.0, latitude, longitude, height);
         
         //record sample
-        Sample s{std::vector<Scalar>({latitude, longitude, gpsPos.x(), gpsPos.y()})};
+        Scalar s[] = {latitude, longitude, gpsPos.x(), gpsPos.y()};
         AddSampleToHistory(s);
     }
 }
@@ -51,7 +51,7 @@ void Gyroscope::InternalUpdate(Scalar dt)
     omega += bias;
 
     //record sample
-    Sample s{std::vector<Scalar>({omega.x(), omega.y(), omega.z()})};
+    Scalar s[] = {omega.x(), omega.y(), omega.z()};
     AddSampleToHistory(s);
 }
 
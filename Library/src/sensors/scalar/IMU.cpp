@@ -75,7 +75,7 @@ void IMU::InternalUpdate(Scalar dt)
                 );
     
     //record sample
-    Sample s{std::vector<Scalar>({roll, pitch, yaw, av.x(), av.y(), av.z(), la.x(), la.y(), la.z()})};
+    Scalar s[] = {roll, pitch, yaw, av.x(), av.y(), av.z(), la.x(), la.y(), la.z()};
     AddSampleToHistory(s);
 }
 
@@ -172,11 +172,9 @@ void INS::InternalUpdate(Scalar dt)
     (imuTrans * out).getBasis().getEulerYPR(yaw, pitch, roll);
 
     //record sample
-    Sample s{std::vector<Scalar>(
-        {nedo.x(), nedo.y(), nedo.z(), altitude, latitude, longitude,
-         velo.x(), velo.y(), velo.z(), roll, pitch, yaw, 
-         avo.x(), avo.y(), avo.z(), acco.x(), acco.y(), acco.z()}
-        )};
+    Scalar s[] = {nedo.x(), nedo.y(), nedo.z(), altitude, latitude, longitude,
+                  velo.x(), velo.y(), velo.z(), roll, pitch, yaw, 
+                  avo.x(), avo.y(), avo.z(), acco.x(), acco.y(), acco.z()};
     AddSampleToHistory(s); //Adds noise.....:(
 }
 
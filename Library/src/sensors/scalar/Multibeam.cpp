@@ -31,6 +31,7 @@
 #include "utils/UnitSystem.h"
 #include "sensors/Sample.h"
 #include "graphics/OpenGLPipeline.h"
+#include "utils/RayQueryBatch.h"
 
 namespace sf
 {
@@ -50,6 +51,19 @@ Multibeam::Multibeam(std::string uniqueName, Scalar angleRangeDeg, unsigned int
     }
     
     distances = std::vector<Scalar>(angSteps+1, Scalar(0));
+    firstRay = 0;
+}
+
+void Multibeam::QueueRays(RayQueryBatch& batch)
+{
+    Transform mbTrans = getSensorFrame();
+    for(unsigned int i=0; i<=angSteps; ++i)
+    {
+        Vector3 dir = mbTrans.getBasis().getColumn(0) * btCos(angles[i]) + mbTrans.getBasis().getColumn(1) * btSin(angles[i]);
+        size_t id = batch.Add(mbTrans.getOrigin() + dir * channels[1].rangeMin, mbTrans.getOrigin() + dir * channels[1].rangeMax);
+        if(i == 0)
+            firstRay = id;
+    }
 }
     
 void Multibeam::InternalUpdate(Scalar dt)
@@ -57,30 +71,19 @@ void Multibeam::InternalUpdate(Scalar dt)
     //get sensor frame in world
     Transform mbTrans = getSensorFrame();
     
-    //shoot rays
+    //get results of rays (traced in the ray batch of the simulation tick)
+    RayQueryBatch local;
+    const RayQueryBatch* rays = getRayResults(local);
     for(unsigned int i=0; i<=angSteps; ++i)
     {
-        Vector3 dir = mbTrans.getBasis().getColumn(0) * btCos(angles[i]) + mbTrans.getBasis().getColumn(1) * btSin(angles[i]);
-        Vector3 from = mbTrans.getOrigin() + dir * channels[1].rangeMin;
-        Vector3 to = mbTrans.getOrigin() + dir * channels[1].rangeMax;
-    
-        btCollisionWorld::ClosestRayResultCallback closest(from, to);
-        closest.m_collisionFilterGroup = MASK_DYNAMIC;
-        closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-        SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
-        
-        if(closest.hasHit())
-        {
-            Vector3 p = from.lerp(to, closest.m_closestHitFraction);
-            distances[i] = (p - mbTrans.getOrigin()).length();
-        }
+        if(rays->getResult(firstRay + i).hasHit())
+            distances[i] = (rays->getHitPoint(firstRay + i) - mbTrans.getOrigin()).length();
         else
             distances[i] = channels[i].rangeMax;
     }
     
     //record sample
-    Sample s(distances);
-    AddSampleToHistory(s);
+    AddSampleToHistory(distances.data(), distances.size());
 }
 
 std::vector<Renderable> Multibeam::Render()
@@ -65,7 +65,7 @@ void Odometry::InternalUpdate(Scalar dt)
     Vector3 av = odomTrans.getBasis().inverse() * attach->getAngularVelocity();
     
     //Record sample
-    Sample s{std::vector<Scalar>({pos.x(), pos.y(), pos.z(), v.x(), v.y(), v.z(), orn.x(), orn.y(), orn.z(), orn.w(), av.x(), av.y(), av.z()})};
+    Scalar s[] = {pos.x(), pos.y(), pos.z(), v.x(), v.y(), v.z(), orn.x(), orn.y(), orn.z(), orn.w(), av.x(), av.y(), av.z()};
     AddSampleToHistory(s);
 }
    
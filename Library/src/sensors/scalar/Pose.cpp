@@ -49,7 +49,7 @@ void Pose::InternalUpdate(Scalar dt)
     trajFrame.getBasis().getEulerYPR(yaw, pitch, roll);
     
     //record sample
-    Sample s{std::vector<Scalar>({trajFrame.getOrigin().x(), trajFrame.getOrigin().y(), trajFrame.getOrigin().z(), roll, pitch, yaw})};
+    Scalar s[] = {trajFrame.getOrigin().x(), trajFrame.getOrigin().y(), trajFrame.getOrigin().z(), roll, pitch, yaw};
     AddSampleToHistory(s);
 }
 
@@ -31,6 +31,7 @@
 #include "utils/UnitSystem.h"
 #include "sensors/Sample.h"
 #include "graphics/OpenGLContent.h"
+#include "utils/RayQueryBatch.h"
 
 namespace sf
 {
@@ -46,6 +47,16 @@ Profiler::Profiler(std::string uniqueName, Scalar angleRangeDeg, unsigned int an
     currentAngStep = 0;
     distance = 0;
     clockwise = true;
+    ray = 0;
+}
+
+void Profiler::QueueRays(RayQueryBatch& batch)
+{
+    //Simulate 1 beam rotating profiler
+    Transform profTrans = getSensorFrame();
+    Scalar currentAngle = currentAngStep/(Scalar)angSteps * angRange - Scalar(0.5) * angRange;
+    Vector3 dir = profTrans.getBasis().getColumn(0) * btCos(currentAngle) + profTrans.getBasis().getColumn(1) * btSin(currentAngle);
+    ray = batch.Add(profTrans.getOrigin() + dir * channels[1].rangeMin, profTrans.getOrigin() + dir * channels[1].rangeMax);
 }
     
 void Profiler::InternalUpdate(Scalar dt)
@@ -53,26 +64,17 @@ void Profiler::InternalUpdate(Scalar dt)
     Transform profTrans = getSensorFrame();
     Scalar currentAngle = currentAngStep/(Scalar)angSteps * angRange - Scalar(0.5) * angRange;
     
-    //Simulate 1 beam rotating profiler
-    Vector3 dir = profTrans.getBasis().getColumn(0) * btCos(currentAngle) + profTrans.getBasis().getColumn(1) * btSin(currentAngle);
-    Vector3 from = profTrans.getOrigin() + dir * channels[1].rangeMin;
-    Vector3 to = profTrans.getOrigin() + dir * channels[1].rangeMax;
+    //Get result of the beam (traced in the ray batch of the simulation tick)
+    RayQueryBatch local;
+    const RayQueryBatch* rays = getRayResults(local);
     
-    btCollisionWorld::ClosestRayResultCallback closest(from, to);
-    closest.m_collisionFilterGroup = MASK_DYNAMIC;
-    closest.m_collisionFilterMask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
-    SimulationApp::getApp()->getSimulationManager()->getDynamicsWorld()->rayTest(from, to, closest);
-        
-    if(closest.hasHit())
-    {
-        Vector3 p = from.lerp(to, closest.m_closestHitFraction);
-        distance = (p - profTrans.getOrigin()).length();
-    }
+    if(rays->getResult(ray).hasHit())
+        distance = (rays->getHitPoint(ray) - profTrans.getOrigin()).length();
     else
         distance = channels[1].rangeMax;
    
     //Record sample
-    Sample s{std::vector<Scalar>({currentAngle, distance})};
+    Scalar s[] = {currentAngle, distance};
     AddSampleToHistory(s);
     
     //Rotate beam
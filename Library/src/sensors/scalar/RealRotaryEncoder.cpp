@@ -88,7 +88,7 @@ void RealRotaryEncoder::InternalUpdate(Scalar dt)
     }
     
     //record sample
-    Sample s{std::vector<Scalar>({angle, Scalar(0)})};
+    Scalar s[] = {angle, Scalar(0)};
     AddSampleToHistory(s);
 }
 
@@ -140,7 +140,7 @@ void RotaryEncoder::InternalUpdate(Scalar dt)
     Scalar angularVelocity = (angle - angle0)/dt; // Less noisy than reading raw velocity
     
     //record sample
-    Sample s{std::vector<Scalar>({angle, angularVelocity})};
+    Scalar s[] = {angle, angularVelocity};
     AddSampleToHistory(s);
 }
 
@@ -46,7 +46,7 @@ void Torque::InternalUpdate(Scalar dt)
     if(fe != NULL)
     {
         Scalar tau = fe->getMotorForceTorque(jId);
-        Sample s{std::vector<Scalar>({tau})};
+        Scalar s[] = {tau};
         AddSampleToHistory(s);
     }
 }
@@ -100,6 +100,8 @@ void ColorCamera::InstallNewDataHandler(std::function<void(ColorCamera*)> callba
 
 void ColorCamera::NewDataReady(void* data, unsigned int index)
 {
+    PublishData(data, resX * resY * 3);
+    
     if(newDataCallback != nullptr)
     {
         imageData = (GLubyte*)data;
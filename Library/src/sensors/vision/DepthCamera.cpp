@@ -105,6 +105,8 @@ void DepthCamera::InstallNewDataHandler(std::function<void(DepthCamera*)> callba
 
 void DepthCamera::NewDataReady(void* data, unsigned int index)
 {
+    PublishData(data, resX * resY * sizeof(GLfloat));
+    
     if(newDataCallback != nullptr)
     {
         imageData = (GLfloat*)data;
@@ -108,6 +108,7 @@ void EventBasedCamera::InstallNewDataHandler(std::function<void(EventBasedCamera
 void EventBasedCamera::NewDataReady(void* data, unsigned int index)
 {
     lastEventCount = index;
+    PublishData(data, lastEventCount * 2 * sizeof(GLint));
 
 #ifdef DEBUG
     if(lastEventCount > 0)
@@ -165,6 +165,9 @@ void FLS::InstallNewDataHandler(std::function<void(FLS*)> callback)
 
 void FLS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * OpenGLSonar::getSampleSize(outputFormat_));
+    
     if(newDataCallback != NULL)
     {
         if(index == 0)
@@ -70,6 +70,8 @@ void* FisheyeCamera::getImageDataPointer(unsigned int index)
 
 void FisheyeCamera::NewDataReady(void* data, unsigned int index)
 {
+    PublishData(data, resX * resY * 3);
+    
     if(newDataCallback != nullptr)
     {
         imageData = (GLubyte*)data;
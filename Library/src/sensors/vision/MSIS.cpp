@@ -212,6 +212,9 @@ void MSIS::InstallNewDataHandler(std::function<void(MSIS*)> callback)
 
 void MSIS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * OpenGLSonar::getSampleSize(outputFormat_));
+    
     if(newDataCallback != nullptr)
     {
         if(index == 0)
@@ -238,6 +238,8 @@ void Multibeam2::NewDataReady(void* data, unsigned int index)
             }
         }
         
+        PublishData(rangeData, resX * resY * sizeof(GLfloat));
+        
         //Call callback
         if(newDataCallback != NULL)
             newDataCallback(this);
@@ -116,6 +116,9 @@ void OpticalFlowCamera::InstallNewDataHandler(std::function<void(OpticalFlowCame
 
 void OpticalFlowCamera::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * 2 * sizeof(GLfloat));
+    
     if(newDataCallback != nullptr)
     {
         if(index == 0)
@@ -164,6 +164,9 @@ void SSS::InstallNewDataHandler(std::function<void(SSS*)> callback)
 
 void SSS::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * OpenGLSonar::getSampleSize(outputFormat_));
+    
     if(newDataCallback != NULL)
     {
         if(index == 0)
@@ -97,6 +97,9 @@ void SegmentationCamera::InstallNewDataHandler(std::function<void(SegmentationCa
 
 void SegmentationCamera::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * sizeof(GLushort));
+    
     if(newDataCallback != nullptr)
     {
         if(index == 0)
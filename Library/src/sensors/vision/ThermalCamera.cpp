@@ -133,6 +133,9 @@ void ThermalCamera::InstallNewDataHandler(std::function<void(ThermalCamera*)> ca
 
 void ThermalCamera::NewDataReady(void* data, unsigned int index)
 {
+    if(index == 1)
+        PublishData(data, resX * resY * sizeof(GLfloat));
+    
     if(newDataCallback != nullptr)
     {
         if(index == 0)
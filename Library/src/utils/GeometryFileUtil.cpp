@@ -28,8 +28,16 @@
 #include <algorithm>
 #include <array>
 #include <fstream>
+#include <unordered_map>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "core/SimulationApp.h"
+#include "graphics/OpenGLContent.h"
 #include "utils/SystemUtil.hpp"
+#include "LinearMath/btConvexHullComputer.h"
 
 namespace sf
 {
@@ -43,6 +51,12 @@ Mesh* LoadGeometryFromFile(const std::string& path, GLfloat scale)
         mesh = LoadSTL(path, scale);
     else if(extension == "obj" || extension == "OBJ")
         mesh = LoadOBJ(path, scale);
+    else if(extension == "sfm" || extension == "SFM")
+    {
+        mesh = LoadSFM(path, scale);
+        if(mesh == nullptr)
+            cError("Failed to load preprocessed geometry file: %s", path.c_str());
+    }
     else
         cError("Unsupported geometry file type: %s!", extension.c_str());
     
@@ -372,6 +386,255 @@ namespace
     }
 }
 
+//Preprocessed geometry file layout (native byte order):
+//header, section table, then vertex and face data of each section (aligned to 8 bytes)
+static const char SFM_MAGIC[4] = {'S', 'F', 'M', '1'};
+static const uint32_t SFM_VERSION = 2;
+
+struct SFMHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize; //Size of the original file [B]
+    int64_t sourceTime; //Modification time of the original file [s]
+    uint32_t vertexSize; //Sizes of the structures, to detect incompatible builds
+    uint32_t texturableVertexSize;
+    uint32_t numSections;
+    float refineScale; //Scale of the geometry when the refined sections were produced
+};
+
+struct SFMSection
+{
+    float refine;
+    uint32_t texturable;
+    uint64_t numVertices;
+    uint64_t numFaces;
+    uint64_t dataOffset;
+    double volume; //Physical properties for unit scale, unit density and zero thickness
+    double surface;
+    double CG[3];
+    double Ipri[3];
+    double Irot[9];
+};
+
+static inline uint64_t AlignSFM(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+static bool GetSourceStamp(const std::string& path, uint64_t& size, int64_t& time)
+{
+    struct stat st;
+    if(path == "" || stat(path.c_str(), &st) != 0)
+        return false;
+    size = (uint64_t)st.st_size;
+    time = (int64_t)st.st_mtime;
+    return true;
+}
+
+std::string GetPreprocessedGeometryPath(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + ".sfm";
+    return path.substr(0, dot) + ".sfm";
+}
+
+Mesh* LoadSFM(const std::string& path, GLfloat scale, GLfloat refine, const std::string& sourcePath, MeshProperties* unitProps)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return nullptr;
+    
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SFMHeader))
+    {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = (size_t)st.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED)
+        return nullptr;
+    const char* bytes = (const char*)data;
+    
+    //Validate header
+    const SFMHeader* header = (const SFMHeader*)bytes;
+    if(memcmp(header->magic, SFM_MAGIC, 4) != 0 
+       || header->version != SFM_VERSION
+       || header->vertexSize != sizeof(Vertex)
+       || header->texturableVertexSize != sizeof(TexturableVertex)
+       || sizeof(SFMHeader) + header->numSections * sizeof(SFMSection) > size)
+    {
+        cWarning("Incompatible preprocessed geometry file: %s", path.c_str());
+        munmap(data, size);
+        return nullptr;
+    }
+
+    //Check if the original file changed after conversion
+    uint64_t srcSize;
+    int64_t srcTime;
+    if(GetSourceStamp(sourcePath, srcSize, srcTime) && (srcSize != header->sourceSize || srcTime != header->sourceTime))
+    {
+        cWarning("Preprocessed geometry file is outdated: %s", path.c_str());
+        munmap(data, size);
+        return nullptr;
+    }
+
+    //Find requested mesh (refinement depends on the scale, so a mesh refined at another scale is refined again after scaling)
+    bool refineAtLoad = refine > 0.f && header->refineScale != scale;
+    GLfloat sectionRefine = refineAtLoad ? 0.f : refine;
+    const SFMSection* sections = (const SFMSection*)(bytes + sizeof(SFMHeader));
+    const SFMSection* sec = nullptr;
+    for(uint32_t i=0; i<header->numSections; ++i)
+        if(sections[i].refine == sectionRefine)
+        {
+            sec = &sections[i];
+            break;
+        }
+    
+    if(sec == nullptr)
+    {
+        munmap(data, size);
+        return nullptr;
+    }
+    
+    //Validate data size and face indices
+    size_t vertexSize = sec->texturable ? sizeof(TexturableVertex) : sizeof(Vertex);
+    bool valid = sec->dataOffset <= size
+                 && sec->numVertices <= (size - sec->dataOffset)/vertexSize
+                 && sec->numFaces <= (size - sec->dataOffset - sec->numVertices * vertexSize)/sizeof(Face);
+    if(valid)
+    {
+        const Face* faces = (const Face*)(bytes + sec->dataOffset + sec->numVertices * vertexSize);
+        for(uint64_t i=0; i<sec->numFaces && valid; ++i)
+            valid = faces[i].vertexID[0] < sec->numVertices 
+                    && faces[i].vertexID[1] < sec->numVertices 
+                    && faces[i].vertexID[2] < sec->numVertices;
+    }
+    if(!valid)
+    {
+        cWarning("Corrupted preprocessed geometry file: %s", path.c_str());
+        munmap(data, size);
+        return nullptr;
+    }
+    
+    cInfo("Loading preprocessed geometry from: %s", path.c_str());
+    
+    //Copy data
+    const char* vdata = bytes + sec->dataOffset;
+    const Face* fdata = (const Face*)(vdata + sec->numVertices * vertexSize);
+    Mesh* mesh;
+    if(sec->texturable)
+    {
+        TexturableMesh* m = new TexturableMesh;
+        m->vertices.assign((const TexturableVertex*)vdata, (const TexturableVertex*)vdata + sec->numVertices);
+        if(scale != 1.f)
+            for(size_t i=0; i<m->vertices.size(); ++i)
+                m->vertices[i].pos *= scale;
+        mesh = m;
+    }
+    else
+    {
+        PlainMesh* m = new PlainMesh;
+        m->vertices.assign((const Vertex*)vdata, (const Vertex*)vdata + sec->numVertices);
+        if(scale != 1.f)
+            for(size_t i=0; i<m->vertices.size(); ++i)
+                m->vertices[i].pos *= scale;
+        mesh = m;
+    }
+    mesh->faces.assign(fdata, fdata + sec->numFaces);
+    
+    if(refineAtLoad)
+    {
+        OpenGLContent::Refine(mesh, refine);
+        if(unitProps != nullptr)
+            *unitProps = ComputePhysicalProperties(mesh, Scalar(0), Scalar(1));
+    }
+    else if(unitProps != nullptr) //Scale physical properties
+    {
+        Scalar s(scale);
+        unitProps->volume = Scalar(sec->volume) * s*s*s;
+        unitProps->mass = unitProps->volume;
+        unitProps->surface = Scalar(sec->surface) * s*s;
+        unitProps->CG = Vector3(sec->CG[0], sec->CG[1], sec->CG[2]) * s;
+        unitProps->Ipri = Vector3(sec->Ipri[0], sec->Ipri[1], sec->Ipri[2]) * s*s*s*s*s;
+        unitProps->Irot = Matrix3(sec->Irot[0], sec->Irot[1], sec->Irot[2],
+                                  sec->Irot[3], sec->Irot[4], sec->Irot[5],
+                                  sec->Irot[6], sec->Irot[7], sec->Irot[8]);
+    }
+
+    munmap(data, size);
+    return mesh;
+}
+
+bool SaveSFM(const std::string& path, const std::string& sourcePath, const std::vector<std::pair<GLfloat, const Mesh*>>& meshes, GLfloat refineScale)
+{
+    SFMHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SFM_MAGIC, 4);
+    header.version = SFM_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.texturableVertexSize = sizeof(TexturableVertex);
+    header.numSections = (uint32_t)meshes.size();
+    header.refineScale = refineScale;
+    GetSourceStamp(sourcePath, header.sourceSize, header.sourceTime);
+    
+    std::vector<SFMSection> sections(meshes.size());
+    uint64_t offset = AlignSFM(sizeof(SFMHeader) + sections.size() * sizeof(SFMSection));
+    for(size_t i=0; i<meshes.size(); ++i)
+    {
+        const Mesh* mesh = meshes[i].second;
+        SFMSection& sec = sections[i];
+        memset(&sec, 0, sizeof(sec));
+        sec.refine = meshes[i].first;
+        sec.texturable = mesh->isTexturable() ? 1 : 0;
+        sec.numVertices = mesh->getNumOfVertices();
+        sec.numFaces = mesh->faces.size();
+        sec.dataOffset = offset;
+        offset = AlignSFM(offset + sec.numVertices * mesh->getVertexSize() + sec.numFaces * sizeof(Face));
+
+        MeshProperties mp = ComputePhysicalProperties(mesh, Scalar(0), Scalar(1));
+        sec.volume = mp.volume;
+        sec.surface = mp.surface;
+        for(int j=0; j<3; ++j)
+        {
+            sec.CG[j] = mp.CG[j];
+            sec.Ipri[j] = mp.Ipri[j];
+            for(int k=0; k<3; ++k)
+                sec.Irot[j*3+k] = mp.Irot[j][k];
+        }
+    }
+    
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == NULL)
+    {
+        cError("Failed to create preprocessed geometry file: %s", path.c_str());
+        return false;
+    }
+    
+    const char zeros[8] = {0};
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(sections.data(), sizeof(SFMSection), sections.size(), file);
+    long pos = ftell(file);
+    for(size_t i=0; i<meshes.size(); ++i)
+    {
+        fwrite(zeros, 1, sections[i].dataOffset - pos, file); //Padding
+        const Mesh* mesh = meshes[i].second;
+        fwrite(mesh->getVertexDataPointer(), mesh->getVertexSize(), mesh->getNumOfVertices(), file);
+        fwrite(mesh->getFaceDataPointer(), sizeof(Face), mesh->faces.size(), file);
+        pos = ftell(file);
+    }
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    
+    if(!ok)
+        cError("Failed to write preprocessed geometry file: %s", path.c_str());
+    return ok;
+}
+
 Mesh* LoadSTL(const std::string& path, GLfloat scale)
 {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
@@ -705,6 +968,230 @@ Vector3 FindInertialAxis(const Matrix3& I, Scalar value)
     return axis;
 }
 
+std::vector<Vector3> ComputeConvexHull(const Mesh* mesh, unsigned int maxVertices, Scalar tolerance)
+{
+    std::vector<Vector3> hull;
+    if(mesh == nullptr || mesh->getNumOfVertices() == 0)
+        return hull;
+
+    //Exact hull
+    btConvexHullComputer exact;
+    exact.compute((const float*)mesh->getVertexDataPointer(), (int)mesh->getVertexSize(), (int)mesh->getNumOfVertices(), Scalar(0), Scalar(0));
+    int n = exact.vertices.size();
+    if(n <= 4 || (maxVertices == 0 && tolerance <= Scalar(0)))
+    {
+        for(int i=0; i<n; ++i)
+            hull.push_back(exact.vertices[i]);
+        return hull;
+    }
+
+    //Start from the extreme points along the axes
+    std::vector<bool> used(n, false);
+    for(int a=0; a<3; ++a)
+    {
+        int iMin = 0;
+        int iMax = 0;
+        for(int i=1; i<n; ++i)
+        {
+            if(exact.vertices[i][a] < exact.vertices[iMin][a]) iMin = i;
+            if(exact.vertices[i][a] > exact.vertices[iMax][a]) iMax = i;
+        }
+        used[iMin] = true;
+        used[iMax] = true;
+    }
+    for(int i=0; i<n; ++i)
+        if(used[i]) 
+            hull.push_back(exact.vertices[i]);
+
+    //Add the farthest vertex until the hull is accurate enough
+    btConvexHullComputer approx;
+    std::vector<Vector3> normals;
+    std::vector<Scalar> offsets;
+    while(maxVertices == 0 || hull.size() < maxVertices)
+    {
+        approx.compute(&hull[0].m_floats[0], sizeof(Vector3), (int)hull.size(), Scalar(0), Scalar(0));
+        Vector3 center = V0();
+        for(int i=0; i<approx.vertices.size(); ++i)
+            center += approx.vertices[i];
+        center /= Scalar(approx.vertices.size());
+        
+        normals.clear();
+        offsets.clear();
+        for(int f=0; f<approx.faces.size(); ++f)
+        {
+            const btConvexHullComputer::Edge* e = &approx.edges[approx.faces[f]];
+            const Vector3& p0 = approx.vertices[e->getSourceVertex()];
+            const Vector3& p1 = approx.vertices[e->getTargetVertex()];
+            const Vector3& p2 = approx.vertices[e->getNextEdgeOfFace()->getTargetVertex()];
+            Vector3 nf = (p1 - p0).cross(p2 - p0);
+            if(nf.length2() < SIMD_EPSILON)
+                continue;
+            nf.normalize();
+            if(nf.dot(center - p0) > Scalar(0)) //Pointing outside
+                nf = -nf;
+            normals.push_back(nf);
+            offsets.push_back(nf.dot(p0));
+        }
+        
+        int farthest = -1;
+        Scalar maxDist(0);
+        for(int i=0; i<n; ++i)
+        {
+            if(used[i]) 
+                continue;
+            Scalar d = -BT_LARGE_FLOAT;
+            for(size_t f=0; f<normals.size(); ++f)
+                d = btMax(d, normals[f].dot(exact.vertices[i]) - offsets[f]);
+            if(normals.size() < 4) //Degenerate (flat) approximation
+                d = btMax(d, (exact.vertices[i] - center).length());
+            if(d > maxDist)
+            {
+                maxDist = d;
+                farthest = i;
+            }
+        }
+        
+        if(farthest < 0 || maxDist <= tolerance)
+            break;
+        used[farthest] = true;
+        hull.push_back(exact.vertices[farthest]);
+    }
+    return hull;
+}
+
+static PlainMesh* ClusterVertices(const Mesh* mesh, const glm::vec3& origin, GLfloat cellSize)
+{
+    PlainMesh* out = new PlainMesh();
+    std::unordered_map<uint64_t, GLuint> cells;
+    std::vector<GLuint> remap(mesh->getNumOfVertices());
+    std::vector<GLuint> count;
+    
+    //Assign vertices to cells (21 bits per axis)
+    for(size_t i=0; i<mesh->getNumOfVertices(); ++i)
+    {
+        glm::vec3 pos = mesh->getVertexPos(i);
+        glm::vec3 c = glm::floor((pos - origin)/cellSize);
+        uint64_t key = ((uint64_t)c.x & 0x1FFFFF) | (((uint64_t)c.y & 0x1FFFFF) << 21) | (((uint64_t)c.z & 0x1FFFFF) << 42);
+        auto res = cells.emplace(key, (GLuint)out->vertices.size());
+        if(res.second)
+        {
+            Vertex v;
+            v.pos = pos;
+            out->vertices.push_back(v);
+            count.push_back(1);
+        }
+        else
+        {
+            out->vertices[res.first->second].pos += pos;
+            ++count[res.first->second];
+        }
+        remap[i] = res.first->second;
+    }
+    for(size_t i=0; i<out->vertices.size(); ++i)
+        out->vertices[i].pos /= (GLfloat)count[i];
+    
+    //Keep faces spanning three different cells
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        Face f;
+        for(unsigned short h=0; h<3; ++h)
+            f.vertexID[h] = remap[mesh->faces[i].vertexID[h]];
+        if(f.vertexID[0] == f.vertexID[1] || f.vertexID[1] == f.vertexID[2] || f.vertexID[2] == f.vertexID[0])
+            continue;
+        out->faces.push_back(f);
+    }
+    return out;
+}
+
+static bool IsClosedManifold(const Mesh* mesh)
+{
+    //Every directed edge has to be used exactly once and its twin has to exist
+    std::unordered_map<uint64_t, unsigned int> edges;
+    edges.reserve(mesh->faces.size() * 3);
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+        for(unsigned short h=0; h<3; ++h)
+        {
+            uint64_t key = ((uint64_t)mesh->faces[i].vertexID[h] << 32) | (uint64_t)mesh->faces[i].vertexID[(h+1)%3];
+            if(++edges[key] > 1)
+                return false;
+        }
+    for(auto it=edges.begin(); it!=edges.end(); ++it)
+    {
+        uint64_t twin = (it->first << 32) | (it->first >> 32);
+        if(edges.find(twin) == edges.end())
+            return false;
+    }
+    return true;
+}
+
+Mesh* DecimateMesh(const Mesh* mesh, size_t maxFaces)
+{
+    if(mesh == nullptr || mesh->faces.size() == 0 || maxFaces < 4)
+        return nullptr;
+
+    glm::vec3 min(BT_LARGE_FLOAT);
+    glm::vec3 max(-BT_LARGE_FLOAT);
+    for(size_t i=0; i<mesh->getNumOfVertices(); ++i)
+    {
+        glm::vec3 pos = mesh->getVertexPos(i);
+        min = glm::min(min, pos);
+        max = glm::max(max, pos);
+    }
+    GLfloat extent = glm::max(max.x - min.x, glm::max(max.y - min.y, max.z - min.z));
+    if(extent <= 0.f)
+        return nullptr;
+
+    //Bisection on the cell size (the face count decreases with the cell size)
+    PlainMesh* best = nullptr;
+    GLfloat lo = extent/1e6f;
+    GLfloat hi = extent;
+    for(unsigned int i=0; i<24; ++i)
+    {
+        GLfloat cellSize = (lo + hi)/2.f;
+        PlainMesh* candidate = ClusterVertices(mesh, min, cellSize);
+        
+        if(candidate->faces.size() > maxFaces)
+        {
+            lo = cellSize;
+            delete candidate;
+        }
+        else
+        {
+            hi = cellSize;
+            if(candidate->faces.size() >= 4 && (best == nullptr || candidate->faces.size() > best->faces.size())
+               && IsClosedManifold(candidate))
+            {
+                if(best != nullptr) 
+                    delete best;
+                best = candidate;
+            }
+            else
+                delete candidate;
+        }
+        
+        if(best != nullptr && best->faces.size() == maxFaces)
+            break;
+    }
+    
+    if(best == nullptr)
+        return nullptr;
+
+    //Vertex normals
+    for(size_t i=0; i<best->faces.size(); ++i)
+    {
+        glm::vec3 v12 = best->getVertexPos(i, 1) - best->getVertexPos(i, 0);
+        glm::vec3 v13 = best->getVertexPos(i, 2) - best->getVertexPos(i, 0);
+        glm::vec3 n = glm::cross(v12, v13);
+        for(unsigned short h=0; h<3; ++h)
+            best->vertices[best->faces[i].vertexID[h]].normal += n;
+    }
+    for(size_t i=0; i<best->vertices.size(); ++i)
+        if(glm::length(best->vertices[i].normal) > 0.f)
+            best->vertices[i].normal = glm::normalize(best->vertices[i].normal);
+    
+    return best;
+}
+
 bool IsDiagonal(const Matrix3& A)
 {
     Scalar minDiagElem = btMin( btMin( btFabs(A.getRow(0).getX()), btFabs(A.getRow(1).getY())), btFabs(A.getRow(2).getZ()) );
@@ -0,0 +1,86 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ImageCache.cpp
+//  Stonefish
+//
+
+#include "utils/ImageCache.h"
+
+#include <SDL2/SDL_atomic.h>
+#include "stb_image.h"
+
+namespace sf
+{
+
+static SDL_SpinLock imagesLock = 0;
+std::map<ImageCache::ImageKey, ImageCache::Image> ImageCache::images;
+
+bool ImageCache::Prefetch(const std::string& path, int channels, bool wide)
+{
+    Image img;
+    if(wide)
+        img.data = stbi_load_16(path.c_str(), &img.width, &img.height, &img.channels, channels);
+    else
+        img.data = stbi_load(path.c_str(), &img.width, &img.height, &img.channels, channels);
+    if(img.data == NULL)
+        return false;
+
+    SDL_AtomicLock(&imagesLock);
+    bool inserted = images.emplace(ImageKey(path, channels, wide), img).second;
+    SDL_AtomicUnlock(&imagesLock);
+    
+    if(!inserted) //Already prefetched
+        stbi_image_free(img.data);
+    return true;
+}
+
+void* ImageCache::Take(const std::string& path, int channels, bool wide, int& width, int& height, int& fileChannels)
+{
+    SDL_AtomicLock(&imagesLock);
+    auto it = images.find(ImageKey(path, channels, wide));
+    if(it == images.end())
+    {
+        SDL_AtomicUnlock(&imagesLock);
+        return nullptr;
+    }
+    Image img = it->second;
+    images.erase(it);
+    SDL_AtomicUnlock(&imagesLock);
+    
+    width = img.width;
+    height = img.height;
+    fileChannels = img.channels;
+    return img.data;
+}
+
+bool ImageCache::Is16Bit(const std::string& path)
+{
+    return stbi_is_16_bit(path.c_str()) != 0;
+}
+
+void ImageCache::Clear()
+{
+    SDL_AtomicLock(&imagesLock);
+    for(auto it = images.begin(); it != images.end(); ++it)
+        stbi_image_free(it->second.data);
+    images.clear();
+    SDL_AtomicUnlock(&imagesLock);
+}
+
+}
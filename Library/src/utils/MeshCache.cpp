@@ -0,0 +1,168 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshCache.cpp
+//  Stonefish
+//
+
+#include "utils/MeshCache.h"
+
+#include <SDL2/SDL_atomic.h>
+#include "core/SimulationApp.h"
+#include "graphics/OpenGLContent.h"
+
+namespace sf
+{
+
+static SDL_SpinLock cacheLock = 0;
+std::map<MeshCache::MeshKey, std::shared_ptr<const Mesh>> MeshCache::meshes;
+std::map<MeshCache::PropertiesKey, std::pair<std::shared_ptr<const Mesh>, MeshProperties>> MeshCache::properties;
+std::map<MeshCache::HullKey, std::pair<std::shared_ptr<const Mesh>, std::vector<Vector3>>> MeshCache::hulls;
+std::map<const Mesh*, MeshProperties> MeshCache::unitProperties;
+
+std::shared_ptr<const Mesh> MeshCache::Get(const std::string& path, GLfloat scale, bool smooth, GLfloat refine)
+{
+    MeshKey key(path, scale, smooth, refine);
+    
+    SDL_AtomicLock(&cacheLock);
+    auto it = meshes.find(key);
+    if(it != meshes.end())
+    {
+        std::shared_ptr<const Mesh> mesh = it->second;
+        SDL_AtomicUnlock(&cacheLock);
+        return mesh;
+    }
+    SDL_AtomicUnlock(&cacheLock);
+    
+    //Load and process outside of the lock (the first inserted copy wins)
+    Mesh* mesh = nullptr;
+    MeshProperties unitProps;
+    
+    if(!smooth) //Try the preprocessed geometry first
+        mesh = LoadSFM(GetPreprocessedGeometryPath(path), scale, refine, path, &unitProps);
+    bool preprocessed = mesh != nullptr;
+    
+    if(!preprocessed)
+    {
+        mesh = LoadGeometryFromFile(path, scale);
+        if(mesh == nullptr)
+            return nullptr;
+        OpenGLContent::CheckAndRepairFaceVertexOrder(mesh);
+        if(smooth)
+            OpenGLContent::SmoothNormals(mesh);
+        if(mesh->isTexturable())
+            OpenGLContent::ComputeTangents((TexturableMesh*)mesh);
+        if(refine > 0.f)
+            OpenGLContent::Refine(mesh, refine);
+    }
+    
+    std::shared_ptr<const Mesh> shared(mesh);
+    SDL_AtomicLock(&cacheLock);
+    auto res = meshes.emplace(key, shared);
+    if(res.second && preprocessed)
+        unitProperties.emplace(mesh, unitProps);
+    shared = res.first->second;
+    SDL_AtomicUnlock(&cacheLock);
+    return shared;
+}
+
+MeshProperties MeshCache::GetPhysicalProperties(const std::shared_ptr<const Mesh>& mesh, Scalar thickness, Scalar density)
+{
+    PropertiesKey key(mesh.get(), thickness, density);
+    
+    SDL_AtomicLock(&cacheLock);
+    auto it = properties.find(key);
+    if(it != properties.end())
+    {
+        MeshProperties mp = it->second.second;
+        SDL_AtomicUnlock(&cacheLock);
+        return mp;
+    }
+    
+    //Solid properties stored in the preprocessed geometry file scale with density
+    MeshProperties mp;
+    auto uit = thickness == Scalar(0) ? unitProperties.find(mesh.get()) : unitProperties.end();
+    bool precomputed = uit != unitProperties.end();
+    if(precomputed)
+    {
+        mp = uit->second;
+        mp.mass = mp.volume * density;
+        mp.Ipri *= density;
+    }
+    SDL_AtomicUnlock(&cacheLock);
+    
+    if(!precomputed)
+        mp = ComputePhysicalProperties(mesh.get(), thickness, density);
+    
+    SDL_AtomicLock(&cacheLock);
+    properties.emplace(key, std::make_pair(mesh, mp));
+    SDL_AtomicUnlock(&cacheLock);
+    return mp;
+}
+
+std::vector<Vector3> MeshCache::GetConvexHull(const std::shared_ptr<const Mesh>& mesh, unsigned int maxVertices, Scalar tolerance)
+{
+    HullKey key(mesh.get(), maxVertices, tolerance);
+    
+    SDL_AtomicLock(&cacheLock);
+    auto it = hulls.find(key);
+    if(it != hulls.end())
+    {
+        std::vector<Vector3> hull = it->second.second;
+        SDL_AtomicUnlock(&cacheLock);
+        return hull;
+    }
+    SDL_AtomicUnlock(&cacheLock);
+    
+    std::vector<Vector3> hull = ComputeConvexHull(mesh.get(), maxVertices, tolerance);
+    
+    SDL_AtomicLock(&cacheLock);
+    hulls.emplace(key, std::make_pair(mesh, hull));
+    SDL_AtomicUnlock(&cacheLock);
+    return hull;
+}
+
+Mesh* MeshCache::Copy(const Mesh* mesh)
+{
+    if(mesh == nullptr)
+        return nullptr;
+    else if(mesh->isTexturable())
+        return new TexturableMesh(*static_cast<const TexturableMesh*>(mesh));
+    else
+        return new PlainMesh(*static_cast<const PlainMesh*>(mesh));
+}
+
+size_t MeshCache::getNumOfMeshes()
+{
+    SDL_AtomicLock(&cacheLock);
+    size_t n = meshes.size();
+    SDL_AtomicUnlock(&cacheLock);
+    return n;
+}
+
+void MeshCache::Clear()
+{
+    SDL_AtomicLock(&cacheLock);
+    properties.clear();
+    hulls.clear();
+    unitProperties.clear();
+    meshes.clear();
+    SDL_AtomicUnlock(&cacheLock);
+}
+
+}
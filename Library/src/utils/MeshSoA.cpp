@@ -0,0 +1,345 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshSoA.cpp
+//  Stonefish
+//
+
+#include "utils/MeshSoA.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sf
+{
+
+MeshSoA::MeshSoA(const Mesh* mesh)
+{
+    nVertices = mesh->getNumOfVertices();
+    size_t padded = ((nVertices + 7)/8) * 8;
+    x.resize(padded, 0.f);
+    y.resize(padded, 0.f);
+    z.resize(padded, 0.f);
+    
+    for(size_t i=0; i<nVertices; ++i)
+    {
+        glm::vec3 pos = mesh->getVertexPos(i);
+        x[i] = pos.x;
+        y[i] = pos.y;
+        z[i] = pos.z;
+    }
+    
+    faces.resize(mesh->faces.size() * 3);
+    for(size_t i=0; i<mesh->faces.size(); ++i)
+    {
+        faces[i*3]   = mesh->faces[i].vertexID[0];
+        faces[i*3+1] = mesh->faces[i].vertexID[1];
+        faces[i*3+2] = mesh->faces[i].vertexID[2];
+    }
+    
+    //Face data in the mesh frame (degenerate faces have zero area)
+    size_t nFaces = mesh->faces.size();
+    size_t paddedFaces = ((nFaces + 7)/8) * 8;
+    cx.resize(paddedFaces, 0.f);
+    cy.resize(paddedFaces, 0.f);
+    cz.resize(paddedFaces, 0.f);
+    nx.resize(paddedFaces, 0.f);
+    ny.resize(paddedFaces, 0.f);
+    nz.resize(paddedFaces, 0.f);
+    area.resize(paddedFaces, 0.f);
+    
+    for(size_t i=0; i<nFaces; ++i)
+    {
+        glm::vec3 p1 = mesh->getVertexPos(i, 0);
+        glm::vec3 p2 = mesh->getVertexPos(i, 1);
+        glm::vec3 p3 = mesh->getVertexPos(i, 2);
+        glm::vec3 c = (p1+p2+p3)/3.f;
+        cx[i] = c.x;
+        cy[i] = c.y;
+        cz[i] = c.z;
+        
+        glm::vec3 fn = glm::cross(p2-p1, p3-p1);
+        GLfloat len = glm::dot(fn, fn);
+        if(len < 1e-12f) 
+            continue;
+        len = glm::sqrt(len);
+        fn /= len;
+        nx[i] = fn.x;
+        ny[i] = fn.y;
+        nz[i] = fn.z;
+        area[i] = len/2.f;
+    }
+}
+
+size_t MeshSoA::getNumOfVertices() const
+{
+    return nVertices;
+}
+
+size_t MeshSoA::getNumOfFaces() const
+{
+    return faces.size()/3;
+}
+
+size_t MeshSoA::getPaddedSize() const
+{
+    return x.size();
+}
+
+size_t MeshSoA::getPaddedFacesSize() const
+{
+    return area.size();
+}
+
+void MeshSoA::Transform(const glm::mat4& T, GLfloat* tx, GLfloat* ty, GLfloat* tz) const
+{
+    const size_t n = x.size();
+    const GLfloat* px = x.data();
+    const GLfloat* py = y.data();
+    const GLfloat* pz = z.data();
+    size_t i = 0;
+    
+#if defined(__AVX__)
+    const __m256 m00 = _mm256_set1_ps(T[0][0]), m01 = _mm256_set1_ps(T[0][1]), m02 = _mm256_set1_ps(T[0][2]);
+    const __m256 m10 = _mm256_set1_ps(T[1][0]), m11 = _mm256_set1_ps(T[1][1]), m12 = _mm256_set1_ps(T[1][2]);
+    const __m256 m20 = _mm256_set1_ps(T[2][0]), m21 = _mm256_set1_ps(T[2][1]), m22 = _mm256_set1_ps(T[2][2]);
+    const __m256 m30 = _mm256_set1_ps(T[3][0]), m31 = _mm256_set1_ps(T[3][1]), m32 = _mm256_set1_ps(T[3][2]);
+    
+    for(; i + 8 <= n; i += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(px + i);
+        __m256 vy = _mm256_loadu_ps(py + i);
+        __m256 vz = _mm256_loadu_ps(pz + i);
+        _mm256_storeu_ps(tx + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m10, vy)), _mm256_add_ps(_mm256_mul_ps(m20, vz), m30)));
+        _mm256_storeu_ps(ty + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, vx), _mm256_mul_ps(m11, vy)), _mm256_add_ps(_mm256_mul_ps(m21, vz), m31)));
+        _mm256_storeu_ps(tz + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, vx), _mm256_mul_ps(m12, vy)), _mm256_add_ps(_mm256_mul_ps(m22, vz), m32)));
+    }
+#elif defined(__SSE2__)
+    const __m128 m00 = _mm_set1_ps(T[0][0]), m01 = _mm_set1_ps(T[0][1]), m02 = _mm_set1_ps(T[0][2]);
+    const __m128 m10 = _mm_set1_ps(T[1][0]), m11 = _mm_set1_ps(T[1][1]), m12 = _mm_set1_ps(T[1][2]);
+    const __m128 m20 = _mm_set1_ps(T[2][0]), m21 = _mm_set1_ps(T[2][1]), m22 = _mm_set1_ps(T[2][2]);
+    const __m128 m30 = _mm_set1_ps(T[3][0]), m31 = _mm_set1_ps(T[3][1]), m32 = _mm_set1_ps(T[3][2]);
+    
+    for(; i + 4 <= n; i += 4)
+    {
+        __m128 vx = _mm_loadu_ps(px + i);
+        __m128 vy = _mm_loadu_ps(py + i);
+        __m128 vz = _mm_loadu_ps(pz + i);
+        _mm_storeu_ps(tx + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m10, vy)), _mm_add_ps(_mm_mul_ps(m20, vz), m30)));
+        _mm_storeu_ps(ty + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, vx), _mm_mul_ps(m11, vy)), _mm_add_ps(_mm_mul_ps(m21, vz), m31)));
+        _mm_storeu_ps(tz + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, vx), _mm_mul_ps(m12, vy)), _mm_add_ps(_mm_mul_ps(m22, vz), m32)));
+    }
+#endif
+    
+    //Scalar fallback (and remainder)
+    for(; i < n; ++i)
+    {
+        tx[i] = T[0][0] * px[i] + T[1][0] * py[i] + T[2][0] * pz[i] + T[3][0];
+        ty[i] = T[0][1] * px[i] + T[1][1] * py[i] + T[2][1] * pz[i] + T[3][1];
+        tz[i] = T[0][2] * px[i] + T[1][2] * py[i] + T[2][2] * pz[i] + T[3][2];
+    }
+}
+
+void MeshSoA::SubmergedDrag(const glm::vec3& u, const glm::vec3& omega, const GLfloat* ux, const GLfloat* uy, const GLfloat* uz,
+                            glm::vec3& Fq, glm::vec3& Tq, glm::vec3& Ff, glm::vec3& Tf) const
+{
+    const size_t n = area.size();
+    Fq = Tq = Ff = Tf = glm::vec3(0.f);
+    size_t i = 0;
+    
+#if defined(__AVX__)
+    const __m256 ax = _mm256_set1_ps(u.x), ay = _mm256_set1_ps(u.y), az = _mm256_set1_ps(u.z);
+    const __m256 wx = _mm256_set1_ps(omega.x), wy = _mm256_set1_ps(omega.y), wz = _mm256_set1_ps(omega.z);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 minVn = _mm256_set1_ps(-1e-12f);
+    const __m256 minVt2 = _mm256_set1_ps(1e-9f);
+    __m256 fqx = zero, fqy = zero, fqz = zero, tqx = zero, tqy = zero, tqz = zero;
+    __m256 ffx = zero, ffy = zero, ffz = zero, tfx = zero, tfy = zero, tfz = zero;
+    
+    for(; i + 8 <= n; i += 8)
+    {
+        __m256 pcx = _mm256_loadu_ps(&cx[i]);
+        __m256 pcy = _mm256_loadu_ps(&cy[i]);
+        __m256 pcz = _mm256_loadu_ps(&cz[i]);
+        __m256 pnx = _mm256_loadu_ps(&nx[i]);
+        __m256 pny = _mm256_loadu_ps(&ny[i]);
+        __m256 pnz = _mm256_loadu_ps(&nz[i]);
+        __m256 A = _mm256_loadu_ps(&area[i]);
+        
+        //Relative fluid velocity at the centroid
+        __m256 vx = _mm256_sub_ps(ax, _mm256_sub_ps(_mm256_mul_ps(wy, pcz), _mm256_mul_ps(wz, pcy)));
+        __m256 vy = _mm256_sub_ps(ay, _mm256_sub_ps(_mm256_mul_ps(wz, pcx), _mm256_mul_ps(wx, pcz)));
+        __m256 vz = _mm256_sub_ps(az, _mm256_sub_ps(_mm256_mul_ps(wx, pcy), _mm256_mul_ps(wy, pcx)));
+        if(ux != nullptr)
+        {
+            vx = _mm256_add_ps(vx, _mm256_loadu_ps(ux + i));
+            vy = _mm256_add_ps(vy, _mm256_loadu_ps(uy + i));
+            vz = _mm256_add_ps(vz, _mm256_loadu_ps(uz + i));
+        }
+        __m256 vn = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, pnx), _mm256_mul_ps(vy, pny)), _mm256_mul_ps(vz, pnz));
+        
+        //Quadratic drag (fluid approaching the face)
+        __m256 mag = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+        __m256 s = _mm256_mul_ps(_mm256_mul_ps(mag, _mm256_sub_ps(zero, vn)), A);
+        s = _mm256_and_ps(_mm256_cmp_ps(vn, minVn, _CMP_LT_OQ), s);
+        __m256 qx = _mm256_mul_ps(vx, s);
+        __m256 qy = _mm256_mul_ps(vy, s);
+        __m256 qz = _mm256_mul_ps(vz, s);
+        fqx = _mm256_add_ps(fqx, qx);
+        fqy = _mm256_add_ps(fqy, qy);
+        fqz = _mm256_add_ps(fqz, qz);
+        tqx = _mm256_add_ps(tqx, _mm256_sub_ps(_mm256_mul_ps(pcy, qz), _mm256_mul_ps(pcz, qy)));
+        tqy = _mm256_add_ps(tqy, _mm256_sub_ps(_mm256_mul_ps(pcz, qx), _mm256_mul_ps(pcx, qz)));
+        tqz = _mm256_add_ps(tqz, _mm256_sub_ps(_mm256_mul_ps(pcx, qy), _mm256_mul_ps(pcy, qx)));
+        
+        //Skin friction (tangent velocity)
+        __m256 vtx = _mm256_sub_ps(vx, _mm256_mul_ps(vn, pnx));
+        __m256 vty = _mm256_sub_ps(vy, _mm256_mul_ps(vn, pny));
+        __m256 vtz = _mm256_sub_ps(vz, _mm256_mul_ps(vn, pnz));
+        __m256 vt2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vtx, vtx), _mm256_mul_ps(vty, vty)), _mm256_mul_ps(vtz, vtz));
+        __m256 k = _mm256_and_ps(_mm256_cmp_ps(vt2, minVt2, _CMP_GT_OQ), A);
+        __m256 sx = _mm256_mul_ps(vtx, k);
+        __m256 sy = _mm256_mul_ps(vty, k);
+        __m256 sz = _mm256_mul_ps(vtz, k);
+        ffx = _mm256_add_ps(ffx, sx);
+        ffy = _mm256_add_ps(ffy, sy);
+        ffz = _mm256_add_ps(ffz, sz);
+        tfx = _mm256_add_ps(tfx, _mm256_sub_ps(_mm256_mul_ps(pcy, sz), _mm256_mul_ps(pcz, sy)));
+        tfy = _mm256_add_ps(tfy, _mm256_sub_ps(_mm256_mul_ps(pcz, sx), _mm256_mul_ps(pcx, sz)));
+        tfz = _mm256_add_ps(tfz, _mm256_sub_ps(_mm256_mul_ps(pcx, sy), _mm256_mul_ps(pcy, sx)));
+    }
+    
+    alignas(32) GLfloat lanes[12][8];
+    _mm256_store_ps(lanes[0], fqx); _mm256_store_ps(lanes[1], fqy); _mm256_store_ps(lanes[2], fqz);
+    _mm256_store_ps(lanes[3], tqx); _mm256_store_ps(lanes[4], tqy); _mm256_store_ps(lanes[5], tqz);
+    _mm256_store_ps(lanes[6], ffx); _mm256_store_ps(lanes[7], ffy); _mm256_store_ps(lanes[8], ffz);
+    _mm256_store_ps(lanes[9], tfx); _mm256_store_ps(lanes[10], tfy); _mm256_store_ps(lanes[11], tfz);
+    for(unsigned int h=0; h<8; ++h)
+    {
+        Fq += glm::vec3(lanes[0][h], lanes[1][h], lanes[2][h]);
+        Tq += glm::vec3(lanes[3][h], lanes[4][h], lanes[5][h]);
+        Ff += glm::vec3(lanes[6][h], lanes[7][h], lanes[8][h]);
+        Tf += glm::vec3(lanes[9][h], lanes[10][h], lanes[11][h]);
+    }
+#elif defined(__SSE2__)
+    const __m128 ax = _mm_set1_ps(u.x), ay = _mm_set1_ps(u.y), az = _mm_set1_ps(u.z);
+    const __m128 wx = _mm_set1_ps(omega.x), wy = _mm_set1_ps(omega.y), wz = _mm_set1_ps(omega.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 minVn = _mm_set1_ps(-1e-12f);
+    const __m128 minVt2 = _mm_set1_ps(1e-9f);
+    __m128 fqx = zero, fqy = zero, fqz = zero, tqx = zero, tqy = zero, tqz = zero;
+    __m128 ffx = zero, ffy = zero, ffz = zero, tfx = zero, tfy = zero, tfz = zero;
+    
+    for(; i + 4 <= n; i += 4)
+    {
+        __m128 pcx = _mm_loadu_ps(&cx[i]);
+        __m128 pcy = _mm_loadu_ps(&cy[i]);
+        __m128 pcz = _mm_loadu_ps(&cz[i]);
+        __m128 pnx = _mm_loadu_ps(&nx[i]);
+        __m128 pny = _mm_loadu_ps(&ny[i]);
+        __m128 pnz = _mm_loadu_ps(&nz[i]);
+        __m128 A = _mm_loadu_ps(&area[i]);
+        
+        //Relative fluid velocity at the centroid
+        __m128 vx = _mm_sub_ps(ax, _mm_sub_ps(_mm_mul_ps(wy, pcz), _mm_mul_ps(wz, pcy)));
+        __m128 vy = _mm_sub_ps(ay, _mm_sub_ps(_mm_mul_ps(wz, pcx), _mm_mul_ps(wx, pcz)));
+        __m128 vz = _mm_sub_ps(az, _mm_sub_ps(_mm_mul_ps(wx, pcy), _mm_mul_ps(wy, pcx)));
+        if(ux != nullptr)
+        {
+            vx = _mm_add_ps(vx, _mm_loadu_ps(ux + i));
+            vy = _mm_add_ps(vy, _mm_loadu_ps(uy + i));
+            vz = _mm_add_ps(vz, _mm_loadu_ps(uz + i));
+        }
+        __m128 vn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, pnx), _mm_mul_ps(vy, pny)), _mm_mul_ps(vz, pnz));
+        
+        //Quadratic drag (fluid approaching the face)
+        __m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        __m128 s = _mm_mul_ps(_mm_mul_ps(mag, _mm_sub_ps(zero, vn)), A);
+        s = _mm_and_ps(_mm_cmplt_ps(vn, minVn), s);
+        __m128 qx = _mm_mul_ps(vx, s);
+        __m128 qy = _mm_mul_ps(vy, s);
+        __m128 qz = _mm_mul_ps(vz, s);
+        fqx = _mm_add_ps(fqx, qx);
+        fqy = _mm_add_ps(fqy, qy);
+        fqz = _mm_add_ps(fqz, qz);
+        tqx = _mm_add_ps(tqx, _mm_sub_ps(_mm_mul_ps(pcy, qz), _mm_mul_ps(pcz, qy)));
+        tqy = _mm_add_ps(tqy, _mm_sub_ps(_mm_mul_ps(pcz, qx), _mm_mul_ps(pcx, qz)));
+        tqz = _mm_add_ps(tqz, _mm_sub_ps(_mm_mul_ps(pcx, qy), _mm_mul_ps(pcy, qx)));
+        
+        //Skin friction (tangent velocity)
+        __m128 vtx = _mm_sub_ps(vx, _mm_mul_ps(vn, pnx));
+        __m128 vty = _mm_sub_ps(vy, _mm_mul_ps(vn, pny));
+        __m128 vtz = _mm_sub_ps(vz, _mm_mul_ps(vn, pnz));
+        __m128 vt2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vtx, vtx), _mm_mul_ps(vty, vty)), _mm_mul_ps(vtz, vtz));
+        __m128 k = _mm_and_ps(_mm_cmpgt_ps(vt2, minVt2), A);
+        __m128 sx = _mm_mul_ps(vtx, k);
+        __m128 sy = _mm_mul_ps(vty, k);
+        __m128 sz = _mm_mul_ps(vtz, k);
+        ffx = _mm_add_ps(ffx, sx);
+        ffy = _mm_add_ps(ffy, sy);
+        ffz = _mm_add_ps(ffz, sz);
+        tfx = _mm_add_ps(tfx, _mm_sub_ps(_mm_mul_ps(pcy, sz), _mm_mul_ps(pcz, sy)));
+        tfy = _mm_add_ps(tfy, _mm_sub_ps(_mm_mul_ps(pcz, sx), _mm_mul_ps(pcx, sz)));
+        tfz = _mm_add_ps(tfz, _mm_sub_ps(_mm_mul_ps(pcx, sy), _mm_mul_ps(pcy, sx)));
+    }
+    
+    alignas(16) GLfloat lanes[12][4];
+    _mm_store_ps(lanes[0], fqx); _mm_store_ps(lanes[1], fqy); _mm_store_ps(lanes[2], fqz);
+    _mm_store_ps(lanes[3], tqx); _mm_store_ps(lanes[4], tqy); _mm_store_ps(lanes[5], tqz);
+    _mm_store_ps(lanes[6], ffx); _mm_store_ps(lanes[7], ffy); _mm_store_ps(lanes[8], ffz);
+    _mm_store_ps(lanes[9], tfx); _mm_store_ps(lanes[10], tfy); _mm_store_ps(lanes[11], tfz);
+    for(unsigned int h=0; h<4; ++h)
+    {
+        Fq += glm::vec3(lanes[0][h], lanes[1][h], lanes[2][h]);
+        Tq += glm::vec3(lanes[3][h], lanes[4][h], lanes[5][h]);
+        Ff += glm::vec3(lanes[6][h], lanes[7][h], lanes[8][h]);
+        Tf += glm::vec3(lanes[9][h], lanes[10][h], lanes[11][h]);
+    }
+#endif
+
+    //Scalar fallback (and remainder)
+    for(; i < n; ++i)
+    {
+        glm::vec3 c(cx[i], cy[i], cz[i]);
+        glm::vec3 fn(nx[i], ny[i], nz[i]);
+        glm::vec3 vc = u - glm::cross(omega, c);
+        if(ux != nullptr)
+            vc += glm::vec3(ux[i], uy[i], uz[i]);
+        GLfloat vc_n = glm::dot(vc, fn);
+        
+        if(vc_n < -1e-12f) //If liquid is approaching the surface
+        {
+            glm::vec3 quadratic = vc * glm::length(vc) * -vc_n * area[i];
+            Fq += quadratic;
+            Tq += glm::cross(c, quadratic);
+        }
+        
+        glm::vec3 vt = vc - vc_n * fn;
+        if(glm::dot(vt, vt) > 1e-9f)
+        {
+            glm::vec3 skin = vt * area[i];
+            Ff += skin;
+            Tf += glm::cross(c, skin);
+        }
+    }
+}
+
+}
@@ -0,0 +1,242 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  Profiler.cpp
+//  Stonefish
+//
+
+#include "utils/Profiler.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include "LinearMath/btQuickprof.h"
+
+namespace sf
+{
+
+//Slot of the ring buffer, guarded by a sequence number (seqlock), so that it can be read while being written
+struct ProfilerSlot
+{
+    std::atomic<uint64_t> seq; //Index of the event + 1 when complete, 0 when being written
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> duration;
+    std::atomic<uint32_t> depth;
+
+    ProfilerSlot() : seq(0), name(nullptr), start(0), duration(0), depth(0) {}
+};
+
+//Ring buffer of zones recorded by a single thread (single producer, lock-free)
+struct Profiler::ThreadBuffer
+{
+    static constexpr uint64_t capacity = 1 << 15; //Has to be a power of 2
+    static constexpr uint32_t maxDepth = 64;
+
+    ThreadBuffer(uint32_t id) : index(id), slots(new ProfilerSlot[capacity]), head(0), tail(0), depth(0) {}
+
+    uint32_t index;
+    std::unique_ptr<ProfilerSlot[]> slots;
+    std::atomic<uint64_t> head; //Written only by the owning thread
+    std::atomic<uint64_t> tail; //Moved forward when the buffer is cleared
+    uint32_t depth;
+    const char* openName[maxDepth];
+    uint64_t openStart[maxDepth];
+};
+
+//Releases the buffer of a thread when the thread exits
+struct Profiler::ThreadBufferOwner
+{
+    ThreadBuffer* tb = nullptr;
+    ~ThreadBufferOwner() { if(tb != nullptr) Profiler::ReleaseThreadBuffer(tb); }
+};
+
+static SDL_SpinLock buffersLock = 0;
+static btEnterProfileZoneFunc* prevEnterZoneFunc = nullptr;
+static btLeaveProfileZoneFunc* prevLeaveZoneFunc = nullptr;
+std::atomic<bool> Profiler::enabled(false);
+std::atomic<uint32_t> Profiler::threadCount(0);
+std::vector<Profiler::ThreadBuffer*> Profiler::buffers;
+
+static inline uint64_t ProfilerNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::setEnabled(bool en)
+{
+    SDL_AtomicLock(&buffersLock);
+    bool hooked = btGetCurrentEnterProfileZoneFunc() == Profiler::BeginZone;
+    if(en && !hooked)
+    {
+        //Capture internal zones of Bullet Physics
+        prevEnterZoneFunc = btGetCurrentEnterProfileZoneFunc();
+        prevLeaveZoneFunc = btGetCurrentLeaveProfileZoneFunc();
+        btSetCustomEnterProfileZoneFunc(Profiler::BeginZone);
+        btSetCustomLeaveProfileZoneFunc(Profiler::EndZone);
+    }
+    else if(!en && hooked)
+    {
+        btSetCustomEnterProfileZoneFunc(prevEnterZoneFunc);
+        btSetCustomLeaveProfileZoneFunc(prevLeaveZoneFunc);
+    }
+    enabled.store(en, std::memory_order_relaxed);
+    SDL_AtomicUnlock(&buffersLock);
+}
+
+bool Profiler::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+Profiler::ThreadBuffer* Profiler::getThreadBuffer(bool create)
+{
+    static thread_local ThreadBufferOwner owner;
+    if(owner.tb == nullptr && create)
+    {
+        owner.tb = new ThreadBuffer(threadCount.fetch_add(1, std::memory_order_relaxed));
+        SDL_AtomicLock(&buffersLock);
+        buffers.push_back(owner.tb);
+        SDL_AtomicUnlock(&buffersLock);
+    }
+    return owner.tb;
+}
+
+void Profiler::ReleaseThreadBuffer(ThreadBuffer* tb)
+{
+    SDL_AtomicLock(&buffersLock);
+    buffers.erase(std::remove(buffers.begin(), buffers.end(), tb), buffers.end());
+    SDL_AtomicUnlock(&buffersLock);
+    delete tb;
+}
+
+void Profiler::BeginZone(const char* name)
+{
+    bool record = enabled.load(std::memory_order_relaxed);
+    ThreadBuffer* tb = getThreadBuffer(record); //No allocation when not recording
+    if(tb == nullptr)
+        return;
+    
+    if(tb->depth < ThreadBuffer::maxDepth)
+    {
+        tb->openName[tb->depth] = name;
+        tb->openStart[tb->depth] = record ? ProfilerNow() : 0;
+    }
+    ++tb->depth;
+}
+
+void Profiler::EndZone()
+{
+    ThreadBuffer* tb = getThreadBuffer(false);
+    if(tb == nullptr || tb->depth == 0) //Not recording or unbalanced call
+        return;
+    
+    --tb->depth;
+    if(tb->depth >= ThreadBuffer::maxDepth || tb->openStart[tb->depth] == 0) //Too deep or not recorded
+        return;
+
+    uint64_t h = tb->head.load(std::memory_order_relaxed);
+    ProfilerSlot& slot = tb->slots[h & (ThreadBuffer::capacity - 1)];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(tb->openName[tb->depth], std::memory_order_relaxed);
+    slot.start.store(tb->openStart[tb->depth], std::memory_order_relaxed);
+    slot.duration.store(ProfilerNow() - tb->openStart[tb->depth], std::memory_order_relaxed);
+    slot.depth.store(tb->depth, std::memory_order_relaxed);
+    slot.seq.store(h + 1, std::memory_order_release);
+    tb->head.store(h + 1, std::memory_order_release);
+}
+
+std::vector<ProfilerEvent> Profiler::getEvents(uint64_t* lost)
+{
+    std::vector<ProfilerEvent> out;
+    uint64_t nLost = 0;
+    SDL_AtomicLock(&buffersLock);
+    for(size_t i=0; i<buffers.size(); ++i)
+    {
+        ThreadBuffer* tb = buffers[i];
+        uint64_t h = tb->head.load(std::memory_order_acquire);
+        uint64_t tail = tb->tail.load(std::memory_order_relaxed);
+        uint64_t from = std::max(tail, h > ThreadBuffer::capacity ? h - ThreadBuffer::capacity : 0);
+        nLost += from - tail; //Wrapped around before collection
+        for(uint64_t k=from; k<h; ++k)
+        {
+            //Copy the slot and check that it was not overwritten in the meantime
+            const ProfilerSlot& slot = tb->slots[k & (ThreadBuffer::capacity - 1)];
+            if(slot.seq.load(std::memory_order_acquire) != k + 1)
+            {
+                ++nLost;
+                continue;
+            }
+            ProfilerEvent e;
+            e.name = slot.name.load(std::memory_order_relaxed);
+            e.start = slot.start.load(std::memory_order_relaxed);
+            e.duration = slot.duration.load(std::memory_order_relaxed);
+            e.thread = tb->index;
+            e.depth = slot.depth.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.seq.load(std::memory_order_relaxed) == k + 1)
+                out.push_back(e);
+            else
+                ++nLost;
+        }
+    }
+    SDL_AtomicUnlock(&buffersLock);
+
+    if(lost != nullptr)
+        *lost = nLost;
+
+    std::sort(out.begin(), out.end(), [](const ProfilerEvent& a, const ProfilerEvent& b) { return a.start < b.start; });
+    return out;
+}
+
+void Profiler::Clear()
+{
+    SDL_AtomicLock(&buffersLock);
+    for(size_t i=0; i<buffers.size(); ++i)
+        buffers[i]->tail.store(buffers[i]->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    SDL_AtomicUnlock(&buffersLock);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == nullptr)
+        return false;
+
+    std::vector<ProfilerEvent> events = getEvents();
+    uint64_t t0 = events.size() > 0 ? events.front().start : 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for(size_t i=0; i<events.size(); ++i)
+    {
+        std::string name(events[i].name);
+        for(size_t k=0; k<name.size(); ++k)
+            if(name[k] == '"' || name[k] == '\\') name[k] = '\'';
+        
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"stonefish\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                i > 0 ? "," : "", name.c_str(), events[i].thread, (events[i].start - t0)/1000.0, events[i].duration/1000.0);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+}
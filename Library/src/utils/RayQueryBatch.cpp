@@ -0,0 +1,192 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  RayQueryBatch.cpp
+//  Stonefish
+//
+
+#include "utils/RayQueryBatch.h"
+
+#include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
+#include "BulletSoftBody/btSoftMultiBodyDynamicsWorld.h"
+#include "entities/Entity.h"
+
+namespace sf
+{
+
+//Broadphase leaf processing with closest hit culling
+struct RayQueryLeafCallback : public btDbvt::ICollide
+{
+    RayQueryLeafCallback(const btVector3& from, const btVector3& to, const btVector3& dirInv, const unsigned int* signs, btScalar lambdaMax, 
+                         btCollisionWorld::ClosestRayResultCallback& callback)
+        : from_(from), dirInv_(dirInv), signs_(signs), lambdaMax_(lambdaMax), callback_(callback)
+    {
+        fromTrans_.setIdentity();
+        fromTrans_.setOrigin(from);
+        toTrans_.setIdentity();
+        toTrans_.setOrigin(to);
+    }
+    
+    void Process(const btDbvtNode* leaf)
+    {
+        if(callback_.m_closestHitFraction == btScalar(0))
+            return;
+        
+        btBroadphaseProxy* proxy = (btBroadphaseProxy*)leaf->data;
+        btCollisionObject* co = (btCollisionObject*)proxy->m_clientObject;
+        if(!callback_.needsCollision(co->getBroadphaseHandle()))
+            return;
+        
+        //Skip objects located beyond the closest hit found so far
+        btVector3 bounds[2] = {proxy->m_aabbMin, proxy->m_aabbMax};
+        btScalar tmin = btScalar(1);
+        if(!btRayAabb2(from_, dirInv_, signs_, bounds, tmin, btScalar(0), lambdaMax_ * callback_.m_closestHitFraction))
+            return;
+        
+        btSoftMultiBodyDynamicsWorld::rayTestSingle(fromTrans_, toTrans_, co, co->getCollisionShape(), co->getWorldTransform(), callback_);
+    }
+    
+    btVector3 from_;
+    btVector3 dirInv_;
+    const unsigned int* signs_;
+    btScalar lambdaMax_;
+    btTransform fromTrans_;
+    btTransform toTrans_;
+    btCollisionWorld::ClosestRayResultCallback& callback_;
+};
+
+RayQueryBatch::RayQueryBatch()
+{
+}
+
+void RayQueryBatch::Clear()
+{
+    queries.clear();
+    results.clear();
+}
+
+size_t RayQueryBatch::Add(const Vector3& from, const Vector3& to)
+{
+    return Add(from, to, MASK_DYNAMIC, MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING);
+}
+
+size_t RayQueryBatch::Add(const Vector3& from, const Vector3& to, int group, int mask)
+{
+    RayQuery q;
+    q.from = from;
+    q.to = to;
+    q.group = group;
+    q.mask = mask;
+    queries.push_back(q);
+    return queries.size()-1;
+}
+
+void RayQueryBatch::Execute(btSoftMultiBodyDynamicsWorld* world)
+{
+    results.resize(queries.size());
+    int n = (int)queries.size();
+    
+    //The fallback to the ray test of the world is not thread-safe
+    bool parallel = dynamic_cast<btDbvtBroadphase*>(world->getBroadphase()) != nullptr && n >= 32;
+    
+    #pragma omp parallel for schedule(dynamic, 8) if(parallel)
+    for(int i=0; i<n; ++i)
+        Trace(world, queries[i], results[i]);
+}
+
+void RayQueryBatch::Trace(btSoftMultiBodyDynamicsWorld* world, const RayQuery& q, RayHit& hit)
+{
+    hit.fraction = Scalar(1);
+    hit.normal = V0();
+    hit.object = nullptr;
+    
+    Vector3 dir = q.to - q.from;
+    Scalar length = dir.length();
+    if(length < SIMD_EPSILON) //Degenerate ray
+        return;
+    
+    btCollisionWorld::ClosestRayResultCallback closest(q.from, q.to);
+    closest.m_collisionFilterGroup = q.group;
+    closest.m_collisionFilterMask = q.mask;
+    
+    btDbvtBroadphase* bp = dynamic_cast<btDbvtBroadphase*>(world->getBroadphase());
+    if(bp == nullptr)
+        world->rayTest(q.from, q.to, closest);
+    else
+    {
+        //Traverse the dynamic and static trees of the broadphase with a stack owned by the thread
+        static thread_local btAlignedObjectArray<const btDbvtNode*> stack;
+        dir /= length;
+        btVector3 dirInv;
+        unsigned int signs[3];
+        for(int k=0; k<3; ++k)
+        {
+            dirInv[k] = dir[k] == Scalar(0) ? Scalar(BT_LARGE_FLOAT) : Scalar(1)/dir[k];
+            signs[k] = dirInv[k] < Scalar(0);
+        }
+        RayQueryLeafCallback cb(q.from, q.to, dirInv, signs, length, closest);
+        for(int s=0; s<2; ++s)
+            bp->m_sets[s].rayTestInternal(bp->m_sets[s].m_root, q.from, q.to, dirInv, signs, length, V0(), V0(), stack, cb);
+    }
+    
+    if(closest.hasHit())
+    {
+        hit.fraction = closest.m_closestHitFraction;
+        hit.normal = closest.m_hitNormalWorld;
+        hit.object = closest.m_collisionObject;
+    }
+}
+
+const RayHit& RayQueryBatch::getResult(size_t id) const
+{
+    return results[id];
+}
+
+const Vector3& RayQueryBatch::getFrom(size_t id) const
+{
+    return queries[id].from;
+}
+
+const Vector3& RayQueryBatch::getTo(size_t id) const
+{
+    return queries[id].to;
+}
+
+Vector3 RayQueryBatch::getHitPoint(size_t id) const
+{
+    return queries[id].from.lerp(queries[id].to, results[id].fraction);
+}
+
+size_t RayQueryBatch::getSize() const
+{
+    return queries.size();
+}
+
+RayHit RayQueryBatch::Cast(btSoftMultiBodyDynamicsWorld* world, const Vector3& from, const Vector3& to)
+{
+    RayQuery q;
+    q.from = from;
+    q.to = to;
+    q.group = MASK_DYNAMIC;
+    q.mask = MASK_STATIC | MASK_DYNAMIC | MASK_ANIMATED_COLLIDING;
+    RayHit hit;
+    Trace(world, q, hit);
+    return hit;
+}
+
+}
@@ -0,0 +1,78 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  StepBatchTestApp.cpp
+//  Stonefish
+//
+
+#include "StepBatchTestApp.h"
+
+#include <cstdio>
+#include <cmath>
+#include <core/SimulationManager.h>
+
+StepBatchTestApp::StepBatchTestApp(std::string dataDirPath, StepBatchTestManager* sim) 
+    : ConsoleSimulationApp("Step Batch Test", dataDirPath, sim), passed(false)
+{
+}
+
+bool StepBatchTestApp::hasPassed() const
+{
+    return passed;
+}
+
+void StepBatchTestApp::LoopInternal()
+{
+    sf::Scalar fixedStep = sf::Scalar(1)/sf::Scalar(500);
+    passed = RunBatches(50, 10, fixedStep) //Step equal to the manager's step
+             && RunBatches(20, 8, sf::Scalar(5) * fixedStep) //Coarser step
+             && RunBatches(40, 7, sf::Scalar(0.0013)); //Step not being a multiple of the manager's step
+    Quit();
+}
+
+bool StepBatchTestApp::RunBatches(unsigned int batches, unsigned int n, sf::Scalar timeStep)
+{
+    StepBatchTestManager* sim = static_cast<StepBatchTestManager*>(getSimulationManager());
+    sim->RestartScenario();
+    timeStep_ = timeStep;
+    setStepBatch(n);
+    StartSimulation(); //No thread, autostep disabled
+    sim->setCallSimulationStepCompleted(false);
+    
+    for(unsigned int i=0; i<batches; ++i)
+        StepSimulation();
+    
+    StopSimulation();
+
+    sf::Scalar fixedStep = sf::Scalar(1)/sf::Scalar(500);
+    sf::Scalar expected = sf::Scalar(batches * n) * timeStep;
+    sf::Scalar simTime = sim->getSimulationTime();
+    sf::Scalar reported = sim->getReportedTime();
+    
+    //Simulation advances in whole fixed steps, the remainder is carried over to the next batch
+    sf::Scalar ticks = simTime/fixedStep;
+    bool ok = sim->getCompletedCalls() == batches
+              && std::fabs(ticks - std::round(ticks)) < sf::Scalar(1e-6)
+              && simTime <= expected + sf::Scalar(1e-9) 
+              && expected - simTime < fixedStep + sf::Scalar(1e-9)
+              && btFabs(reported - simTime) < sf::Scalar(1e-9);
+
+    printf("%s: %u batches x %u steps of %.4f s -> expected %.6f s, simulated %.6f s, reported %.6f s\n",
+           ok ? "PASSED" : "FAILED", batches, n, (double)timeStep, (double)expected, (double)simTime, (double)reported);
+    return ok;
+}
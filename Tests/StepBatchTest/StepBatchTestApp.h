@@ -0,0 +1,47 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  StepBatchTestApp.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__StepBatchTestApp__
+#define __Stonefish__StepBatchTestApp__
+
+#include <core/ConsoleSimulationApp.h>
+#include "StepBatchTestManager.h"
+
+//! An application checking the simulation time after batches of fixed steps.
+class StepBatchTestApp : public sf::ConsoleSimulationApp
+{
+public:
+    StepBatchTestApp(std::string dataDirPath, StepBatchTestManager* sim);
+
+    //! Returns true if all checks passed.
+    bool hasPassed() const;
+
+protected:
+    void LoopInternal();
+
+private:
+    bool RunBatches(unsigned int batches, unsigned int n, sf::Scalar timeStep);
+
+    bool passed;
+};
+
+#endif
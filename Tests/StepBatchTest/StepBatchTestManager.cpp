@@ -0,0 +1,65 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  StepBatchTestManager.cpp
+//  Stonefish
+//
+
+#include "StepBatchTestManager.h"
+
+#include <entities/statics/Plane.h>
+#include <entities/solids/Sphere.h>
+
+StepBatchTestManager::StepBatchTestManager(sf::Scalar stepsPerSecond) 
+    : SimulationManager(stepsPerSecond, sf::Solver::SI, sf::CollisionFilter::EXCLUSIVE), reportedTime(0), completedCalls(0)
+{
+}
+
+void StepBatchTestManager::BuildScenario()
+{
+    CreateMaterial("Steel", 7810.0, 0.5);
+    SetMaterialsInteraction("Steel", "Steel", 0.5, 0.3);
+    
+    sf::Plane* plane = new sf::Plane("Ground", 100.0, "Steel");
+    AddStaticEntity(plane, sf::I4());
+
+    sf::PhysicsSettings phy;
+    phy.mode = sf::PhysicsMode::SURFACE;
+    phy.collisions = true;
+    sf::Sphere* sph = new sf::Sphere("Sphere", phy, 0.1, sf::I4(), "Steel", "");
+    AddSolidEntity(sph, sf::Transform(sf::IQ(), sf::Vector3(0.0, 0.0, -1.0)));
+
+    reportedTime = sf::Scalar(0);
+    completedCalls = 0;
+}
+
+void StepBatchTestManager::SimulationStepCompleted(sf::Scalar timeStep)
+{
+    reportedTime += timeStep;
+    ++completedCalls;
+}
+
+sf::Scalar StepBatchTestManager::getReportedTime() const
+{
+    return reportedTime;
+}
+
+unsigned int StepBatchTestManager::getCompletedCalls() const
+{
+    return completedCalls;
+}
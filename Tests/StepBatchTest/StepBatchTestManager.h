@@ -0,0 +1,45 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  StepBatchTestManager.h
+//  Stonefish
+//
+
+#ifndef __Stonefish__StepBatchTestManager__
+#define __Stonefish__StepBatchTestManager__
+
+#include <core/SimulationManager.h>
+
+//! A minimal scenario used to check the time simulated by batched fixed steps.
+class StepBatchTestManager : public sf::SimulationManager
+{
+public:
+    StepBatchTestManager(sf::Scalar stepsPerSecond);
+    
+    void BuildScenario();
+    void SimulationStepCompleted(sf::Scalar timeStep);
+
+    sf::Scalar getReportedTime() const;
+    unsigned int getCompletedCalls() const;
+
+private:
+    sf::Scalar reportedTime;
+    unsigned int completedCalls;
+};
+
+#endif
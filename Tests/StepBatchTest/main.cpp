@@ -0,0 +1,33 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  main.cpp
+//  Stonefish
+//
+
+#include "StepBatchTestApp.h"
+#include "StepBatchTestManager.h"
+
+int main(int argc, const char * argv[])
+{
+    StepBatchTestManager* simulationManager = new StepBatchTestManager(500.0);
+    StepBatchTestApp app(std::string(DATA_DIR_PATH), simulationManager);
+    app.Run(false, false, 1.0/500.0);
+    
+    return app.hasPassed() ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  MeshConverter.cpp
+//  Stonefish
+//
+
+#include <core/ConsoleSimulationApp.h>
+#include <graphics/OpenGLContent.h>
+#include <utils/GeometryFileUtil.h>
+#include <utils/MeshCache.h>
+#include <cstring>
+#include <cstdlib>
+
+static void ScaleMesh(sf::Mesh* mesh, GLfloat scale)
+{
+    if(mesh->isTexturable())
+        for(sf::TexturableVertex& v : ((sf::TexturableMesh*)mesh)->vertices)
+            v.pos *= scale;
+    else
+        for(sf::Vertex& v : ((sf::PlainMesh*)mesh)->vertices)
+            v.pos *= scale;
+}
+
+static void PrintUsage(const char* name)
+{
+    printf("Usage: %s <input.obj|input.stl> [-o output.sfm] [-r threshold] [-s scale]\n", name);
+    printf("  -o  output file (default: input path with the .sfm extension)\n");
+    printf("  -r  refinement threshold of the physics mesh, 0 disables it (default 3)\n");
+    printf("  -s  scale of the geometry in the scenario, at which the physics mesh is refined (default 1)\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    if(argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string input(argv[1]);
+    std::string output = sf::GetPreprocessedGeometryPath(input);
+    GLfloat refine = 3.f; //The same as used by Polyhedron
+    GLfloat scale = 1.f;
+
+    for(int i=2; i<argc-1; i+=2)
+    {
+        if(strcmp(argv[i], "-o") == 0)
+            output = std::string(argv[i+1]);
+        else if(strcmp(argv[i], "-r") == 0)
+            refine = (GLfloat)atof(argv[i+1]);
+        else if(strcmp(argv[i], "-s") == 0)
+            scale = (GLfloat)atof(argv[i+1]);
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    //Console application needed for logging
+    sf::ConsoleSimulationApp app("MeshConverter", "", nullptr);
+    
+    //Process the mesh in the same way as MeshCache does
+    sf::Mesh* mesh = sf::LoadGeometryFromFile(input, 1.f);
+    if(mesh == nullptr)
+        return 1;
+    sf::OpenGLContent::CheckAndRepairFaceVertexOrder(mesh);
+    if(mesh->isTexturable())
+        sf::OpenGLContent::ComputeTangents((sf::TexturableMesh*)mesh);
+
+    std::vector<std::pair<GLfloat, const sf::Mesh*>> meshes;
+    meshes.push_back(std::make_pair(0.f, mesh));
+    sf::Mesh* refined = nullptr;
+    if(refine > 0.f && scale > 0.f)
+    {
+        //Refinement depends on the size of the faces, so it is done at the scale used in the scenario
+        refined = sf::MeshCache::Copy(mesh);
+        ScaleMesh(refined, scale);
+        sf::OpenGLContent::Refine(refined, refine);
+        ScaleMesh(refined, 1.f/scale);
+        meshes.push_back(std::make_pair(refine, refined));
+    }
+
+    bool ok = sf::SaveSFM(output, input, meshes, scale);
+    if(ok)
+        printf("Written %s (%lu vertices, %lu faces", output.c_str(), mesh->getNumOfVertices(), mesh->faces.size());
+    if(ok && refined != nullptr)
+        printf("; physics mesh %lu vertices, %lu faces", refined->getNumOfVertices(), refined->faces.size());
+    if(ok)
+        printf(")\n");
+
+    delete mesh;
+    if(refined != nullptr)
+        delete refined;
+    return ok ? 0 : 1;
+}
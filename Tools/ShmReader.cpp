@@ -0,0 +1,167 @@
+/*    
+    This file is a part of Stonefish.
+
+    Stonefish is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Stonefish is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+//
+//  ShmReader.cpp
+//  Stonefish
+//
+
+#include <core/SharedMemoryBridge.h>
+#include <sensors/Sensor.h>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+
+static void PrintUsage(const char* name)
+{
+    printf("Usage: %s <name> [-l] [-r rate] [-n count] [-s actuator value [value]]\n", name);
+    printf("  -l  list the sensors and actuators and exit\n");
+    printf("  -r  polling rate [Hz] (default 1000)\n");
+    printf("  -n  number of polls before exiting, 0 means infinite (default 0)\n");
+    printf("  -s  write a setpoint of an actuator, before polling\n");
+}
+
+int main(int argc, const char * argv[])
+{
+    if(argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    
+    bool list = false;
+    double rate = 1000.0;
+    unsigned long polls = 0;
+    std::string actuator;
+    std::vector<double> setpoint;
+    
+    for(int i=2; i<argc; ++i)
+    {
+        if(strcmp(argv[i], "-l") == 0)
+            list = true;
+        else if(strcmp(argv[i], "-r") == 0 && i+1 < argc)
+            rate = atof(argv[++i]);
+        else if(strcmp(argv[i], "-n") == 0 && i+1 < argc)
+            polls = strtoul(argv[++i], nullptr, 10);
+        else if(strcmp(argv[i], "-s") == 0 && i+2 < argc)
+        {
+            actuator = std::string(argv[++i]);
+            while(i+1 < argc && argv[i+1][0] != '-' && setpoint.size() < sf::SHM_MAX_SETPOINTS)
+                setpoint.push_back(atof(argv[++i]));
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    sf::SharedMemoryClient client;
+    if(!client.Open(argv[1]))
+    {
+        printf("Shared memory '/%s' not found or incompatible!\n", argv[1]);
+        return 1;
+    }
+    
+    const sf::ShmHeader* header = client.getHeader();
+    printf("Connected to '/%s': %u sensors, %u actuators, step %lu, time %1.3lf s\n", argv[1], header->nSensors, header->nActuators, 
+           (unsigned long)header->step.load(), header->time.load());
+    
+    if(list)
+    {
+        for(size_t i=0; i<header->nSensors; ++i)
+        {
+            const sf::ShmSensorInfo* info = client.getSensorInfo(i);
+            if(info->type == (uint32_t)sf::SensorType::VISION)
+                printf("Sensor %lu: %s (vision type %u, %ux%u)\n", i, info->name, info->subtype, info->width, info->height);
+            else
+                printf("Sensor %lu: %s (scalar type %u, %u channels)\n", i, info->name, info->subtype, info->channels);
+        }
+        for(size_t i=0; i<header->nActuators; ++i)
+        {
+            const sf::ShmActuatorInfo* info = client.getActuatorInfo(i);
+            printf("Actuator %lu: %s (type %u, %u values)\n", i, info->name, info->type, info->nValues);
+        }
+        return 0;
+    }
+    
+    if(!actuator.empty())
+    {
+        size_t i = 0;
+        for(; i<header->nActuators; ++i)
+            if(actuator == client.getActuatorInfo(i)->name)
+                break;
+        if(i == header->nActuators || !client.WriteSetpoint(i, setpoint.data(), setpoint.size()))
+        {
+            printf("Setpoint of actuator '%s' could not be written!\n", actuator.c_str());
+            return 1;
+        }
+    }
+    
+    //Poll the sensors and report the data rate
+    std::vector<uint64_t> lastSequence(header->nSensors, UINT64_MAX);
+    std::vector<unsigned long> received(header->nSensors, 0);
+    std::vector<uint8_t> data;
+    auto period = std::chrono::duration<double>(1.0/(rate > 0.0 ? rate : 1000.0));
+    auto start = std::chrono::steady_clock::now();
+    auto report = start;
+    
+    for(unsigned long n=0; polls == 0 || n < polls; ++n)
+    {
+        for(size_t i=0; i<header->nSensors; ++i)
+        {
+            uint64_t sequence;
+            double timestamp;
+            if(client.ReadSensor(i, data, sequence, timestamp) && sequence != lastSequence[i])
+            {
+                lastSequence[i] = sequence;
+                ++received[i];
+            }
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if(now - report >= std::chrono::seconds(1) || (polls > 0 && n+1 == polls))
+        {
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            printf("Step %lu, time %1.3lf s\n", (unsigned long)header->step.load(), header->time.load());
+            for(size_t i=0; i<header->nSensors; ++i)
+            {
+                const sf::ShmSensorInfo* info = client.getSensorInfo(i);
+                uint64_t sequence;
+                double timestamp;
+                if(!client.ReadSensor(i, data, sequence, timestamp))
+                {
+                    printf("  %s: no data\n", info->name);
+                    continue;
+                }
+                printf("  %s: #%lu at %1.3lf s, %1.1lf Hz", info->name, (unsigned long)sequence, timestamp, received[i]/elapsed);
+                if(info->type != (uint32_t)sf::SensorType::VISION)
+                {
+                    const sf::Scalar* values = (const sf::Scalar*)data.data();
+                    for(size_t c=0; c<data.size()/sizeof(sf::Scalar); ++c)
+                        printf(" %1.4lf", (double)values[c]);
+                }
+                printf("\n");
+            }
+            report = now;
+        }
+        std::this_thread::sleep_for(period);
+    }
+    
+    return 0;
+}